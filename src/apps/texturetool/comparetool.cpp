@@ -0,0 +1,217 @@
+#include "comparetool.h"
+#include "exception.h"
+#include "toolparser.h"
+
+#include <TextureLib/TextureComparison>
+#include <TextureLib/TextureIO>
+
+#include <QtCore/QDebug>
+
+#include <cmath>
+#include <limits>
+
+namespace TextureTool {
+
+namespace {
+
+constexpr gsl::span<const char> toolId = "compare";
+
+// Returned when the images are compared successfully but are below a threshold
+constexpr int thresholdExitCode = 2;
+
+struct Options
+{
+    QString lhsFile;
+    QString rhsFile;
+    QString diffFile;
+    double minPsnr {std::numeric_limits<double>::lowest()};
+    double minSsim {std::numeric_limits<double>::lowest()};
+};
+
+double parseThreshold(const QString &value, const QString &name)
+{
+    bool ok = false;
+    const auto result = value.toDouble(&ok);
+    if (!ok)
+        throw RuntimeError(CompareTool::tr("Invalid %1 value: %2").arg(name, value));
+    return result;
+}
+
+Options parseOptions(const QStringList &arguments)
+{
+    ToolParser parser({toolId.data(), int(toolId.size())});
+    QCommandLineOption diffOption(QStringLiteral("diff"),
+                                  CompareTool::tr("Write the difference of the first image to "
+                                                  "the file"),
+                                  QStringLiteral("file"));
+    QCommandLineOption minPsnrOption(QStringLiteral("min-psnr"),
+                                     CompareTool::tr("Fail if the PSNR of any image is lower "
+                                                     "than the value in dB"),
+                                     QStringLiteral("value"));
+    QCommandLineOption minSsimOption(QStringLiteral("min-ssim"),
+                                     CompareTool::tr("Fail if the SSIM of any image is lower "
+                                                     "than the value"),
+                                     QStringLiteral("value"));
+    parser.addOption(diffOption);
+    parser.addOption(minPsnrOption);
+    parser.addOption(minSsimOption);
+    parser.addPositionalArgument(QStringLiteral("lhs"),
+                                 CompareTool::tr("First filename"),
+                                 QStringLiteral("lhs"));
+    parser.addPositionalArgument(QStringLiteral("rhs"),
+                                 CompareTool::tr("Second filename"),
+                                 QStringLiteral("rhs"));
+
+    parser.process(arguments);
+
+    const auto positional = parser.positionalArguments();
+    if (positional.size() != 2) {
+        ToolParser::showError(CompareTool::tr("Incorrect input arguments"));
+        parser.showHelp(EXIT_FAILURE);
+    }
+
+    Options options;
+    options.lhsFile = positional.at(0);
+    options.rhsFile = positional.at(1);
+    options.diffFile = parser.value(diffOption);
+    if (parser.isSet(minPsnrOption))
+        options.minPsnr = parseThreshold(parser.value(minPsnrOption), QStringLiteral("min-psnr"));
+    if (parser.isSet(minSsimOption))
+        options.minSsim = parseThreshold(parser.value(minSsimOption), QStringLiteral("min-ssim"));
+    return options;
+}
+
+Texture readTexture(const QString &filePath)
+{
+    TextureIO io(filePath);
+    const auto result = io.read();
+    if (!result) {
+        throw RuntimeError(CompareTool::tr("Can't read image %1: %2").
+                           arg(filePath, toUserString(result.error())));
+    }
+    return *result;
+}
+
+QString metricsToText(const QString &name, const TextureComparison::Metrics &metrics)
+{
+    const auto psnr = std::isinf(metrics.psnr)
+            ? CompareTool::tr("inf")
+            : QString::number(metrics.psnr, 'f', 2);
+    return CompareTool::tr("  %1 mse %2 psnr %3 ssim %4 max %5").
+            arg(name, -6).
+            arg(metrics.mse, 0, 'g', 4).
+            arg(psnr).
+            arg(metrics.ssim, 0, 'f', 4).
+            arg(double(metrics.maxError), 0, 'g', 4);
+}
+
+QString comparisonToText(const TextureComparison &comparison)
+{
+    const char *names[] = {"red", "green", "blue", "alpha"};
+
+    QStringList result;
+    for (int c = 0; c < TextureComparison::ChannelCount; ++c) {
+        result.append(metricsToText(
+                QLatin1String(names[c]),
+                comparison.channel(TextureComparison::ChannelIndex(c))));
+    }
+    result.append(metricsToText(CompareTool::tr("total"), comparison.total()));
+    return result.join("\n");
+}
+
+void writeDiff(const QString &filePath, const Texture &diff)
+{
+    TextureIO io(filePath);
+    const auto ok = io.write(diff);
+    if (!ok) {
+        throw RuntimeError(CompareTool::tr("Can't write texture %1: %2").
+                           arg(filePath, toUserString(ok.error())));
+    }
+}
+
+int compare(const Options &options)
+{
+    const auto lhs = readTexture(options.lhsFile);
+    const auto rhs = readTexture(options.rhsFile);
+
+    if (lhs.layers() != rhs.layers() || lhs.levels() != rhs.levels()
+            || lhs.faces() != rhs.faces()) {
+        throw RuntimeError(CompareTool::tr("Images have different layers, levels or faces"));
+    }
+
+    bool passed = true;
+    for (int layer = 0; layer < lhs.layers(); ++layer) {
+        for (int level = 0; level < lhs.levels(); ++level) {
+            for (int face = 0; face < lhs.faces(); ++face) {
+                const Texture::ArrayIndex index(Texture::Side(face), level, layer);
+                const auto writeDiffImage = !options.diffFile.isEmpty()
+                        && layer == 0 && level == 0 && face == 0;
+                const TextureComparison comparison(
+                        lhs, rhs, index,
+                        writeDiffImage
+                                ? TextureComparison::Option::DiffImage
+                                : TextureComparison::Option::NoOptions);
+                if (comparison.isNull()) {
+                    throw RuntimeError(CompareTool::tr("Can't compare images of format %1 and %2").
+                                       arg(toQString(lhs.format()), toQString(rhs.format())));
+                }
+
+                auto header = CompareTool::tr("Layer %1, level %2").arg(layer).arg(level);
+                if (lhs.faces() > 1)
+                    header += CompareTool::tr(", face %1").arg(toQString(Texture::Side(face)));
+                ToolParser::showMessage(header + ":");
+                ToolParser::showMessage(comparisonToText(comparison));
+
+                const auto &total = comparison.total();
+                if (total.psnr < options.minPsnr || total.ssim < options.minSsim)
+                    passed = false;
+
+                if (writeDiffImage)
+                    writeDiff(options.diffFile, comparison.diffImage());
+            }
+        }
+    }
+
+    return passed ? 0 : thresholdExitCode;
+}
+
+} // namespace
+
+/*!
+    \class CompareTool
+    This is class implements image comparing tool.
+
+    The tool returns 0 if images are within the thresholds, 2 if they are not, and 1 on errors.
+*/
+
+/*!
+    Constructs a CompareTool instance.
+*/
+CompareTool::CompareTool() = default;
+
+/*!
+    \overload
+*/
+QByteArray CompareTool::id() const
+{
+    return {toolId.data(), int(toolId.size())};
+}
+
+/*!
+    \overload
+*/
+QString CompareTool::decription() const
+{
+    return CompareTool::tr("Compares two image files", "TextureTool");
+}
+
+/*!
+    \overload
+*/
+int CompareTool::run(const QStringList &arguments)
+{
+    const auto options = parseOptions(arguments);
+    return compare(options);
+}
+
+} // namespace TextureTool
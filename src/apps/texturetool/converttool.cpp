@@ -8,6 +8,7 @@
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDebug>
+#include <QtCore/QFile>
 
 #include <OptionalType>
 
@@ -24,6 +25,8 @@ struct Options
     QString outputFile;
     QString outputMimeType;
     QString outputFormat;
+    bool flipY {false};
+    bool skipUnchanged {false};
 };
 
 Options parseOptions(const QStringList &arguments)
@@ -40,7 +43,15 @@ Options parseOptions(const QStringList &arguments)
                                         QStringLiteral("output format"));
     parser.addOption(inputTypeOption);
     parser.addOption(outputTypeOption);
+    QCommandLineOption skipUnchangedOption(QStringLiteral("skip-unchanged"),
+                                           ConvertTool::tr("Skip conversion if the input was not "
+                                                           "changed since the last conversion"));
+    QCommandLineOption flipYOption(QStringLiteral("flip-y"),
+                                   ConvertTool::tr("Flip images vertically, i.e. to convert between "
+                                                   "the bottom-left and the top-left origin"));
     parser.addOption(outputFormatOption);
+    parser.addOption(flipYOption);
+    parser.addOption(skipUnchangedOption);
     parser.addPositionalArgument(QStringLiteral("input"),
                                  ConvertTool::tr("Input filename"),
                                  QStringLiteral("input"));
@@ -62,6 +73,8 @@ Options parseOptions(const QStringList &arguments)
     options.inputMimeType = parser.value(inputTypeOption);
     options.outputMimeType = parser.value(outputTypeOption);
     options.outputFormat = parser.value(outputFormatOption);
+    options.flipY = parser.isSet(flipYOption);
+    options.skipUnchanged = parser.isSet(skipUnchangedOption);
     return options;
 }
 
@@ -77,6 +90,39 @@ QLatin1String mimeTypeToFormat(QStringView mimeType)
     return {};
 }
 
+// The stamp file stores the hash of the input texture together with the conversion options
+QString stampFileName(const Options &options)
+{
+    return options.outputFile + QStringLiteral(".hash");
+}
+
+QByteArray makeStamp(const Options &options, const Texture &texture)
+{
+    return QByteArray::number(texture.contentHash(), 16) + '\n'
+            + options.outputFormat.toUtf8() + '\n'
+            + options.outputMimeType.toUtf8() + '\n'
+            + (options.flipY ? "flip-y\n" : "");
+}
+
+bool isUpToDate(const Options &options, const QByteArray &stamp)
+{
+    if (!QFile::exists(options.outputFile))
+        return false;
+    QFile file(stampFileName(options));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    return file.readAll() == stamp;
+}
+
+void writeStamp(const Options &options, const QByteArray &stamp)
+{
+    QFile file(stampFileName(options));
+    if (!file.open(QIODevice::WriteOnly) || file.write(stamp) != stamp.size()) {
+        throw RuntimeError(ConvertTool::tr("Can't write \"%1\": %2").
+                           arg(file.fileName(), file.errorString()));
+    }
+}
+
 void convert(const Options &options)
 {
     TextureIO io(options.inputFile);
@@ -107,6 +153,19 @@ void convert(const Options &options)
                            arg(options.inputFile, toUserString(result.error())));
     }
 
+    QByteArray stamp;
+    if (options.skipUnchanged) {
+        stamp = makeStamp(options, *texture);
+        if (isUpToDate(options, stamp))
+            return;
+    }
+
+    if (options.flipY) {
+        texture = texture->flipped(Qt::Vertical);
+        if (texture->isNull())
+            throw RuntimeError(ConvertTool::tr("Can't flip \"%1\"").arg(options.inputFile));
+    }
+
     Texture copy;
     if (!options.outputFormat.isEmpty()) {
         const auto format = fromQString<TextureFormat>(options.outputFormat);
@@ -114,7 +173,7 @@ void convert(const Options &options)
             throw RuntimeError(ConvertTool::tr("Invalid output format: %1")
                                .arg(options.outputFormat));
         }
-        copy = result->convert(*format);
+        copy = texture->convert(*format);
 
         if (copy.isNull()) {
             throw RuntimeError(ConvertTool::tr("Convertion failed"));
@@ -131,6 +190,9 @@ void convert(const Options &options)
         throw RuntimeError(ConvertTool::tr("Can't write texture %1: %2").
                            arg(options.outputFile, toUserString(ok.error())));
     }
+
+    if (options.skipUnchanged)
+        writeStamp(options, stamp);
 }
 
 } // namespace
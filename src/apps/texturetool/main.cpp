@@ -1,4 +1,5 @@
 #include "abstracttool.h"
+#include "comparetool.h"
 #include "converttool.h"
 #include "exception.h"
 #include "mainparser.h"
@@ -6,6 +7,7 @@
 #include "toolparser.h"
 
 #include <QtCore/QDebug>
+#include <QtCore/QStandardPaths>
 #include <QtGui/QGuiApplication>
 
 #include <TextureLib/TextureIO>
@@ -16,6 +18,7 @@
 using ExitException = TextureTool::ExitException;
 using RuntimeError = TextureTool::RuntimeError;
 using AbstractTool = TextureTool::AbstractTool;
+using CompareTool = TextureTool::CompareTool;
 using ConvertTool = TextureTool::ConvertTool;
 using ShowTool = TextureTool::ShowTool;
 using MainParser = TextureTool::MainParser;
@@ -25,9 +28,11 @@ using DescriptionMap = MainParser::DescriptionMap;
 
 static ToolsMap createTools()
 {
+    auto compareTool = std::make_unique<CompareTool>();
     auto convertTool = std::make_unique<ConvertTool>();
     auto showTool = std::make_unique<ShowTool>();
     ToolsMap result;
+    result[compareTool->id()] = std::move(compareTool);
     result[convertTool->id()] = std::move(convertTool);
     result[showTool->id()] = std::move(showTool);
     return result;
@@ -49,6 +54,10 @@ int main(int argc, char *argv[])
         QCoreApplication::setApplicationName("texturetool");
         QCoreApplication::setApplicationVersion("1.0");
         QCoreApplication::addLibraryPath(QCoreApplication::applicationDirPath() + TextureIO::pluginsDirPath());
+        // the tool is often run in loops, so don't read metadata of each plugin every time
+        TextureIO::setPluginIndexCachePath(
+                QStandardPaths::writableLocation(QStandardPaths::CacheLocation)
+                + QStringLiteral("/textureformats.json"));
 
         const auto tools = createTools();
 
@@ -4,6 +4,7 @@
 
 #include <TextureLib/TextureIO>
 #include <TextureLib/TextureModel>
+#include <TextureLib/TextureStatistics>
 
 #include <QtCore/QDebug>
 
@@ -16,12 +17,16 @@ constexpr gsl::span<const char> toolId = "show";
 struct Options
 {
     bool showInfo {false};
+    bool showStatistics {false};
     QString fileName;
 };
 
 Options parseOptions(const QStringList &arguments)
 {
     ToolParser parser({toolId.data(), int(toolId.size())});
+    QCommandLineOption statsOption(QStringLiteral("stats"),
+                                   ShowTool::tr("Show per-channel statistics of each image"));
+    parser.addOption(statsOption);
     parser.addPositionalArgument(QStringLiteral("file"),
                                  ShowTool::tr("Input filename"),
                                  QStringLiteral("[file]"));
@@ -39,6 +44,7 @@ Options parseOptions(const QStringList &arguments)
         parser.showHelp(EXIT_FAILURE);
     } else {
         result.showInfo = true;
+        result.showStatistics = parser.isSet(statsOption);
         result.fileName = positional.at(0);
     }
 
@@ -58,18 +64,75 @@ QString modelToText(QAbstractTableModel *model)
     return result.join("\n");
 }
 
-void showImageInfo(const QString &filePath)
+QString statisticsToText(const TextureStatistics &statistics)
+{
+    const char *names[] = {"red", "green", "blue", "alpha"};
+
+    QStringList result;
+    for (int c = 0; c < TextureStatistics::ChannelCount; ++c) {
+        const auto &channel = statistics.channel(TextureStatistics::ChannelIndex(c));
+        result.append(ShowTool::tr("  %1 min %2 max %3 mean %4 stddev %5").
+                      arg(QLatin1String(names[c]), -6).
+                      arg(channel.min, 0, 'g', 4).
+                      arg(channel.max, 0, 'g', 4).
+                      arg(channel.mean, 0, 'g', 4).
+                      arg(channel.stdDev, 0, 'g', 4));
+    }
+    result.append(ShowTool::tr("  NaN %1 Inf %2 alpha %3").
+                  arg(statistics.nanCount()).
+                  arg(statistics.infCount()).
+                  arg(toQString(statistics.alphaUsage())));
+    return result.join("\n");
+}
+
+void showStatistics(const Texture &texture)
+{
+    if (texture.isCompressed()) {
+        throw RuntimeError(ShowTool::tr("Statistics are not supported for compressed format %1").
+                           arg(toQString(texture.format())));
+    }
+
+    for (int layer = 0; layer < texture.layers(); ++layer) {
+        for (int level = 0; level < texture.levels(); ++level) {
+            for (int face = 0; face < texture.faces(); ++face) {
+                const Texture::ArrayIndex index(Texture::Side(face), level, layer);
+                auto header = ShowTool::tr("Layer %1, level %2").arg(layer).arg(level);
+                if (texture.faces() > 1)
+                    header += ShowTool::tr(", face %1").arg(toQString(Texture::Side(face)));
+                ToolParser::showMessage(header + ":");
+                ToolParser::showMessage(statisticsToText(TextureStatistics(texture, index)));
+            }
+        }
+    }
+}
+
+void showImageInfo(const QString &filePath, bool statistics)
 {
     TextureIO io(filePath);
+    TextureModel model;
+
+    // only the header is read unless statistics are requested
+    if (!statistics) {
+        const auto result = io.readInfo();
+        if (!result) {
+            throw RuntimeError(ShowTool::tr("Can't read image %1: %2").
+                               arg(filePath, toUserString(result.error())));
+        }
+        model.setInfo(*result);
+        ToolParser::showMessage(modelToText(&model));
+        return;
+    }
+
     const auto result = io.read();
     if (!result) {
         throw RuntimeError(ShowTool::tr("Can't read image %1: %2").
                            arg(filePath, toUserString(result.error())));
     }
 
-    TextureModel model;
-    model.setTexture(*result);
+    // statistics rows of the model only cover the first image, showStatistics() prints all of them
+    model.setInfo(TextureInfo(*result));
     ToolParser::showMessage(modelToText(&model));
+    showStatistics(*result);
 }
 
 } // namespace
@@ -108,7 +171,7 @@ int ShowTool::run(const QStringList &arguments)
     const auto options = parseOptions(arguments);
 
     if (options.showInfo)
-        showImageInfo(options.fileName);
+        showImageInfo(options.fileName, options.showStatistics);
 
     return 0;
 }
@@ -0,0 +1,414 @@
+#include "cubemap.h"
+#include "cubemath_p.h"
+#include "texture_p.h"
+#include "textureparallel_p.h"
+#include "texturesampler.h"
+
+#include <QtCore/QDebug>
+
+#include <vector>
+
+using Private::Vector3;
+using Private::operator+;
+using Private::operator*;
+using Private::pi;
+using size_type = Texture::size_type;
+
+namespace {
+
+using Float4 = std::array<float, 4>;
+
+// Direction sampled relative to the normal and its weight
+struct Sample
+{
+    Vector3 direction;
+    float weight {0.0f};
+    float lod {0.0f};
+};
+
+inline float radicalInverse(quint32 bits) noexcept
+{
+    bits = (bits << 16u) | (bits >> 16u);
+    bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+    bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+    bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+    bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+    return float(bits) * 2.3283064365386963e-10f; // / 0x100000000
+}
+
+// Low-discrepancy point set, gives much less noise than random samples
+inline std::array<float, 2> hammersley(int i, int count) noexcept
+{
+    return {float(i) / count, radicalInverse(quint32(i))};
+}
+
+// Level of detail to fetch a sample from so its footprint matches the solid angle it represents
+float sampleLod(float pdf, int sampleCount, size_type faceSize)
+{
+    const auto sampleAngle = 1.0f / (sampleCount * pdf + 1e-6f);
+    const auto texelAngle = 4.0f * pi / (6.0f * faceSize * faceSize);
+    // +1 bias slightly blurs the result, hiding the remaining noise
+    return std::max(0.5f * std::log2(sampleAngle / texelAngle) + 1.0f, 0.0f);
+}
+
+// Importance samples the GGX distribution assuming the view direction equals the normal
+std::vector<Sample> ggxSamples(float roughness, int sampleCount, size_type faceSize)
+{
+    const auto a = roughness * roughness;
+    const auto a2 = a * a;
+
+    std::vector<Sample> result;
+    result.reserve(size_t(sampleCount));
+    for (int i = 0; i < sampleCount; ++i) {
+        const auto xi = hammersley(i, sampleCount);
+        const auto phi = 2.0f * pi * xi[0];
+        const auto cosTheta = std::sqrt((1.0f - xi[1]) / (1.0f + (a2 - 1.0f) * xi[1]));
+        const auto sinTheta = std::sqrt(1.0f - cosTheta * cosTheta);
+
+        // reflect the view vector (0, 0, 1) around the half vector
+        const Vector3 h = {sinTheta * std::cos(phi), sinTheta * std::sin(phi), cosTheta};
+        const Vector3 l = {2.0f * cosTheta * h[0], 2.0f * cosTheta * h[1], 2.0f * cosTheta * h[2] - 1.0f};
+        const auto nDotL = l[2];
+        if (nDotL <= 0.0f)
+            continue;
+
+        const auto d = (a2 - 1.0f) * cosTheta * cosTheta + 1.0f;
+        const auto distribution = a2 / (pi * d * d);
+        // pdf = D * NdotH / (4 * VdotH) and NdotH == VdotH when N == V
+        const auto pdf = distribution / 4.0f;
+        result.push_back({l, nDotL, sampleLod(pdf, sampleCount, faceSize)});
+    }
+    return result;
+}
+
+// Cosine-weighted hemisphere samples, so the estimator is a plain average
+std::vector<Sample> cosineSamples(int sampleCount, size_type faceSize)
+{
+    std::vector<Sample> result;
+    result.reserve(size_t(sampleCount));
+    for (int i = 0; i < sampleCount; ++i) {
+        const auto xi = hammersley(i, sampleCount);
+        const auto phi = 2.0f * pi * xi[0];
+        const auto cosTheta = std::sqrt(1.0f - xi[1]);
+        const auto sinTheta = std::sqrt(xi[1]);
+        const Vector3 l = {sinTheta * std::cos(phi), sinTheta * std::sin(phi), cosTheta};
+        result.push_back({l, 1.0f, sampleLod(cosTheta / pi, sampleCount, faceSize)});
+    }
+    return result;
+}
+
+Float4 convolve(const TextureSampler &sampler, const Vector3 &normal, const std::vector<Sample> &samples)
+{
+    const Vector3 up = std::abs(normal[2]) < 0.999f ? Vector3{0.0f, 0.0f, 1.0f} : Vector3{1.0f, 0.0f, 0.0f};
+    const auto tangent = Private::normalized(Private::cross(up, normal));
+    const auto bitangent = Private::cross(normal, tangent);
+
+    Float4 sum = {0.0f, 0.0f, 0.0f, 0.0f};
+    float totalWeight = 0.0f;
+    for (const auto &sample: samples) {
+        const auto &l = sample.direction;
+        const auto dir = tangent * l[0] + bitangent * l[1] + normal * l[2];
+        const auto color = sampler.sampleCube(dir[0], dir[1], dir[2], sample.lod);
+        sum[0] += color.red() * sample.weight;
+        sum[1] += color.green() * sample.weight;
+        sum[2] += color.blue() * sample.weight;
+        sum[3] += color.alpha() * sample.weight;
+        totalWeight += sample.weight;
+    }
+
+    if (totalWeight > 0.0f) {
+        for (auto &value: sum)
+            value /= totalWeight;
+    }
+    return sum;
+}
+
+inline Vector3 texelDirection(size_type face, size_type x, size_type y, size_type size) noexcept
+{
+    const auto s = 2.0f * (x + 0.5f) / size - 1.0f;
+    const auto t = 2.0f * (y + 0.5f) / size - 1.0f;
+    return Private::normalized(Private::faceToDirection(face, s, t));
+}
+
+// Equirectangular projection with +Y up, the center of the image looks at -Z
+inline Vector3 panoramaDirection(float u, float v) noexcept
+{
+    const auto phi = (u - 0.5f) * 2.0f * pi;
+    const auto theta = v * pi;
+    return {std::sin(theta) * std::sin(phi), std::cos(theta), -std::sin(theta) * std::cos(phi)};
+}
+
+inline std::array<float, 2> panoramaCoord(const Vector3 &dir) noexcept
+{
+    const auto u = 0.5f + std::atan2(dir[0], -dir[2]) / (2.0f * pi);
+    const auto v = std::acos(qBound(-1.0f, dir[1], 1.0f)) / pi;
+    return {u, v};
+}
+
+bool checkCubemap(const Texture &cubemap, const char *function)
+{
+    if (cubemap.isNull())
+        return false;
+    if (cubemap.faces() != 6) {
+        qCWarning(texture) << function << "requires a cubemap texture";
+        return false;
+    }
+    return true;
+}
+
+TextureData::RowWriter formatWriter(TextureFormat format, const char *function)
+{
+    auto writer = TextureData::getRowWriter(format);
+    if (!writer)
+        qCWarning(texture) << function << "is not supported for format" << format;
+    return writer;
+}
+
+// Filters sampled from mipmaps, so the source is given a mip chain if it does not have one
+Texture withMipmaps(const Texture &cubemap)
+{
+    if (cubemap.levels() > 1 || cubemap.isCompressed())
+        return cubemap;
+    const auto result = cubemap.generateMipmaps(Texture::Filter::Box);
+    return result.isNull() ? cubemap : result;
+}
+
+// Fills the given level of each face of the cubemap with colors returned by the func(face, x, y);
+// rows are computed in parallel
+template<typename Func>
+void renderCubemap(
+        Texture &result,
+        size_type level,
+        const TextureData::RowWriter &writer,
+        size_type costPerTexel,
+        const Func &func)
+{
+    const auto size = result.width(level);
+    std::array<TextureSpan, 6> spans;
+    for (size_type face = 0; face < 6; ++face)
+        spans[size_t(face)] = result.imageSpan({Texture::Side(face), level});
+
+    Private::parallelFor(6 * size, size * costPerTexel, [&](size_type begin, size_type end)
+    {
+        std::vector<Rgba128Float> buffer(static_cast<size_t>(size));
+        for (auto row = begin; row < end; ++row) {
+            const auto face = row / size;
+            const auto y = row % size;
+            for (size_type x = 0; x < size; ++x) {
+                const auto color = func(face, x, y);
+                buffer[size_t(x)] = rgba128Float(color[0], color[1], color[2], color[3]);
+            }
+            writer(buffer, spans[size_t(face)].line(y));
+        }
+    });
+}
+
+inline Float4 toFloat4(const Rgba128Float &color) noexcept
+{
+    return {color.red(), color.green(), color.blue(), color.alpha()};
+}
+
+} // namespace
+
+/*!
+  \namespace Cubemap
+  \brief Contains functions that generate and filter cubemaps for image-based lighting.
+
+  All functions sample the first layer of the source and compute texels in parallel.
+  Results are written in the given format, floating point formats such as RGBA16_Float or
+  RGBA32_Float are recommended to keep the HDR range. Faces are laid out as in OpenGL.
+*/
+
+/*!
+  \brief Projects the equirectangular (latitude-longitude) \a panorama to a cubemap with faces of
+  the given \a faceSize.
+
+  The top row of the panorama maps to +Y, the center looks at -Z.
+*/
+Texture Cubemap::fromEquirectangular(
+        const Texture &panorama, Texture::size_type faceSize, TextureFormat format)
+{
+    if (panorama.isNull())
+        return Texture();
+
+    if (panorama.faces() != 1 || faceSize <= 0) {
+        qCWarning(texture) << "fromEquirectangular() was called with invalid parameters";
+        return Texture();
+    }
+
+    const auto writer = formatWriter(format, "fromEquirectangular()");
+    if (!writer)
+        return Texture();
+
+    const TextureSampler sampler(
+            panorama, TextureSampler::Filter::Trilinear, TextureSampler::AddressMode::Wrap);
+    if (sampler.isNull())
+        return Texture();
+
+    Texture result(format, {faceSize, faceSize}, {Texture::IsCubemap::Yes, 1, 1});
+    if (result.isNull())
+        return Texture();
+
+    // a face covers a quarter of the panorama width
+    const auto lod = std::max(0.0f, std::log2(float(panorama.width()) / (4 * faceSize)));
+    // keep rows at the poles from wrapping to the opposite side
+    const auto minV = 0.5f / panorama.height();
+    renderCubemap(result, 0, writer, 1, [&](size_type face, size_type x, size_type y)
+    {
+        const auto coord = panoramaCoord(texelDirection(face, x, y, faceSize));
+        return toFloat4(sampler.sample(coord[0], qBound(minV, coord[1], 1.0f - minV), lod));
+    });
+
+    return result;
+}
+
+/*!
+  \brief Projects the \a cubemap to an equirectangular panorama of the given \a size.
+
+  This is the inverse of fromEquirectangular().
+*/
+Texture Cubemap::toEquirectangular(
+        const Texture &cubemap, Texture::Size size, TextureFormat format)
+{
+    if (!checkCubemap(cubemap, "toEquirectangular()"))
+        return Texture();
+
+    if (!size.isValid() || size.depth != 1) {
+        qCWarning(texture) << "toEquirectangular() was called with an invalid size";
+        return Texture();
+    }
+
+    const auto writer = formatWriter(format, "toEquirectangular()");
+    if (!writer)
+        return Texture();
+
+    const TextureSampler sampler(cubemap, TextureSampler::Filter::Trilinear);
+    if (sampler.isNull())
+        return Texture();
+
+    Texture result(format, size);
+    if (result.isNull())
+        return Texture();
+
+    const auto lod = std::max(0.0f, std::log2(4.0f * cubemap.width() / size.width));
+    auto span = result.imageSpan({});
+    Private::parallelFor(size.height, size.width, [&](size_type begin, size_type end)
+    {
+        std::vector<Rgba128Float> buffer(static_cast<size_t>(size.width));
+        for (auto y = begin; y < end; ++y) {
+            for (size_type x = 0; x < size.width; ++x) {
+                const auto dir = panoramaDirection(
+                        (x + 0.5f) / size.width, (y + 0.5f) / size.height);
+                buffer[size_t(x)] = sampler.sampleCube(dir[0], dir[1], dir[2], lod);
+            }
+            writer(buffer, span.line(y));
+        }
+    });
+
+    return result;
+}
+
+/*!
+  \brief Prefilters the \a cubemap for the specular image-based lighting with the GGX
+  distribution.
+
+  The resulting cubemap has the full mip chain, the roughness grows linearly from 0 at the first
+  level to 1 at the last one. Each texel is the integral of \a sampleCount importance-sampled
+  directions; samples are fetched from the mipmap matching their solid angle, which removes most
+  of the noise with a few samples.
+
+  The view direction is assumed to be equal to the normal, as in the split sum approximation.
+*/
+Texture Cubemap::prefilterSpecular(const Texture &cubemap, int sampleCount, TextureFormat format)
+{
+    if (!checkCubemap(cubemap, "prefilterSpecular()"))
+        return Texture();
+
+    if (sampleCount <= 0) {
+        qCWarning(texture) << "prefilterSpecular() was called with an invalid sample count";
+        return Texture();
+    }
+
+    const auto writer = formatWriter(format, "prefilterSpecular()");
+    if (!writer)
+        return Texture();
+
+    const auto source = withMipmaps(cubemap);
+    const TextureSampler sampler(source, TextureSampler::Filter::Trilinear);
+    if (sampler.isNull())
+        return Texture();
+
+    const auto faceSize = cubemap.width();
+    size_type levels = 1;
+    while (faceSize >> levels)
+        ++levels;
+
+    Texture result(format, {faceSize, faceSize}, {Texture::IsCubemap::Yes, levels, 1});
+    if (result.isNull())
+        return Texture();
+
+    // the first level is a mirror reflection
+    renderCubemap(result, 0, writer, 1, [&](size_type face, size_type x, size_type y)
+    {
+        const auto dir = texelDirection(face, x, y, faceSize);
+        return toFloat4(sampler.sampleCube(dir[0], dir[1], dir[2]));
+    });
+
+    for (size_type level = 1; level < levels; ++level) {
+        const auto roughness = float(level) / (levels - 1);
+        const auto samples = ggxSamples(roughness, sampleCount, faceSize);
+        const auto size = result.width(level);
+        renderCubemap(result, level, writer, sampleCount, [&](size_type face, size_type x, size_type y)
+        {
+            return convolve(sampler, texelDirection(face, x, y, size), samples);
+        });
+    }
+
+    return result;
+}
+
+/*!
+  \brief Computes the diffuse irradiance of the \a cubemap.
+
+  Each texel of the resulting cubemap with faces of the given \a faceSize is the cosine-weighted
+  average of the incoming radiance over the hemisphere around its direction, i.e. the irradiance
+  divided by pi. It can be multiplied by the albedo directly.
+
+  The integral is estimated with \a sampleCount cosine-distributed samples fetched from the
+  mipmaps of the source.
+*/
+Texture Cubemap::irradiance(
+        const Texture &cubemap,
+        Texture::size_type faceSize,
+        int sampleCount,
+        TextureFormat format)
+{
+    if (!checkCubemap(cubemap, "irradiance()"))
+        return Texture();
+
+    if (faceSize <= 0 || sampleCount <= 0) {
+        qCWarning(texture) << "irradiance() was called with invalid parameters";
+        return Texture();
+    }
+
+    const auto writer = formatWriter(format, "irradiance()");
+    if (!writer)
+        return Texture();
+
+    const auto source = withMipmaps(cubemap);
+    const TextureSampler sampler(source, TextureSampler::Filter::Trilinear);
+    if (sampler.isNull())
+        return Texture();
+
+    Texture result(format, {faceSize, faceSize}, {Texture::IsCubemap::Yes, 1, 1});
+    if (result.isNull())
+        return Texture();
+
+    const auto samples = cosineSamples(sampleCount, cubemap.width());
+    renderCubemap(result, 0, writer, sampleCount, [&](size_type face, size_type x, size_type y)
+    {
+        return convolve(sampler, texelDirection(face, x, y, faceSize), samples);
+    });
+
+    return result;
+}
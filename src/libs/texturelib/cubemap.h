@@ -0,0 +1,31 @@
+#pragma once
+
+#include "texturelib_global.h"
+
+#include <TextureLib/Texture>
+#include <TextureLib/TextureFormat>
+
+namespace Cubemap {
+
+Texture TEXTURELIB_EXPORT fromEquirectangular(
+        const Texture &panorama,
+        Texture::size_type faceSize,
+        TextureFormat format = TextureFormat::RGBA16_Float);
+
+Texture TEXTURELIB_EXPORT toEquirectangular(
+        const Texture &cubemap,
+        Texture::Size size,
+        TextureFormat format = TextureFormat::RGBA16_Float);
+
+Texture TEXTURELIB_EXPORT prefilterSpecular(
+        const Texture &cubemap,
+        int sampleCount = 64,
+        TextureFormat format = TextureFormat::RGBA16_Float);
+
+Texture TEXTURELIB_EXPORT irradiance(
+        const Texture &cubemap,
+        Texture::size_type faceSize = 32,
+        int sampleCount = 512,
+        TextureFormat format = TextureFormat::RGBA16_Float);
+
+} // namespace Cubemap
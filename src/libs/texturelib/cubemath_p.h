@@ -0,0 +1,88 @@
+#ifndef CUBEMATH_P_H
+#define CUBEMATH_P_H
+
+#include <QtCore/qglobal.h>
+
+#include <array>
+#include <cmath>
+
+namespace Private {
+
+using Vector3 = std::array<float, 3>;
+
+constexpr float pi = 3.14159265358979323846f;
+
+constexpr Vector3 operator+(const Vector3 &a, const Vector3 &b) noexcept
+{ return {a[0] + b[0], a[1] + b[1], a[2] + b[2]}; }
+
+constexpr Vector3 operator*(const Vector3 &a, float s) noexcept
+{ return {a[0] * s, a[1] * s, a[2] * s}; }
+
+constexpr float dot(const Vector3 &a, const Vector3 &b) noexcept
+{ return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]; }
+
+constexpr Vector3 cross(const Vector3 &a, const Vector3 &b) noexcept
+{
+    return {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]};
+}
+
+inline Vector3 normalized(const Vector3 &v) noexcept
+{
+    const auto length = std::sqrt(dot(v, v));
+    return length > 0 ? v * (1.0f / length) : v;
+}
+
+struct CubeCoord
+{
+    qsizetype face {0};
+    float u {0.0f};
+    float v {0.0f};
+};
+
+// Follows the OpenGL cube map face selection table
+inline CubeCoord directionToFace(float x, float y, float z) noexcept
+{
+    const auto ax = std::abs(x);
+    const auto ay = std::abs(y);
+    const auto az = std::abs(z);
+
+    qsizetype face = 0;
+    float ma = 0, sc = 0, tc = 0;
+    if (ax >= ay && ax >= az) {
+        ma = ax;
+        face = x > 0 ? 0 : 1;
+        sc = x > 0 ? -z : z;
+        tc = -y;
+    } else if (ay >= az) {
+        ma = ay;
+        face = y > 0 ? 2 : 3;
+        sc = x;
+        tc = y > 0 ? z : -z;
+    } else {
+        ma = az;
+        face = z > 0 ? 4 : 5;
+        sc = z > 0 ? x : -x;
+        tc = -y;
+    }
+    if (ma == 0)
+        return {};
+    return {face, 0.5f * (sc / ma + 1.0f), 0.5f * (tc / ma + 1.0f)};
+}
+
+// Inverse of the directionToFace, s and t are in [-1, 1] range
+inline Vector3 faceToDirection(qsizetype face, float s, float t) noexcept
+{
+    switch (face) {
+    case 0: return {1.0f, -t, -s};
+    case 1: return {-1.0f, -t, s};
+    case 2: return {s, 1.0f, t};
+    case 3: return {s, -1.0f, -t};
+    case 4: return {s, -t, 1.0f};
+    case 5: return {-s, -t, -1.0f};
+    default: return {};
+    }
+}
+
+} // namespace Private
+
+#endif // CUBEMATH_P_H
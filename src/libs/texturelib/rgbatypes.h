@@ -415,6 +415,9 @@ inline constexpr Dst convertChannel(Src src)
 {
     if constexpr (std::is_same_v<std::decay_t<Src>, std::decay_t<Dst>>)
             return src;
+    // HDR values are preserved between float types
+    if constexpr (is_float_v<Src> && is_float_v<Dst>)
+        return Dst(float(src));
     const auto maxSrc = ColorChannelLimits<Src>::max();
     const auto maxDst = ColorChannelLimits<Dst>::max();
 
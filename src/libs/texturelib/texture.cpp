@@ -1,10 +1,16 @@
 #include "texture_p.h"
+#include "texturehash_p.h"
+#include "textureresampler_p.h"
+#include "texturerowoperation_p.h"
+#include "texturetransform_p.h"
 #include "textureio.h"
 
 #include <QtCore/QDebug>
 #include <QtCore/QMetaEnum>
 
+#include <algorithm>
 #include <memory>
+#include <vector>
 
 #define CHECK_WIDTH(width, rv) \
     if ((width) < 0) { \
@@ -66,6 +72,96 @@ int memoryCompare(Texture::ConstData lhs, Texture::ConstData rhs)
     return memcmp(lhs.data(), rhs.data(), std::size_t(lhs.size_bytes()));
 }
 
+using FormatReader = decltype(TextureData::getFormatReader(TextureFormat::Invalid));
+using FormatWriter = decltype(TextureData::getFormatWriter(TextureFormat::Invalid));
+
+// Converts src to dst line by line. If no reader/writer is passed, lines are copied as is.
+void convertSpan(
+        ConstTextureSpan src, TextureSpan dst, const FormatReader &reader, const FormatWriter &writer)
+{
+    Q_ASSERT(src.width() == dst.width());
+    Q_ASSERT(src.height() == dst.height());
+    Q_ASSERT(src.depth() == dst.depth());
+
+    const auto srcBytesPerTexel = src.bytesPerTexel();
+    const auto dstBytesPerTexel = dst.bytesPerTexel();
+
+    auto dstIt = dst.begin();
+    for (const auto srcLine: src) {
+        const auto dstLine = *dstIt++;
+        if (reader && writer) {
+            Q_ASSERT(srcBytesPerTexel && dstBytesPerTexel);
+            for (Texture::size_type x = 0; x < src.width(); ++x) {
+                const auto srcTexel = srcLine.subspan(srcBytesPerTexel * x, srcBytesPerTexel);
+                const auto dstTexel = dstLine.subspan(dstBytesPerTexel * x, dstBytesPerTexel);
+                writer(dstTexel, reader(srcTexel));
+            }
+        } else { // ok, only alingment changed, fast copy
+            memoryCopy(dstLine, srcLine);
+        }
+    }
+}
+
+struct ImageFormatMapping
+{
+    QImage::Format imageFormat;
+    TextureFormat textureFormat;
+};
+
+// QImage formats that have exactly the same memory layout as a texture format
+constexpr ImageFormatMapping imageFormatMappings[] = {
+    { QImage::Format_Alpha8, TextureFormat::A8_Unorm },
+    { QImage::Format_Grayscale8, TextureFormat::L8_Unorm },
+    { QImage::Format_RGB888, TextureFormat::RGB8_Unorm },
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    { QImage::Format_BGR888, TextureFormat::BGR8_Unorm },
+#endif
+    { QImage::Format_RGBA8888, TextureFormat::RGBA8_Unorm },
+    { QImage::Format_RGBX8888, TextureFormat::RGBX8_Unorm },
+    { QImage::Format_RGBA64, TextureFormat::RGBA16_Unorm },
+#if QT_VERSION >= QT_VERSION_CHECK(6, 2, 0)
+    { QImage::Format_RGBA16FPx4, TextureFormat::RGBA16_Float },
+    { QImage::Format_RGBA32FPx4, TextureFormat::RGBA32_Float },
+#endif
+};
+
+TextureFormat mappedTextureFormat(QImage::Format format)
+{
+    for (const auto &mapping: imageFormatMappings) {
+        if (mapping.imageFormat == format)
+            return mapping.textureFormat;
+    }
+    return TextureFormat::Invalid;
+}
+
+QImage::Format mappedImageFormat(TextureFormat format)
+{
+    for (const auto &mapping: imageFormatMappings) {
+        if (mapping.textureFormat == format)
+            return mapping.imageFormat;
+    }
+    return QImage::Format_Invalid;
+}
+
+bool canFlipLevels(const Texture &texture, Qt::Orientations orientations)
+{
+    for (Texture::size_type level = 0; level < texture.levels(); ++level) {
+        if (!Private::canFlip(texture.constImageSpan({Texture::Side(0), level, 0}), orientations))
+            return false;
+    }
+    return true;
+}
+
+void flipImages(Texture &texture, Qt::Orientations orientations)
+{
+    for (Texture::size_type layer = 0; layer < texture.layers(); ++layer) {
+        for (Texture::size_type level = 0; level < texture.levels(); ++level) {
+            for (Texture::size_type face = 0; face < texture.faces(); ++face)
+                Private::flip(texture.imageSpan({Texture::Side(face), level, layer}), orientations);
+        }
+    }
+}
+
 } // namespace
 
 TextureData *TextureData::create(
@@ -266,6 +362,28 @@ qsizetype TextureData::offset(size_type side, size_type level, size_type layer)
     return levelInfos[usize_type(level)].offset + bytesPerImage(level) * (faces * layer + side);
 }
 
+quint64 TextureData::contentHash() const
+{
+    auto result = hash.loadAcquire();
+    if (result)
+        return result;
+
+    // alignment is not a part of the hash as it is ignored by the operator==
+    const quint64 header[] = {
+        quint64(format),
+        quint64(width), quint64(height), quint64(depth),
+        quint64(faces), quint64(levels), quint64(layers)
+    };
+    const auto seed = Private::hashBytes(
+            {reinterpret_cast<const uchar *>(header), qsizetype(sizeof(header))});
+    result = Private::hashBytesParallel({data.get(), nbytes}, seed);
+    if (!result)
+        result = 1;
+
+    hash.storeRelease(result);
+    return result;
+}
+
 /*!
   \enum Texture::Side
 
@@ -351,6 +469,30 @@ qsizetype TextureData::offset(size_type side, size_type level, size_type layer)
   A valid instance has width, height and depth greater than zero.
 */
 
+/*!
+  \class Texture::Region
+  \brief Helper class describing a box inside an image of the texture.
+
+  Region consists of a Texture::Position of the corner and a Texture::Size of the box.
+
+  \sa Texture::copyRegion(), Texture::fill()
+*/
+
+/*!
+  \fn Texture::Region::Region(Position position, Size size) noexcept
+  \brief Constructs a Region instance with the given \a position and \a size.
+*/
+
+/*!
+  \fn Texture::Region::Region(QRect rect, size_type z = 0) noexcept
+  \brief Constructs a 2D Region instance with the given \a rect located at the slice \a z.
+*/
+
+/*!
+  \fn bool Texture::Region::isValid() const noexcept
+  \brief Returns true if the Region has a valid position and size.
+*/
+
 /*!
   \class Texture::ArraySize
   \brief Helper class used in Texture constructors.
@@ -581,52 +723,63 @@ Texture::Texture(QStringView file) :
 
   An image is converted to a single 2D texture with no mipmaps.
 
-  If image has aplha, the constucted texture will have TextureFormat::RGBA8_Unorm format.
+  If the image format has the same memory layout as one of texture formats (for example,
+  QImage::Format_RGBA8888 and TextureFormat::RGBA8_Unorm), the texture shares the data with the
+  image without copying. The image line padding is represented by the texture alignment. The
+  shared data is never modified, the texture detaches on the first write access instead.
 
-  If image has no aplha, the constucted texture will have TextureFormat::RGB8_Unorm format.
+  Other images are converted first. If image has aplha, the constucted texture will have
+  TextureFormat::RGBA8_Unorm format, otherwise it will have TextureFormat::RGB8_Unorm format.
 
-  \note Currently, only images with QImage::Format_ARGB32 or QImage::Format_RGB888 are supported.
-  In other cases, null texture is constructed.
-
-  \sa isNull()
+  \sa isNull(), toImage()
 */
 
 Texture::Texture(const QImage& image)
     : d(nullptr)
 {
-    QImage copy;
-    TextureFormat format = TextureFormat::Invalid;
-    switch (image.format()) {
-    case QImage::Format_ARGB32:
-        format = TextureFormat::RGBA8_Unorm;
-        copy = image.convertToFormat(QImage::Format_RGBA8888);
-        break;
-    case QImage::Format_RGB888:
-        format = TextureFormat::RGB8_Unorm;
-        copy = image;
-        break;
-    default:
+    if (image.isNull()) {
         qCWarning(texture) << "unsupported image format" << image.format();
         return;
     }
 
-    auto result = Texture(format, {copy.width(), copy.height()});
-    const auto bytesPerLine = result.bytesPerLine();
-    if (bytesPerLine < copy.bytesPerLine()) {
-        qCWarning(texture) << Q_FUNC_INFO
-                           << "texture line size is less than an image line size"
-                           << result.bytesPerLine() << "<" << copy.bytesPerLine();
-        return;
+    auto source = image;
+    auto format = mappedTextureFormat(source.format());
+    if (format == TextureFormat::Invalid) {
+        source = image.convertToFormat(
+                image.hasAlphaChannel() ? QImage::Format_RGBA8888 : QImage::Format_RGB888);
+        format = mappedTextureFormat(source.format());
     }
 
-    const auto data = result.imageData({});
-    // QImage uses int, so it's fine to use it here
-    for (int y = 0; y < copy.height(); ++y) {
-        const auto line = data.subspan(bytesPerLine * y, bytesPerLine);
-        memoryCopy(line, {copy.scanLine(y), copy.bytesPerLine()});
+    const auto alignmentForImage = [format](const QImage &image) -> Optional<Alignment>
+    {
+        const auto width = image.width();
+        if (image.bytesPerLine() == calculateBytesPerLine(format, width, Alignment::Byte))
+            return Alignment::Byte;
+        if (image.bytesPerLine() == calculateBytesPerLine(format, width, Alignment::Word))
+            return Alignment::Word;
+        return std::nullopt;
+    };
+
+    auto alignment = alignmentForImage(source);
+    if (!alignment) {
+        // custom line padding can't be represented, copy to a tightly packed image
+        source = source.copy();
+        alignment = alignmentForImage(source);
+        if (!alignment) {
+            qCWarning(texture) << "unsupported image line size" << source.bytesPerLine();
+            return;
+        }
     }
 
-    *this = std::move(result);
+    // Keep a reference to the image in the deleter, so the data is alive while the texture is.
+    // QImage::constBits() doesn't detach the image, so no copy is made here.
+    *this = fromRawData(
+            {source.constBits(), source.sizeInBytes()},
+            [source](uchar[]) {},
+            format,
+            {source.width(), source.height()},
+            {1, 1},
+            *alignment);
 }
 
 /*!
@@ -964,6 +1117,23 @@ qsizetype Texture::bytesPerImage(size_type level) const
     return d->bytesPerImage(level);
 }
 
+/*!
+  \brief Returns the hash of the texture contents.
+
+  The hash takes into account the format, the dimensions and the data of the texture, so equal
+  textures have equal hashes. The hash is calculated on the first call and cached until the
+  texture is modified. Returns 0 for the null texture.
+
+  \note Calling non-const data accessors, such as data(), imageData() or imageSpan(),
+  invalidates the cached hash; writing to the memory obtained before calling this function does
+  not. Memory obtained from a non-const accessor must not be written after the hash is taken,
+  otherwise the hash and the comparison operators use stale data.
+*/
+quint64 Texture::contentHash() const
+{
+    return d ? d->contentHash() : 0;
+}
+
 /*!
   \brief Returns the data of the image at the given \a index.
 */
@@ -997,6 +1167,91 @@ auto Texture::constImageData(ArrayIndex index) const -> ConstData
     return {data, bytesPerImage(index.level())};
 }
 
+/*!
+  \brief Returns a view to the image at the given \a index.
+
+  The view references the data of this texture and is valid until the texture is modified or
+  destroyed.
+*/
+TextureSpan Texture::imageSpan(ArrayIndex index)
+{
+    const auto data = dataImpl(index.face(), index.level(), index.layer());
+    if (!data)
+        return {};
+    const auto level = index.level();
+    return {data,
+            d->format,
+            d->levelWidth(level), d->levelHeight(level), d->levelDepth(level),
+            d->bytesPerLine(level), d->bytesPerSlice(level)};
+}
+
+/*!
+  \brief Returns a constant view to the image at the given \a index.
+*/
+ConstTextureSpan Texture::imageSpan(ArrayIndex index) const
+{
+    return constImageSpan(index);
+}
+
+/*!
+  \brief Returns a constant view to the image at the given \a index.
+*/
+ConstTextureSpan Texture::constImageSpan(ArrayIndex index) const
+{
+    const auto data = dataImpl(index.face(), index.level(), index.layer());
+    if (!data)
+        return {};
+    const auto level = index.level();
+    return {data,
+            d->format,
+            d->levelWidth(level), d->levelHeight(level), d->levelDepth(level),
+            d->bytesPerLine(level), d->bytesPerSlice(level)};
+}
+
+/*!
+  \brief Returns the data of the scanline located at position \a p and array index \a index.
+
+  Returned data does not include the alignment padding. The x coordinate of \a p should be 0.
+
+  \note For compressed formats, the whole row of blocks containing \a p is returned.
+*/
+auto Texture::lineData(Position p, ArrayIndex index) -> Data
+{
+    if (!d)
+        return {};
+
+    CHECK_ZERO_X(p.x, Data());
+    CHECK_LEVEL(index.level(), Data());
+    CHECK_POINT(p.x, p.y, p.z, index.level(), Data());
+
+    return imageSpan(index).line(d->compressed ? p.y / 4 : p.y, p.z);
+}
+
+/*!
+  \brief Returns the constant data of the scanline located at position \a p and array index
+  \a index.
+*/
+auto Texture::lineData(Position p, ArrayIndex index) const -> ConstData
+{
+    return constLineData(p, index);
+}
+
+/*!
+  \brief Returns the constant data of the scanline located at position \a p and array index
+  \a index.
+*/
+auto Texture::constLineData(Position p, ArrayIndex index) const -> ConstData
+{
+    if (!d)
+        return {};
+
+    CHECK_ZERO_X(p.x, ConstData());
+    CHECK_LEVEL(index.level(), ConstData());
+    CHECK_POINT(p.x, p.y, p.z, index.level(), ConstData());
+
+    return constImageSpan(index).line(d->compressed ? p.y / 4 : p.y, p.z);
+}
+
 /*!
     \brief Returns the color of the texel located at position \p and array index \a index.
 
@@ -1014,16 +1269,9 @@ ColorVariant Texture::texelColor(Position p, ArrayIndex index) const
         return {};
     }
 
-    const auto bytesPerSlice = d->bytesPerSlice(index.level());
-    const auto bytesPerLine = d->bytesPerLine(index.level());
-    const auto bytesPerTexel = this->bytesPerTexel();
-
-    const auto data = imageData(index);
-    if (data.empty())
+    const auto texel = imageSpan(index).texel(p.x, p.y, p.z);
+    if (texel.empty())
         return {};
-    const auto line = data.subspan(
-            bytesPerSlice * p.z + bytesPerLine * p.y, bytesPerLine);
-    const auto texel = line.subspan(bytesPerTexel * p.x, bytesPerTexel);
 
     return reader(texel);
 }
@@ -1048,20 +1296,318 @@ void Texture::setTexelColor(Texture::Position p, Texture::ArrayIndex index, cons
         return;
     }
 
-    const auto bytesPerSlice = d->bytesPerSlice(index.level());
-    const auto bytesPerLine = d->bytesPerLine(index.level());
-    const auto bytesPerTexel = this->bytesPerTexel();
-
-    const auto data = imageData(index);
-    if (data.empty())
+    const auto texel = imageSpan(index).texel(p.x, p.y, p.z);
+    if (texel.empty())
         return;
-    const auto line = data.subspan(
-            bytesPerSlice * p.z + bytesPerLine * p.y, bytesPerLine);
-    const auto texel = line.subspan(bytesPerTexel * p.x, bytesPerTexel);
 
     writer(texel, color);
 }
 
+/*!
+  \brief Decodes colors.size() texels starting at the position \a p of the image at \a index
+  to the \a colors buffer.
+
+  Returns true on success, false otherwise.
+
+  \sa readRegion()
+*/
+bool Texture::readRow(Position p, ArrayIndex index, gsl::span<Rgba128Float> colors) const
+{
+    return readRegion({p, {colors.size()}}, index, colors);
+}
+
+/*!
+  \brief Encodes the \a colors buffer to colors.size() texels starting at the position \a p of
+  the image at \a index.
+
+  Returns true on success, false otherwise.
+
+  \sa writeRegion()
+*/
+bool Texture::writeRow(Position p, ArrayIndex index, gsl::span<const Rgba128Float> colors)
+{
+    return writeRegion({p, {colors.size()}}, index, colors);
+}
+
+/*!
+  \brief Decodes texels of the \a region of the image at \a index to the \a colors buffer.
+
+  Colors are stored contiguously, slice by slice and line by line, so the buffer should hold at
+  least width * height * depth elements of the region.
+
+  Unlike texelColor(), this function resolves the format decoder once and does not involve
+  ColorVariant for the most formats, so it is suitable for processing whole images.
+
+  \note This function does nothing for compressed formats
+
+  Returns true on success, false otherwise.
+*/
+bool Texture::readRegion(Region region, ArrayIndex index, gsl::span<Rgba128Float> colors) const
+{
+    if (!d)
+        return false;
+
+    const auto reader = TextureData::getRowReader(d->format);
+    if (!reader) {
+        qCWarning(texture) << "readRegion() is not supported for format" << d->format;
+        return false;
+    }
+
+    if (!region.isValid()) {
+        qCWarning(texture) << "readRegion() was called with an invalid region";
+        return false;
+    }
+
+    const auto &size = region.size;
+    if (colors.size() < size.width * size.height * size.depth) {
+        qCWarning(texture) << "buffer is too small:" << colors.size();
+        return false;
+    }
+
+    const auto span = constImageSpan(index).subSpan(
+            region.position.x, region.position.y, region.position.z,
+            size.width, size.height, size.depth);
+    if (span.isNull()) {
+        qCWarning(texture) << "Region is out of bounds";
+        return false;
+    }
+
+    qsizetype offset = 0;
+    for (const auto line: span) {
+        reader(line, colors.subspan(offset, size.width));
+        offset += size.width;
+    }
+    return true;
+}
+
+/*!
+  \brief Encodes the \a colors buffer to texels of the \a region of the image at \a index.
+
+  The layout of the buffer is the same as for readRegion().
+
+  \note This function does nothing for compressed formats
+
+  Returns true on success, false otherwise.
+*/
+bool Texture::writeRegion(Region region, ArrayIndex index, gsl::span<const Rgba128Float> colors)
+{
+    if (!d)
+        return false;
+
+    const auto writer = TextureData::getRowWriter(d->format);
+    if (!writer) {
+        qCWarning(texture) << "writeRegion() is not supported for format" << d->format;
+        return false;
+    }
+
+    if (!region.isValid()) {
+        qCWarning(texture) << "writeRegion() was called with an invalid region";
+        return false;
+    }
+
+    const auto &size = region.size;
+    if (colors.size() < size.width * size.height * size.depth) {
+        qCWarning(texture) << "buffer is too small:" << colors.size();
+        return false;
+    }
+
+    const auto span = imageSpan(index).subSpan(
+            region.position.x, region.position.y, region.position.z,
+            size.width, size.height, size.depth);
+    if (span.isNull()) {
+        qCWarning(texture) << "Region is out of bounds";
+        return false;
+    }
+
+    qsizetype offset = 0;
+    for (const auto line: span) {
+        writer(colors.subspan(offset, size.width), line);
+        offset += size.width;
+    }
+    return true;
+}
+
+/*!
+  \brief Copies the \a sourceRegion of the image at \a sourceIndex of the \a source texture to
+  the image at \a index of this texture, placing it at the given \a position.
+
+  If the source format differs from the format of this texture, texels are converted, otherwise
+  data is copied line by line. The source can be this texture, overlapping regions are handled
+  correctly.
+
+  For compressed formats, both regions should be aligned to the block size and the formats
+  should be the same.
+
+  Returns true on success, false otherwise.
+*/
+bool Texture::copyRegion(
+        const Texture &source,
+        ArrayIndex sourceIndex,
+        Region sourceRegion,
+        ArrayIndex index,
+        Position position)
+{
+    if (!d || !source.d) {
+        qCWarning(texture) << "copyRegion() was called with a null texture";
+        return false;
+    }
+
+    if (!sourceRegion.isValid() || !position.isValid()) {
+        qCWarning(texture) << "copyRegion() was called with an invalid region";
+        return false;
+    }
+
+    if (source.d == d) {
+        // copy to a temporary texture first to handle overlapping
+        Texture temp(source.format(), sourceRegion.size);
+        if (temp.isNull()
+                || !temp.copyRegion(source, sourceIndex, sourceRegion, {}, {})) {
+            return false;
+        }
+        return copyRegion(temp, {}, {{}, sourceRegion.size}, index, position);
+    }
+
+    FormatReader reader;
+    FormatWriter writer;
+    if (source.format() != d->format) {
+        reader = TextureData::getFormatReader(source.format());
+        writer = TextureData::getFormatWriter(d->format);
+        if (!reader || !writer) {
+            qCWarning(texture) << "Converting from" << source.format() << "to" << d->format
+                               << "is not supported";
+            return false;
+        }
+    }
+
+    const auto &size = sourceRegion.size;
+    const auto src = source.constImageSpan(sourceIndex).subSpan(
+            sourceRegion.position.x, sourceRegion.position.y, sourceRegion.position.z,
+            size.width, size.height, size.depth);
+    if (src.isNull()) {
+        qCWarning(texture) << "Source region is out of bounds";
+        return false;
+    }
+
+    const auto dst = imageSpan(index).subSpan(
+            position.x, position.y, position.z,
+            size.width, size.height, size.depth);
+    if (dst.isNull()) {
+        qCWarning(texture) << "Destination region is out of bounds";
+        return false;
+    }
+
+    convertSpan(src, dst, reader, writer);
+    return true;
+}
+
+/*!
+  \brief Fills all images of this texture with the given \a color.
+
+  \note This function does nothing for compressed formats
+*/
+void Texture::fill(const ColorVariant &color)
+{
+    if (!d)
+        return;
+
+    // checked once, so compressed textures are skipped silently instead of warning per image
+    if (!TextureData::getFormatWriter(d->format))
+        return;
+
+    for (size_type level = 0; level < d->levels; ++level) {
+        const Region region({}, {d->levelWidth(level), d->levelHeight(level), d->levelDepth(level)});
+        for (size_type layer = 0; layer < d->layers; ++layer) {
+            for (size_type face = 0; face < d->faces; ++face)
+                fill(region, {Side(face), level, layer}, color);
+        }
+    }
+}
+
+/*!
+  \brief Fills the \a region of the image at the given \a index with the given \a color.
+
+  The color is converted to the texture format only once, so this function is much faster than
+  calling setTexelColor() for each texel.
+
+  \note This function does nothing for compressed formats and logs a warning
+*/
+void Texture::fill(Texture::Region region, Texture::ArrayIndex index, const ColorVariant &color)
+{
+    if (!d)
+        return;
+
+    const auto writer = TextureData::getFormatWriter(d->format);
+    if (!writer) {
+        qCWarning(texture) << "fill() is not supported for format" << d->format;
+        return;
+    }
+
+    if (!region.isValid()) {
+        qCWarning(texture) << "fill() was called with an invalid region";
+        return;
+    }
+
+    const auto span = imageSpan(index).subSpan(
+            region.position.x, region.position.y, region.position.z,
+            region.size.width, region.size.height, region.size.depth);
+    if (span.isNull()) {
+        qCWarning(texture) << "Region is out of bounds";
+        return;
+    }
+
+    const auto bytesPerTexel = span.bytesPerTexel();
+    std::vector<uchar> texel(static_cast<size_t>(bytesPerTexel));
+    writer({texel.data(), bytesPerTexel}, color);
+
+    const auto isSameByte = std::all_of(texel.begin(), texel.end(), [&texel](uchar value)
+    {
+        return value == texel.front();
+    });
+
+    const auto lineSize = size_t(span.lineSize());
+    const uchar *pattern = nullptr;
+    for (const auto line: span) {
+        if (isSameByte) {
+            memset(line.data(), texel.front(), lineSize);
+        } else if (pattern) {
+            memcpy(line.data(), pattern, lineSize);
+        } else {
+            // replicate the texel doubling the copied block each time
+            memcpy(line.data(), texel.data(), texel.size());
+            for (auto filled = texel.size(); filled < lineSize; filled *= 2)
+                memcpy(line.data() + filled, line.data(), std::min(filled, lineSize - filled));
+            pattern = line.data();
+        }
+    }
+}
+
+/*!
+  \brief Sets all bytes of this texture to zero.
+
+  If the data is shared with other textures or an external owner, it is not copied; this texture
+  gets new storage with the same layout instead.
+*/
+void Texture::clear()
+{
+    if (!d)
+        return;
+
+    if (d->ref.load() != 1 || d->ro_data) {
+        *this = Texture(
+                TextureData::create(
+                        d->format,
+                        d->width, d->height, d->depth,
+                        d->faces == 6, d->levels, d->layers,
+                        d->align));
+        // In case we ran out of memory...
+        if (!d)
+            return;
+    }
+
+    const auto data = this->data();
+    memset(data.data(), 0, size_t(data.size()));
+}
+
 /*!
   \brief Converts this texture to a texture with the given \a alignment.
 
@@ -1103,8 +1649,8 @@ Texture Texture::convert(TextureFormat format, Texture::Alignment align) const
     if (result.isNull()) // allocation failed
         return Texture();
 
-    decltype(TextureData::getFormatReader(d->format)) reader;
-    decltype(TextureData::getFormatWriter(format)) writer;
+    FormatReader reader;
+    FormatWriter writer;
 
     if (format != d->format) {
         reader = TextureData::getFormatReader(d->format);
@@ -1124,44 +1670,11 @@ Texture Texture::convert(TextureFormat format, Texture::Alignment align) const
             return *this;
     }
 
-    const auto srcBytesPerTexel = this->bytesPerTexel();
-    const auto dstBytesPerTexel = result.bytesPerTexel();
-
-    const auto convertLine = [&](size_type width, ConstData srcLine, Data dstLine)
-    {
-        if (format != d->format) {
-            Q_ASSERT(srcBytesPerTexel && dstBytesPerTexel);
-            for (size_type x = 0; x < width; ++x) {
-                const auto src = srcLine.subspan(srcBytesPerTexel * x, srcBytesPerTexel);
-                const auto dst = dstLine.subspan(dstBytesPerTexel * x, dstBytesPerTexel);
-                writer(dst, reader(src));
-            }
-        } else { // ok, only alingment changed, fast copy
-            memoryCopy(dstLine, srcLine);
-        }
-    };
-
     for (size_type level = 0; level < d->levels; ++level) {
-        const auto srcBytesPerSlice = d->bytesPerSlice(level);
-        const auto dstBytesPerSlice = result.d->bytesPerSlice(level);
-        const auto srcBytesPerLine = d->bytesPerLine(level);
-        const auto dstBytesPerLine = result.d->bytesPerLine(level);
         for (size_type layer = 0; layer < d->layers; ++layer) {
             for (size_type face = 0; face < d->faces; ++face) {
-                const auto srcData = imageData({Side(face), level, layer});
-                const auto dstData = result.imageData({Side(face), level, layer});
-                const auto width = d->levelWidth(level);
-                const auto height = d->levelHeight(level);
-                const auto depth = d->levelDepth(level);
-                for (size_type z = 0; z < depth; ++z) {
-                    for (size_type y = 0; y < height; ++y) {
-                        const auto srcLine = srcData.subspan(
-                                    srcBytesPerSlice * z + srcBytesPerLine * y, srcBytesPerLine);
-                        const auto dstLine = dstData.subspan(
-                                    dstBytesPerSlice * z + dstBytesPerLine * y, dstBytesPerLine);
-                        convertLine(width, srcLine, dstLine);
-                    }
-                }
+                const ArrayIndex index(Side(face), level, layer);
+                convertSpan(constImageSpan(index), result.imageSpan(index), reader, writer);
             }
         }
     }
@@ -1185,12 +1698,388 @@ Texture Texture::copy() const
 
     Q_ASSERT(result.d->nbytes == d->nbytes);
     memoryCopy(result.data(), data());
+    result.d->hash.storeRelease(d->hash.loadAcquire());
+
+    return result;
+}
+
+/*!
+  \brief Returns a copy of this texture scaled to the given \a size using the \a filter.
+
+  Only the first level of each face and layer is resized, the resulting texture has no mipmaps;
+  use generateMipmaps() to rebuild them. Colors of sRGB formats are filtered in the linear space.
+
+  Images are resized with separate horizontal and vertical passes using precomputed filter
+  weights, each pass is split into bands of rows that are processed in parallel. When
+  downscaling by more than 4 times, the image is first halved with the box filter, so the cost
+  does not grow with the scale factor.
+
+  Compressed formats are not supported, null texture is returned in that case.
+*/
+Texture Texture::resized(Size size, Filter filter) const
+{
+    if (!d)
+        return Texture();
+
+    if (!size.isValid()) {
+        qCWarning(texture) << "resized() was called with an invalid size";
+        return Texture();
+    }
+
+    if (d->compressed) {
+        qCWarning(texture) << "resized() is not supported for compressed format" << d->format;
+        return Texture();
+    }
+
+    const auto ioFormat = Private::linearFormat(d->format);
+    const auto gamma = ioFormat != d->format;
+    const auto reader = TextureData::getRowReader(ioFormat);
+    const auto writer = TextureData::getRowWriter(ioFormat);
+    if (!reader || !writer) {
+        qCWarning(texture) << "resized() is not supported for format" << d->format;
+        return Texture();
+    }
+
+    Texture result(
+            d->format,
+            size,
+            {d->faces == 6 ? IsCubemap::Yes : IsCubemap::No, 1, d->layers},
+            d->align);
+    if (result.isNull()) // invalid size for a cubemap or allocation failed
+        return Texture();
+
+    for (size_type layer = 0; layer < d->layers; ++layer) {
+        for (size_type face = 0; face < d->faces; ++face) {
+            const ArrayIndex index(Side(face), 0, layer);
+            auto image = Private::FloatImage::fromSpan(constImageSpan(index), reader);
+            if (gamma)
+                Private::srgbToLinear(image);
+            image = Private::prefiltered(std::move(image), size);
+            image = Private::resampled(std::move(image), size, filter, Private::EdgeMode::Clamp);
+            if (gamma)
+                Private::linearToSrgb(image);
+            image.toSpan(result.imageSpan(index), writer);
+        }
+    }
+
+    return result;
+}
+
+/*!
+  \enum Texture::Filter
+  This enum describes the filter used to downsample images
+
+  \var Texture::Filter Texture::Box
+  Averages texels covered by the destination texel, fast but blurry
+
+  \var Texture::Filter Texture::Kaiser
+  Kaiser-windowed sinc, sharp with little ringing
+
+  \var Texture::Filter Texture::Lanczos
+  Lanczos-3 windowed sinc, the sharpest filter
+*/
+
+/*!
+  \enum Texture::MipmapOption
+  This enum describes options of the mipmap generation
+
+  \var Texture::MipmapOption Texture::NoOptions
+  Edges are clamped, colors are filtered as is
+
+  \var Texture::MipmapOption Texture::WrapEdges
+  Texels from the opposite edge are used when filtering edges, use for tiling textures
+
+  \var Texture::MipmapOption Texture::SrgbGamma
+  Colors are converted to linear space before filtering. This option is always enabled for
+  sRGB formats
+
+  \var Texture::MipmapOption Texture::PreserveAlphaCoverage
+  Alpha of each level is scaled so that the fraction of texels with alpha greater than 0.5 matches
+  the first level. This prevents alpha-tested geometry such as foliage from thinning out in the
+  distance
+*/
+
+/*!
+  \brief Returns a copy of this texture with a full mipmap chain generated from the first level.
+
+  Images are downsampled in the floating point space using the separable \a filter, each pass is
+  split into bands of rows that are processed in parallel. Each level is filtered from the
+  previous one.
+
+  Compressed formats are not supported, null texture is returned in that case.
+*/
+Texture Texture::generateMipmaps(Filter filter, MipmapOptions options) const
+{
+    if (!d)
+        return Texture();
+
+    if (d->compressed) {
+        qCWarning(texture) << "generateMipmaps() is not supported for compressed format"
+                           << d->format;
+        return Texture();
+    }
+
+    const auto ioFormat = Private::linearFormat(d->format);
+    if (ioFormat != d->format)
+        options |= MipmapOption::SrgbGamma;
+
+    const auto reader = TextureData::getRowReader(ioFormat);
+    const auto writer = TextureData::getRowWriter(ioFormat);
+    if (!reader || !writer) {
+        qCWarning(texture) << "generateMipmaps() is not supported for format" << d->format;
+        return Texture();
+    }
+
+    const auto maxSize = std::max({d->width, d->height, d->depth});
+    size_type levels = 1;
+    while (maxSize >> levels)
+        ++levels;
+
+    Texture result(
+            d->format,
+            size(),
+            {d->faces == 6 ? IsCubemap::Yes : IsCubemap::No, levels, d->layers},
+            d->align);
+    if (result.isNull()) // allocation failed
+        return Texture();
+
+    const auto edgeMode = options.testFlag(MipmapOption::WrapEdges)
+            ? Private::EdgeMode::Wrap
+            : Private::EdgeMode::Clamp;
+    const auto gamma = options.testFlag(MipmapOption::SrgbGamma);
+    const auto preserveCoverage = options.testFlag(MipmapOption::PreserveAlphaCoverage);
+    constexpr auto alphaReference = 0.5f;
+
+    for (size_type layer = 0; layer < d->layers; ++layer) {
+        for (size_type face = 0; face < d->faces; ++face) {
+            const ArrayIndex index(Side(face), 0, layer);
+            result.copyRegion(*this, index, {{}, size()}, index, {});
+
+            auto image = Private::FloatImage::fromSpan(constImageSpan(index), reader);
+            const auto coverage = preserveCoverage
+                    ? Private::alphaCoverage(image, alphaReference)
+                    : 0.0f;
+            if (gamma)
+                Private::srgbToLinear(image);
+
+            for (size_type level = 1; level < levels; ++level) {
+                image = Private::resampled(
+                        std::move(image), result.size(level), filter, edgeMode);
+
+                // the next level is resampled from the unmodified image, so only copy it if the
+                // output is adjusted
+                if (!preserveCoverage && !gamma) {
+                    image.toSpan(result.imageSpan({Side(face), level, layer}), writer);
+                    continue;
+                }
+
+                auto output = image;
+                if (preserveCoverage) {
+                    const auto scale = Private::findAlphaScale(output, coverage, alphaReference);
+                    Private::scaleAlpha(output, scale);
+                }
+                if (gamma)
+                    Private::linearToSrgb(output);
+                output.toSpan(result.imageSpan({Side(face), level, layer}), writer);
+            }
+        }
+    }
+
+    return result;
+}
+
+/*!
+  \brief Returns a copy of this texture mirrored in the given \a orientations.
+
+  Qt::Vertical flips images upside down, which converts between the bottom-left origin used by
+  OpenGL and KTX and the top-left origin used by Direct3D and DDS. All faces, levels and layers
+  are flipped; slices of volume textures are flipped individually.
+
+  Lines are swapped and reversed in place in the copy. Images of BC1-BC5 compressed formats are
+  flipped without decoding by reordering blocks and rewriting index bits inside each block; this
+  requires the flipped dimension of each level to be a multiple of 4 or less than 4. Other
+  compressed formats are not supported, null texture is returned in that case.
+*/
+Texture Texture::flipped(Qt::Orientations orientations) const
+{
+    if (!d)
+        return Texture();
+
+    if (!Private::canTransform(d->format)) {
+        qCWarning(texture) << "flipped() is not supported for format" << d->format;
+        return Texture();
+    }
+
+    if (!canFlipLevels(*this, orientations)) {
+        qCWarning(texture) << "flipped() requires block-aligned dimensions for compressed format"
+                           << d->format;
+        return Texture();
+    }
+
+    auto result = copy();
+    if (result.isNull()) // allocation failed
+        return Texture();
+
+    flipImages(result, orientations);
+    return result;
+}
+
+/*!
+  \brief Returns a copy of this texture with rows and columns of each image swapped.
+
+  The width and the height of the result are swapped, the other dimensions are preserved. Images
+  are copied in square tiles, so both the source and the destination memory stay in the cache.
+  Images of BC1-BC5 compressed formats are transposed without decoding; other compressed formats
+  are not supported, null texture is returned in that case.
+*/
+Texture Texture::transposed() const
+{
+    if (!d)
+        return Texture();
+
+    if (!Private::canTransform(d->format)) {
+        qCWarning(texture) << "transposed() is not supported for format" << d->format;
+        return Texture();
+    }
+
+    Texture result(
+            d->format,
+            {d->height, d->width, d->depth},
+            {d->faces == 6 ? IsCubemap::Yes : IsCubemap::No, d->levels, d->layers},
+            d->align);
+    if (result.isNull()) // allocation failed
+        return Texture();
+
+    for (size_type layer = 0; layer < d->layers; ++layer) {
+        for (size_type level = 0; level < d->levels; ++level) {
+            for (size_type face = 0; face < d->faces; ++face) {
+                const ArrayIndex index(Side(face), level, layer);
+                Private::transpose(constImageSpan(index), result.imageSpan(index));
+            }
+        }
+    }
+
+    return result;
+}
+
+/*!
+  \enum Texture::Rotation
+  This enum describes the clockwise rotation of images
+
+  \var Texture::Rotation Texture::Rotate90
+  Images are rotated by 90 degrees, the width and the height are swapped
+
+  \var Texture::Rotation Texture::Rotate180
+  Images are rotated by 180 degrees
+
+  \var Texture::Rotation Texture::Rotate270
+  Images are rotated by 270 degrees, the width and the height are swapped
+*/
 
+/*!
+  \brief Returns a copy of this texture with each image rotated clockwise by the \a rotation.
+
+  The rotation is performed as a transpose followed by a flip in place, so the same formats and
+  dimensions as for transposed() and flipped() are supported.
+*/
+Texture Texture::rotated(Rotation rotation) const
+{
+    if (rotation == Rotation::Rotate180)
+        return flipped(Qt::Horizontal | Qt::Vertical);
+
+    if (!d)
+        return Texture();
+
+    const auto orientations = rotation == Rotation::Rotate90 ? Qt::Horizontal : Qt::Vertical;
+    auto result = transposed();
+    if (result.isNull())
+        return Texture();
+
+    if (!canFlipLevels(result, orientations)) {
+        qCWarning(texture) << "rotated() requires block-aligned dimensions for compressed format"
+                           << d->format;
+        return Texture();
+    }
+
+    flipImages(result, orientations);
     return result;
 }
 
+/*!
+  \enum Texture::SwizzleValue
+  This enum describes the source of a channel in swizzled()
+
+  \var Texture::SwizzleValue Texture::Red
+  The red channel of the source
+
+  \var Texture::SwizzleValue Texture::Green
+  The green channel of the source
+
+  \var Texture::SwizzleValue Texture::Blue
+  The blue channel of the source
+
+  \var Texture::SwizzleValue Texture::Alpha
+  The alpha channel of the source
+
+  \var Texture::SwizzleValue Texture::Zero
+  The channel is set to 0
+
+  \var Texture::SwizzleValue Texture::One
+  The channel is set to the maximum value, i.e. 1 for normalized formats
+*/
+
+/*!
+  \brief Returns a copy of this texture with channels rearranged according to the \a swizzle.
+
+  Each element of the \a swizzle is the source of the red, green, blue and alpha channel
+  respectively, e.g. {Zero, Zero, Red, Green} moves the red and green channels to the blue and
+  alpha ones. The format is preserved, so channels missing in the format are dropped and read as
+  0 for colors and as 1 for the alpha.
+
+  8-bit RGBA and BGRA formats are processed directly in the texture memory, other formats are
+  decoded line by line. All faces, levels and layers are processed; compressed formats are not
+  supported, null texture is returned in that case.
+*/
+Texture Texture::swizzled(const Swizzle &swizzle) const
+{
+    const Private::RowOperation operations[] = {Private::swizzleOperation(swizzle)};
+    return Private::applied(*this, operations, "swizzled()");
+}
+
+/*!
+  \brief Returns a copy of this texture with color channels multiplied by the alpha.
+
+  Filtering premultiplied colors, e.g. with generateMipmaps(), prevents colors of transparent
+  texels from bleeding into opaque ones. Values are processed as stored, colors of sRGB formats
+  are not linearized.
+
+  Compressed formats are not supported, null texture is returned in that case.
+*/
+Texture Texture::premultiplied() const
+{
+    const Private::RowOperation operations[] = {Private::premultiplyOperation()};
+    return Private::applied(*this, operations, "premultiplied()");
+}
+
+/*!
+  \brief Returns a copy of this texture with color channels divided by the alpha.
+
+  This is the inverse of premultiplied(); colors of fully transparent texels are set to 0.
+  Precision of 8-bit formats is lost for texels with a small alpha.
+
+  Compressed formats are not supported, null texture is returned in that case.
+*/
+Texture Texture::unpremultiplied() const
+{
+    const Private::RowOperation operations[] = {Private::unpremultiplyOperation()};
+    return Private::applied(*this, operations, "unpremultiplied()");
+}
+
 /*!
   \brief Converts this texture to a QImage.
+
+  Only the first level of the first layer is converted. Use toImage(ArrayIndex, size_type) to
+  convert other subresources, faces of cubemaps or slices of volume textures.
 */
 QImage Texture::toImage() const
 {
@@ -1202,49 +2091,65 @@ QImage Texture::toImage() const
         return {};
     }
 
+    return toImage({}, 0);
+}
+
+/*!
+  \brief Converts the \a slice of the image at the given \a index to a QImage.
+
+  If the texture format has the same memory layout as one of QImage formats, the returned image
+  wraps the texture data without copying; the image keeps a reference to the texture data and
+  copies it on the first write access. Otherwise, texels are converted directly into the scanlines
+  of the result image, no intermediate texture is created.
+*/
+QImage Texture::toImage(ArrayIndex index, size_type slice) const
+{
+    if (!d)
+        return {};
+
+    const auto image = constImageSpan(index);
+    if (image.isNull())
+        return {};
+
+    const auto source = image.slice(slice);
+    if (source.isNull()) {
+        qCWarning(texture) << "Can't convert to QImage: slice" << slice << "is out of bounds";
+        return {};
+    }
+
     if (isCompressed()) {
         qCWarning(texture) << "Can't convert to QImage: compressed images are not supported";
         return {};
     }
 
-    Texture copy;
-    QImage::Format imageFormat = QImage::Format_Invalid;
-    switch (d->format) {
-    case TextureFormat::A8_Unorm:
-        imageFormat = QImage::Format_Alpha8;
-        copy = convert(Alignment::Word);
-        break;
-    case TextureFormat::L8_Unorm:
-        imageFormat = QImage::Format_Grayscale8;
-        copy = convert(Alignment::Word);
-        break;
-    case TextureFormat::R8_Unorm:
-    case TextureFormat::R16_Unorm:
-    case TextureFormat::R16_Float:
-    case TextureFormat::RG8_Unorm:
-    case TextureFormat::RGB8_Unorm:
-    case TextureFormat::BGR8_Unorm:
-    case TextureFormat::R32_Float:
-    case TextureFormat::RG16_Unorm:
-    case TextureFormat::RG16_Float:
-    case TextureFormat::RGBX8_Unorm:
-    case TextureFormat::BGRX8_Unorm:
-    case TextureFormat::RG32_Float:
-        imageFormat = QImage::Format_RGB888;
-        copy = convert(TextureFormat::RGB8_Unorm, Alignment::Word);
-        break;
-    case TextureFormat::LA8_Unorm:
-    case TextureFormat::RGBA8_Unorm:
-    case TextureFormat::BGRA8_Unorm:
-    case TextureFormat::ABGR8_Unorm:
-    case TextureFormat::RGBA16_Unorm:
-    case TextureFormat::RGBA16_Float:
-    case TextureFormat::RGBA32_Float:
-        imageFormat = QImage::Format_RGBA8888;
-        copy = convert(TextureFormat::RGBA8_Unorm, Alignment::Word);
-        break;
-    default:
-        break;
+    auto imageFormat = mappedImageFormat(d->format);
+    auto textureFormat = d->format;
+    if (imageFormat == QImage::Format_Invalid) {
+        switch (d->format) {
+        case TextureFormat::R8_Unorm:
+        case TextureFormat::R16_Unorm:
+        case TextureFormat::R16_Float:
+        case TextureFormat::RG8_Unorm:
+        case TextureFormat::BGR8_Unorm:
+        case TextureFormat::R32_Float:
+        case TextureFormat::RG16_Unorm:
+        case TextureFormat::RG16_Float:
+        case TextureFormat::BGRX8_Unorm:
+        case TextureFormat::RG32_Float:
+            imageFormat = QImage::Format_RGB888;
+            textureFormat = TextureFormat::RGB8_Unorm;
+            break;
+        case TextureFormat::LA8_Unorm:
+        case TextureFormat::BGRA8_Unorm:
+        case TextureFormat::ABGR8_Unorm:
+        case TextureFormat::RGBA16_Float:
+        case TextureFormat::RGBA32_Float:
+            imageFormat = QImage::Format_RGBA8888;
+            textureFormat = TextureFormat::RGBA8_Unorm;
+            break;
+        default:
+            break;
+        }
     }
 
     if (imageFormat == QImage::Format_Invalid) {
@@ -1253,37 +2158,87 @@ QImage Texture::toImage() const
         return {};
     }
 
-    if (d->width > std::numeric_limits<int>::max()) {
+    if (source.width() > std::numeric_limits<int>::max()) {
         qCWarning(texture)
-                << "Can't convert to QImage: width is bigger than max_int: " << int(d->width);
+                << "Can't convert to QImage: width is bigger than max_int: " << source.width();
         return {};
     }
-    if (d->height > std::numeric_limits<int>::max()) {
+    if (source.height() > std::numeric_limits<int>::max()) {
         qCWarning(texture)
-                << "Can't convert to QImage: height is bigger than max_int: " << int(d->height);
+                << "Can't convert to QImage: height is bigger than max_int: " << source.height();
         return {};
     }
 
-    QImage result(int(d->width), int(d->height), imageFormat);
+    // QImage requires 32-bit aligned scanlines to wrap the data
+    const auto isAligned = source.bytesPerLine() % 4 == 0 && quintptr(source.data()) % 4 == 0;
+    if (textureFormat == d->format && isAligned) {
+        return QImage(
+                source.data(),
+                int(source.width()),
+                int(source.height()),
+                int(source.bytesPerLine()),
+                imageFormat,
+                [](void *info) { delete static_cast<Texture *>(info); },
+                new Texture(*this));
+    }
+
+    QImage result(int(source.width()), int(source.height()), imageFormat);
     if (result.isNull()) {
         qCWarning(texture) << "Can't convert to QImage: can't create image";
         return {};
     }
 
-    const auto bytesPerLine = copy.bytesPerLine();
-    if (result.bytesPerLine() < bytesPerLine) {
-        qCWarning(texture) << "Can't convert to QImage:"
-                           << "image line size is less than texture line size"
-                           << result.bytesPerLine() << "<" << bytesPerLine;
-        return {};
+    FormatReader reader;
+    FormatWriter writer;
+    if (textureFormat != d->format) {
+        reader = TextureData::getFormatReader(d->format);
+        writer = TextureData::getFormatWriter(textureFormat);
+        if (!reader || !writer) {
+            qCWarning(texture)
+                    << "Can't convert to QImage: unsupported texture format" << toQString(d->format);
+            return {};
+        }
     }
 
-    const auto data = copy.imageData({});
-    for (int y = 0; y < d->height; ++y) {
-        const auto line = data.subspan(bytesPerLine * y, bytesPerLine);
-        memoryCopy({result.scanLine(y), result.bytesPerLine()}, line);
-    }
+    // convert directly into the image scanlines, no intermediate texture is needed
+    const TextureSpan dst(
+            result.bits(),
+            textureFormat,
+            source.width(), source.height(), 1,
+            result.bytesPerLine(), result.sizeInBytes());
+    convertSpan(source, dst, reader, writer);
+
+    return result;
+}
+
+/*!
+  \brief Constructs a read-only texture with the given \a data, \a deleter, \a format, \a size, \a dimensions and \a align.
+
+  Like the constructor that takes mutable data, this function doesn't allocate memory but uses the
+  given \a data. The data is never modified, it is copied on the first write access instead.
 
+  The \a deleter is called when the data is no longer used, it can hold a reference to the owner
+  of the data to keep it alive while the texture is.
+
+  \sa isNull()
+*/
+Texture Texture::fromRawData(
+        ConstData data,
+        DataDeleter deleter,
+        TextureFormat format,
+        Size size,
+        ArraySize dimensions,
+        Alignment align)
+{
+    auto result = Texture(
+            Data(const_cast<uchar *>(data.data()), data.size()),
+            std::move(deleter),
+            format,
+            size,
+            dimensions,
+            align);
+    if (result.d)
+        result.d->ro_data = true;
     return result;
 }
 
@@ -1313,7 +2268,7 @@ Texture::Texture(TextureData *dd)
 void Texture::detach()
 {
     if (d) {
-        if (d->ref.load() != 1 /*|| d->ro_data*/)
+        if (d->ref.load() != 1 || d->ro_data)
             *this = copy();
     }
 }
@@ -1338,6 +2293,9 @@ uchar *Texture::dataImpl(size_type side, size_type level, size_type layer)
     if (!d)
         return nullptr;
 
+    // data can be modified via returned pointer
+    d->invalidateHash();
+
     return d->data.get() + d->offset(side, level, layer);
 }
 
@@ -1372,6 +2330,12 @@ bool operator==(const Texture &lhs, const Texture &rhs)
             || lhs.d->levels != rhs.d->levels)
         return false;
 
+    // hashing both textures costs more than comparing them, so only use hashes that are cached
+    const auto lhsHash = lhs.d->cachedHash();
+    const auto rhsHash = rhs.d->cachedHash();
+    if (lhsHash && rhsHash && lhsHash != rhsHash)
+        return false;
+
     return memoryCompare({lhs.d->data.get(), lhs.d->nbytes}, {rhs.d->data.get(), rhs.d->nbytes}) == 0;
 }
 
@@ -7,6 +7,7 @@
 #include <TextureLib/TextureFormat>
 #include <TextureLib/TextureFormatInfo>
 #include <TextureLib/TextureIOResult>
+#include <TextureLib/TextureSpan>
 
 #include <QtCore/QDataStream>
 #include <QtCore/QLoggingCategory>
@@ -15,6 +16,8 @@
 
 #include <gsl/span>
 
+#include <array>
+
 #include <Expected>
 
 class TextureData;
@@ -46,6 +49,41 @@ public:
         Yes
     };
 
+    enum class Filter {
+        Box,
+        Kaiser,
+        Lanczos,
+    };
+    Q_ENUM(Filter)
+
+    enum class MipmapOption {
+        NoOptions = 0x0,
+        WrapEdges = 0x1,
+        SrgbGamma = 0x2,
+        PreserveAlphaCoverage = 0x4,
+    };
+    using MipmapOptions = QFlags<MipmapOption>;
+    Q_FLAG(MipmapOptions)
+
+    enum class Rotation {
+        Rotate90,
+        Rotate180,
+        Rotate270,
+    };
+    Q_ENUM(Rotation)
+
+    enum class SwizzleValue {
+        Red,
+        Green,
+        Blue,
+        Alpha,
+        Zero,
+        One,
+    };
+    Q_ENUM(SwizzleValue)
+    // sources of the red, green, blue and alpha channels
+    using Swizzle = std::array<SwizzleValue, 4>;
+
     struct Size
     {
     public:
@@ -81,6 +119,20 @@ public:
         size_type z {0};
     };
 
+    struct Region
+    {
+        constexpr Region() noexcept = default;
+        constexpr Region(Position position, Size size) noexcept
+            : position(position), size(size) {}
+        constexpr Region(QRect rect, size_type z = 0) noexcept
+            : position(rect.topLeft(), z), size(rect.size()) {}
+
+        constexpr bool isValid() const noexcept { return position.isValid() && size.isValid(); }
+
+        Position position;
+        Size size;
+    };
+
     class ArraySize
     {
     public:
@@ -222,6 +274,8 @@ public:
     qsizetype bytesPerSlice(size_type level = 0) const;
     qsizetype bytesPerImage(size_type level = 0) const;
 
+    quint64 contentHash() const;
+
     Data imageData(ArrayIndex index);
     ConstData imageData(ArrayIndex index) const;
     ConstData constImageData(ArrayIndex index) const;
@@ -235,14 +289,29 @@ public:
     { setTexelColor(p, {}, color); }
     void setTexelColor(Position p, ArrayIndex index, const ColorVariant &color);
 
-    // Ok, KTX really have different alignment (4) rather than other (dds, vtf) formats (1).
-    // So, we can have a usage of a scanline API.
-    // However, the same can be achieved via manual iteration over imageData, hovewer that can
-    // lead to a bunch of a boilerplate code - see convert(TextureFormat, Alignment) function.
+    bool readRow(Position p, ArrayIndex index, gsl::span<Rgba128Float> colors) const;
+    bool writeRow(Position p, ArrayIndex index, gsl::span<const Rgba128Float> colors);
+    bool readRegion(Region region, ArrayIndex index, gsl::span<Rgba128Float> colors) const;
+    bool writeRegion(Region region, ArrayIndex index, gsl::span<const Rgba128Float> colors);
+
+    TextureSpan imageSpan(ArrayIndex index);
+    ConstTextureSpan imageSpan(ArrayIndex index) const;
+    ConstTextureSpan constImageSpan(ArrayIndex index) const;
 
-    // Data lineData(const Position &p, const Index &index);
-    // ConstData lineData(const Position &p, const Index &index) const;
-    // ConstData constLineData(const Position &p, const Index &index) const;
+    // Ok, KTX really have different alignment (4) rather than other (dds, vtf) formats (1).
+    // So, we have a scanline API that hides the padding.
+    Data lineData(Position p, ArrayIndex index);
+    ConstData lineData(Position p, ArrayIndex index) const;
+    ConstData constLineData(Position p, ArrayIndex index) const;
+
+    bool copyRegion(const Texture &source,
+                    ArrayIndex sourceIndex,
+                    Region sourceRegion,
+                    ArrayIndex index,
+                    Position position);
+    void fill(const ColorVariant &color);
+    void fill(Region region, ArrayIndex index, const ColorVariant &color);
+    void clear();
 
     Texture convert(Alignment align) const;
     Texture convert(TextureFormat format) const;
@@ -251,10 +320,32 @@ public:
 
     Texture copy() const;
 
+    Texture resized(Size size, Filter filter = Filter::Box) const;
+    Texture generateMipmaps(
+            Filter filter = Filter::Box,
+            MipmapOptions options = MipmapOption::NoOptions) const;
+
+    Texture flipped(Qt::Orientations orientations = Qt::Vertical) const;
+    Texture transposed() const;
+    Texture rotated(Rotation rotation) const;
+
+    Texture swizzled(const Swizzle &swizzle) const;
+    Texture premultiplied() const;
+    Texture unpremultiplied() const;
+
     QImage toImage() const;
+    QImage toImage(ArrayIndex index, size_type slice = 0) const;
 
     TextureIOResult save(const QString &file);
     TextureIOResult save(QStringView file) { return save(file.toString()); }
+    static Texture fromRawData(
+            ConstData data,
+            DataDeleter deleter,
+            TextureFormat format,
+            Size size,
+            ArraySize dimensions = {1, 1},
+            Alignment align = Alignment::Byte);
+
     using ReadResult = Expected<Texture, TextureIOError>;
     static ReadResult load(const QString &file);
     static ReadResult load(QStringView file) { return load(file.toString()); }
@@ -277,6 +368,8 @@ private:
     friend QDataStream TEXTURELIB_EXPORT &operator >>(QDataStream &stream, Texture &texture);
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(Texture::MipmapOptions)
+
 bool TEXTURELIB_EXPORT operator==(const Texture &lhs, const Texture &rhs);
 bool TEXTURELIB_EXPORT operator!=(const Texture &lhs, const Texture &rhs);
 
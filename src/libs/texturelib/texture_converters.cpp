@@ -9,12 +9,16 @@ namespace {
 
 using ReaderFunc = ColorVariant(*)(Texture::ConstData);
 using WriterFunc = void(*)(Texture::Data, const ColorVariant &);
+using RowReaderFunc = void(*)(Texture::ConstData, gsl::span<Rgba128Float>);
+using RowWriterFunc = void(*)(gsl::span<const Rgba128Float>, Texture::Data);
 
 struct TextureFormatConverter
 {
     TextureFormat format {TextureFormat::Invalid};
     ReaderFunc reader {nullptr};
     WriterFunc writer {nullptr};
+    RowReaderFunc rowReader {nullptr};
+    RowWriterFunc rowWriter {nullptr};
 };
 
 using TextureFormatConverters = gsl::span<const TextureFormatConverter>;
@@ -59,6 +63,44 @@ void writeRGBA(Texture::Data data, const ColorVariant &color)
         d[3] = Type(getAlpha(rgba));
 }
 
+template<typename Type, size_t components>
+void readRowRGBA(Texture::ConstData data, gsl::span<Rgba128Float> result)
+{
+    static_assert (components >= 1 && components <= 4, "Invalid components count");
+    Q_ASSERT(data.size() == result.size() * qsizetype(components * sizeof(Type)));
+    const auto channel = [](Type value) { return Private::convertChannel<float, Type>(value); };
+    auto d = reinterpret_cast<const Type *>(data.data());
+    for (auto &color: result) {
+        color = {
+            channel(d[0]),
+            components >= 2 ? channel(d[1]) : 0.0f,
+            components >= 3 ? channel(d[2]) : 0.0f,
+            components >= 4 ? channel(d[3]) : 1.0f
+        };
+        d += components;
+    }
+}
+
+template<typename Type, size_t components>
+void writeRowRGBA(gsl::span<const Rgba128Float> colors, Texture::Data data)
+{
+    static_assert (components >= 1 && components <= 4, "Invalid components count");
+    Q_ASSERT(data.size() == colors.size() * qsizetype(components * sizeof(Type)));
+    const auto channel = [](float value) { return Private::convertChannel<Type, float>(value); };
+    auto d = reinterpret_cast<Type *>(data.data());
+    for (const auto &color: colors) {
+        if (components >= 1)
+            d[0] = channel(color.red());
+        if (components >= 2)
+            d[1] = channel(color.green());
+        if (components >= 3)
+            d[2] = channel(color.blue());
+        if (components >= 4)
+            d[3] = channel(color.alpha());
+        d += components;
+    }
+}
+
 // specialized functions
 
 ColorVariant readA8_Unorm(Texture::ConstData data)
@@ -202,44 +244,70 @@ constexpr TextureFormatConverter converters[] = {
     { TextureFormat::A8_Unorm, readA8_Unorm, writeA8_Unorm },
     { TextureFormat::L8_Unorm, readL8_Unorm, writeL8_Unorm },
 
-    { TextureFormat::R8_Snorm, readRGBA<qint8,  1>, writeRGBA<qint8,  1> },
-    { TextureFormat::R8_Unorm, readRGBA<quint8, 1>, writeRGBA<quint8, 1> },
-    { TextureFormat::R8_Sint,  readRGBA<qint8,  1>, writeRGBA<qint8,  1> },
-    { TextureFormat::R8_Uint,  readRGBA<quint8, 1>, writeRGBA<quint8, 1> },
+    { TextureFormat::R8_Snorm, readRGBA<qint8,  1>, writeRGBA<qint8,  1>,
+      readRowRGBA<qint8,  1>, writeRowRGBA<qint8,  1> },
+    { TextureFormat::R8_Unorm, readRGBA<quint8, 1>, writeRGBA<quint8, 1>,
+      readRowRGBA<quint8, 1>, writeRowRGBA<quint8, 1> },
+    { TextureFormat::R8_Sint,  readRGBA<qint8,  1>, writeRGBA<qint8,  1>,
+      readRowRGBA<qint8,  1>, writeRowRGBA<qint8,  1> },
+    { TextureFormat::R8_Uint,  readRGBA<quint8, 1>, writeRGBA<quint8, 1>,
+      readRowRGBA<quint8, 1>, writeRowRGBA<quint8, 1> },
 
     // 16 bit
     { TextureFormat::LA8_Unorm, readLA8_Unorm, writeLA8_Unorm },
 
-    { TextureFormat::R16_Snorm, readRGBA<qint16,    1>, writeRGBA<qint16,    1> },
-    { TextureFormat::R16_Unorm, readRGBA<quint16,   1>, writeRGBA<quint16,   1> },
-    { TextureFormat::R16_Sint,  readRGBA<qint16,    1>, writeRGBA<qint16,    1> },
-    { TextureFormat::R16_Uint,  readRGBA<quint16,   1>, writeRGBA<quint16,   1> },
-    { TextureFormat::R16_Float, readRGBA<HalfFloat, 1>, writeRGBA<HalfFloat, 1> },
-
-    { TextureFormat::RG8_Snorm, readRGBA<qint8,  2>, writeRGBA<qint8,  2> },
-    { TextureFormat::RG8_Unorm, readRGBA<quint8, 2>, writeRGBA<quint8, 2> },
-    { TextureFormat::RG8_Sint,  readRGBA<qint8,  2>, writeRGBA<qint8,  2> },
-    { TextureFormat::RG8_Uint,  readRGBA<quint8, 2>, writeRGBA<quint8, 2> },
+    { TextureFormat::R16_Snorm, readRGBA<qint16,    1>, writeRGBA<qint16,    1>,
+      readRowRGBA<qint16,    1>, writeRowRGBA<qint16,    1> },
+    { TextureFormat::R16_Unorm, readRGBA<quint16,   1>, writeRGBA<quint16,   1>,
+      readRowRGBA<quint16,   1>, writeRowRGBA<quint16,   1> },
+    { TextureFormat::R16_Sint,  readRGBA<qint16,    1>, writeRGBA<qint16,    1>,
+      readRowRGBA<qint16,    1>, writeRowRGBA<qint16,    1> },
+    { TextureFormat::R16_Uint,  readRGBA<quint16,   1>, writeRGBA<quint16,   1>,
+      readRowRGBA<quint16,   1>, writeRowRGBA<quint16,   1> },
+    { TextureFormat::R16_Float, readRGBA<HalfFloat, 1>, writeRGBA<HalfFloat, 1>,
+      readRowRGBA<HalfFloat, 1>, writeRowRGBA<HalfFloat, 1> },
+
+    { TextureFormat::RG8_Snorm, readRGBA<qint8,  2>, writeRGBA<qint8,  2>,
+      readRowRGBA<qint8,  2>, writeRowRGBA<qint8,  2> },
+    { TextureFormat::RG8_Unorm, readRGBA<quint8, 2>, writeRGBA<quint8, 2>,
+      readRowRGBA<quint8, 2>, writeRowRGBA<quint8, 2> },
+    { TextureFormat::RG8_Sint,  readRGBA<qint8,  2>, writeRGBA<qint8,  2>,
+      readRowRGBA<qint8,  2>, writeRowRGBA<qint8,  2> },
+    { TextureFormat::RG8_Uint,  readRGBA<quint8, 2>, writeRGBA<quint8, 2>,
+      readRowRGBA<quint8, 2>, writeRowRGBA<quint8, 2> },
 
     // 24bit
-    { TextureFormat::RGB8_Unorm, readRGBA<quint8, 3>, writeRGBA<quint8, 3> },
+    { TextureFormat::RGB8_Unorm, readRGBA<quint8, 3>, writeRGBA<quint8, 3>,
+      readRowRGBA<quint8, 3>, writeRowRGBA<quint8, 3> },
     { TextureFormat::BGR8_Unorm, readBGR8_Unorm, writeBGR8_Unorm },
 
     // 32bit
-    { TextureFormat::R32_Sint,  readRGBA<qint32,  1>, writeRGBA<qint32,  1> },
-    { TextureFormat::R32_Uint,  readRGBA<quint32, 1>, writeRGBA<quint32, 1> },
-    { TextureFormat::R32_Float, readRGBA<float,   1>, writeRGBA<float,   1> },
-
-    { TextureFormat::RG16_Snorm, readRGBA<qint16,    2>, writeRGBA<qint16,    2> },
-    { TextureFormat::RG16_Unorm, readRGBA<quint16,   2>, writeRGBA<quint16,   2> },
-    { TextureFormat::RG16_Sint,  readRGBA<qint16,    2>, writeRGBA<qint16,    2> },
-    { TextureFormat::RG16_Uint,  readRGBA<quint16,   2>, writeRGBA<quint16,   2> },
-    { TextureFormat::RG16_Float, readRGBA<HalfFloat, 2>, writeRGBA<HalfFloat, 2> },
-
-    { TextureFormat::RGBA8_Snorm, readRGBA<qint8,  4>, writeRGBA<qint8,  4> },
-    { TextureFormat::RGBA8_Unorm, readRGBA<quint8, 4>, writeRGBA<quint8, 4> },
-    { TextureFormat::RGBA8_Sint,  readRGBA<qint8,  4>, writeRGBA<qint8,  4> },
-    { TextureFormat::RGBA8_Uint,  readRGBA<quint8, 4>, writeRGBA<quint8, 4> },
+    { TextureFormat::R32_Sint,  readRGBA<qint32,  1>, writeRGBA<qint32,  1>,
+      readRowRGBA<qint32,  1>, writeRowRGBA<qint32,  1> },
+    { TextureFormat::R32_Uint,  readRGBA<quint32, 1>, writeRGBA<quint32, 1>,
+      readRowRGBA<quint32, 1>, writeRowRGBA<quint32, 1> },
+    { TextureFormat::R32_Float, readRGBA<float,   1>, writeRGBA<float,   1>,
+      readRowRGBA<float,   1>, writeRowRGBA<float,   1> },
+
+    { TextureFormat::RG16_Snorm, readRGBA<qint16,    2>, writeRGBA<qint16,    2>,
+      readRowRGBA<qint16,    2>, writeRowRGBA<qint16,    2> },
+    { TextureFormat::RG16_Unorm, readRGBA<quint16,   2>, writeRGBA<quint16,   2>,
+      readRowRGBA<quint16,   2>, writeRowRGBA<quint16,   2> },
+    { TextureFormat::RG16_Sint,  readRGBA<qint16,    2>, writeRGBA<qint16,    2>,
+      readRowRGBA<qint16,    2>, writeRowRGBA<qint16,    2> },
+    { TextureFormat::RG16_Uint,  readRGBA<quint16,   2>, writeRGBA<quint16,   2>,
+      readRowRGBA<quint16,   2>, writeRowRGBA<quint16,   2> },
+    { TextureFormat::RG16_Float, readRGBA<HalfFloat, 2>, writeRGBA<HalfFloat, 2>,
+      readRowRGBA<HalfFloat, 2>, writeRowRGBA<HalfFloat, 2> },
+
+    { TextureFormat::RGBA8_Snorm, readRGBA<qint8,  4>, writeRGBA<qint8,  4>,
+      readRowRGBA<qint8,  4>, writeRowRGBA<qint8,  4> },
+    { TextureFormat::RGBA8_Unorm, readRGBA<quint8, 4>, writeRGBA<quint8, 4>,
+      readRowRGBA<quint8, 4>, writeRowRGBA<quint8, 4> },
+    { TextureFormat::RGBA8_Sint,  readRGBA<qint8,  4>, writeRGBA<qint8,  4>,
+      readRowRGBA<qint8,  4>, writeRowRGBA<qint8,  4> },
+    { TextureFormat::RGBA8_Uint,  readRGBA<quint8, 4>, writeRGBA<quint8, 4>,
+      readRowRGBA<quint8, 4>, writeRowRGBA<quint8, 4> },
     { TextureFormat::RGBA8_Srgb },
 
     { TextureFormat::BGRA8_Unorm, readBGRA8_Unorm, writeBGRA8_Unorm },
@@ -250,25 +318,39 @@ constexpr TextureFormatConverter converters[] = {
     { TextureFormat::BGRX8_Srgb },
 
     // 64bit
-    { TextureFormat::RGBA16_Snorm, readRGBA<qint16,    4>, writeRGBA<qint16,    4> },
-    { TextureFormat::RGBA16_Unorm, readRGBA<quint16,   4>, writeRGBA<quint16,   4> },
-    { TextureFormat::RGBA16_Sint,  readRGBA<qint16,    4>, writeRGBA<qint16,    4> },
-    { TextureFormat::RGBA16_Uint,  readRGBA<quint16,   4>, writeRGBA<quint16,   4> },
-    { TextureFormat::RGBA16_Float, readRGBA<HalfFloat, 4>, writeRGBA<HalfFloat, 4> },
-
-    { TextureFormat::RG32_Sint,  readRGBA<qint32,  2>, writeRGBA<qint32,  2> },
-    { TextureFormat::RG32_Uint,  readRGBA<quint32, 2>, writeRGBA<quint32, 2> },
-    { TextureFormat::RG32_Float, readRGBA<float,   2>, writeRGBA<float,   2> },
+    { TextureFormat::RGBA16_Snorm, readRGBA<qint16,    4>, writeRGBA<qint16,    4>,
+      readRowRGBA<qint16,    4>, writeRowRGBA<qint16,    4> },
+    { TextureFormat::RGBA16_Unorm, readRGBA<quint16,   4>, writeRGBA<quint16,   4>,
+      readRowRGBA<quint16,   4>, writeRowRGBA<quint16,   4> },
+    { TextureFormat::RGBA16_Sint,  readRGBA<qint16,    4>, writeRGBA<qint16,    4>,
+      readRowRGBA<qint16,    4>, writeRowRGBA<qint16,    4> },
+    { TextureFormat::RGBA16_Uint,  readRGBA<quint16,   4>, writeRGBA<quint16,   4>,
+      readRowRGBA<quint16,   4>, writeRowRGBA<quint16,   4> },
+    { TextureFormat::RGBA16_Float, readRGBA<HalfFloat, 4>, writeRGBA<HalfFloat, 4>,
+      readRowRGBA<HalfFloat, 4>, writeRowRGBA<HalfFloat, 4> },
+
+    { TextureFormat::RG32_Sint,  readRGBA<qint32,  2>, writeRGBA<qint32,  2>,
+      readRowRGBA<qint32,  2>, writeRowRGBA<qint32,  2> },
+    { TextureFormat::RG32_Uint,  readRGBA<quint32, 2>, writeRGBA<quint32, 2>,
+      readRowRGBA<quint32, 2>, writeRowRGBA<quint32, 2> },
+    { TextureFormat::RG32_Float, readRGBA<float,   2>, writeRGBA<float,   2>,
+      readRowRGBA<float,   2>, writeRowRGBA<float,   2> },
 
     // 96bit
-    { TextureFormat::RGB32_Sint,  readRGBA<qint32,  3>, writeRGBA<qint32,  3> },
-    { TextureFormat::RGB32_Uint,  readRGBA<quint32, 3>, writeRGBA<quint32, 3> },
-    { TextureFormat::RGB32_Float, readRGBA<float,   3>, writeRGBA<float,   3> },
+    { TextureFormat::RGB32_Sint,  readRGBA<qint32,  3>, writeRGBA<qint32,  3>,
+      readRowRGBA<qint32,  3>, writeRowRGBA<qint32,  3> },
+    { TextureFormat::RGB32_Uint,  readRGBA<quint32, 3>, writeRGBA<quint32, 3>,
+      readRowRGBA<quint32, 3>, writeRowRGBA<quint32, 3> },
+    { TextureFormat::RGB32_Float, readRGBA<float,   3>, writeRGBA<float,   3>,
+      readRowRGBA<float,   3>, writeRowRGBA<float,   3> },
 
     // 128bit
-    { TextureFormat::RGBA32_Sint,  readRGBA<qint32,  4>, writeRGBA<qint32,  4> },
-    { TextureFormat::RGBA32_Uint,  readRGBA<quint32, 4>, writeRGBA<quint32, 4> },
-    { TextureFormat::RGBA32_Float, readRGBA<float,   4>, writeRGBA<float,   4> },
+    { TextureFormat::RGBA32_Sint,  readRGBA<qint32,  4>, writeRGBA<qint32,  4>,
+      readRowRGBA<qint32,  4>, writeRowRGBA<qint32,  4> },
+    { TextureFormat::RGBA32_Uint,  readRGBA<quint32, 4>, writeRGBA<quint32, 4>,
+      readRowRGBA<quint32, 4>, writeRowRGBA<quint32, 4> },
+    { TextureFormat::RGBA32_Float, readRGBA<float,   4>, writeRGBA<float,   4>,
+      readRowRGBA<float,   4>, writeRowRGBA<float,   4> },
 
     // packed formats
     { TextureFormat::BGR565_Unorm },
@@ -369,6 +451,50 @@ std::function<void(Texture::Data, const ColorVariant &color)> TextureData::getFo
     return gsl::at(converters, qsizetype(format)).writer;
 }
 
+/*!
+    \internal
+    Returns the function that decodes a line of texels of the given \a format to an array of
+    Rgba128Float colors. Formats without a dedicated function fall back to the texel reader.
+*/
+TextureData::RowReader TextureData::getRowReader(TextureFormat format)
+{
+    const auto &converter = gsl::at(converters, qsizetype(format));
+    if (converter.rowReader)
+        return converter.rowReader;
+    if (!converter.reader)
+        return {};
+
+    const auto reader = converter.reader;
+    return [reader](Texture::ConstData data, gsl::span<Rgba128Float> result)
+    {
+        const auto bytesPerTexel = data.size() / result.size();
+        for (qsizetype i = 0; i < result.size(); ++i)
+            result[i] = reader(data.subspan(i * bytesPerTexel, bytesPerTexel)).convert<Rgba128Float>();
+    };
+}
+
+/*!
+    \internal
+    Returns the function that encodes an array of Rgba128Float colors to a line of texels of the
+    given \a format. Formats without a dedicated function fall back to the texel writer.
+*/
+TextureData::RowWriter TextureData::getRowWriter(TextureFormat format)
+{
+    const auto &converter = gsl::at(converters, qsizetype(format));
+    if (converter.rowWriter)
+        return converter.rowWriter;
+    if (!converter.writer)
+        return {};
+
+    const auto writer = converter.writer;
+    return [writer](gsl::span<const Rgba128Float> colors, Texture::Data data)
+    {
+        const auto bytesPerTexel = data.size() / colors.size();
+        for (qsizetype i = 0; i < colors.size(); ++i)
+            writer(data.subspan(i * bytesPerTexel, bytesPerTexel), colors[i]);
+    };
+}
+
 /*!
     \internal
     Returns the list of formats Texture can convert.
@@ -55,13 +55,24 @@ public:
     qsizetype levelOffset(size_type level) const { return levelInfos[uint(level)].offset; }
     qsizetype offset(size_type side, size_type level, size_type layer) const;
 
+    quint64 contentHash() const;
+    // returns 0 if the hash is not calculated yet
+    quint64 cachedHash() const { return hash.loadAcquire(); }
+    void invalidateHash() { hash.storeRelease(0); }
+
     static std::function<ColorVariant(Texture::ConstData)> getFormatReader(TextureFormat format);
     static std::function<void(Texture::Data, const ColorVariant &)> getFormatWriter(TextureFormat format);
+    using RowReader = std::function<void(Texture::ConstData, gsl::span<Rgba128Float>)>;
+    using RowWriter = std::function<void(gsl::span<const Rgba128Float>, Texture::Data)>;
+    static RowReader getRowReader(TextureFormat format);
+    static RowWriter getRowWriter(TextureFormat format);
 
     QAtomicInt ref {0};
     TextureFormat format {TextureFormat::Invalid};
     Texture::Alignment align {Texture::Alignment::Byte};
     bool compressed {false};
+    // data is shared with an external owner (e.g. QImage) and should be copied before writing
+    bool ro_data {false};
     size_type width {0};
     size_type height {0};
     size_type depth {0};
@@ -82,6 +93,9 @@ public:
     qsizetype nbytes {0};
     using DataPointer = std::unique_ptr<uchar[], Texture::DataDeleter>;
     DataPointer data;
+
+    // 0 means that hash is not calculated yet
+    mutable QAtomicInteger<quint64> hash {0};
 };
 
 #endif // TEXTURE_P_H
@@ -0,0 +1,373 @@
+#include "texturecomparison.h"
+#include "texture_p.h"
+#include "texturedecoder_p.h"
+#include "textureparallel_p.h"
+#include "textureresampler_p.h"
+
+#include <QtCore/QDebug>
+#include <QtCore/QMutex>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+using size_type = TextureComparison::size_type;
+using Private::FloatImage;
+
+// SSIM is averaged over 8x8 windows placed every 4 texels
+constexpr size_type ssimWindow = 8;
+constexpr size_type ssimStep = 4;
+// Stabilizing constants for the dynamic range of 1
+constexpr double ssimC1 = 0.01 * 0.01;
+constexpr double ssimC2 = 0.03 * 0.03;
+
+using Channels = std::array<bool, TextureComparison::ChannelCount>;
+
+// Returns the channels that are stored in the format, others are decoded to constants and would
+// always match; luminance is replicated to RGB, so it is only counted as red
+Channels storedChannels(TextureFormat format) noexcept
+{
+    switch (format) {
+    case TextureFormat::A8_Unorm:
+        return {false, false, false, true};
+    case TextureFormat::L8_Unorm:
+    case TextureFormat::R8_Snorm:
+    case TextureFormat::R8_Unorm:
+    case TextureFormat::R8_Sint:
+    case TextureFormat::R8_Uint:
+    case TextureFormat::R16_Snorm:
+    case TextureFormat::R16_Unorm:
+    case TextureFormat::R16_Sint:
+    case TextureFormat::R16_Uint:
+    case TextureFormat::R16_Float:
+    case TextureFormat::R32_Sint:
+    case TextureFormat::R32_Uint:
+    case TextureFormat::R32_Float:
+    case TextureFormat::Bc4_Snorm:
+    case TextureFormat::Bc4_Unorm:
+    case TextureFormat::R11_EAC_UNorm:
+    case TextureFormat::R11_EAC_SNorm:
+        return {true, false, false, false};
+    case TextureFormat::LA8_Unorm:
+        return {true, false, false, true};
+    case TextureFormat::RG8_Snorm:
+    case TextureFormat::RG8_Unorm:
+    case TextureFormat::RG8_Sint:
+    case TextureFormat::RG8_Uint:
+    case TextureFormat::RG16_Snorm:
+    case TextureFormat::RG16_Unorm:
+    case TextureFormat::RG16_Sint:
+    case TextureFormat::RG16_Uint:
+    case TextureFormat::RG16_Float:
+    case TextureFormat::RG32_Sint:
+    case TextureFormat::RG32_Uint:
+    case TextureFormat::RG32_Float:
+    case TextureFormat::Bc5_Unorm:
+    case TextureFormat::Bc5_Snorm:
+    case TextureFormat::RG_ATI2N_UNorm:
+    case TextureFormat::RG11_EAC_UNorm:
+    case TextureFormat::RG11_EAC_SNorm:
+        return {true, true, false, false};
+    case TextureFormat::RGB8_Unorm:
+    case TextureFormat::BGR8_Unorm:
+    case TextureFormat::RGBX8_Unorm:
+    case TextureFormat::BGRX8_Unorm:
+    case TextureFormat::BGRX8_Srgb:
+    case TextureFormat::RGB32_Sint:
+    case TextureFormat::RGB32_Uint:
+    case TextureFormat::RGB32_Float:
+    case TextureFormat::BGR565_Unorm:
+    case TextureFormat::RGB565_Unorm:
+    case TextureFormat::BGRX4_Unorm:
+    case TextureFormat::BGRX5551_Unorm:
+    case TextureFormat::RGB332_Unorm:
+    case TextureFormat::Bc1Rgb_Unorm:
+    case TextureFormat::Bc1Rgb_Srgb:
+    case TextureFormat::Bc6HUF16:
+    case TextureFormat::Bc6HSF16:
+    case TextureFormat::RGB8_ETC1:
+    case TextureFormat::RGB8_ETC2:
+        return {true, true, true, false};
+    default:
+        return {true, true, true, true};
+    }
+}
+
+FloatImage loadImage(const Texture &texture, Texture::ArrayIndex index)
+{
+    const auto span = texture.constImageSpan(index);
+    if (span.isNull())
+        return {};
+
+    if (texture.isCompressed()) {
+        if (!Private::canDecode(texture.format())) {
+            qCWarning(::texture) << "Comparison is not supported for format" << texture.format();
+            return {};
+        }
+        return Private::decoded(span);
+    }
+
+    const auto reader = TextureData::getRowReader(texture.format());
+    if (!reader) {
+        qCWarning(::texture) << "Comparison is not supported for format" << texture.format();
+        return {};
+    }
+    return FloatImage::fromSpan(span, reader);
+}
+
+struct ErrorSums
+{
+    std::array<double, 4> squared {};
+    std::array<float, 4> max {};
+
+    void merge(const ErrorSums &other)
+    {
+        for (size_t c = 0; c < 4; ++c) {
+            squared[c] += other.squared[c];
+            max[c] = std::max(max[c], other.max[c]);
+        }
+    }
+};
+
+ErrorSums computeErrors(const FloatImage &lhs, const FloatImage &rhs)
+{
+    ErrorSums total;
+    QMutex mutex;
+    const auto lineSize = 4 * lhs.width();
+    Private::parallelFor(lhs.height() * lhs.depth(), lineSize, [&](size_type begin, size_type end)
+    {
+        ErrorSums partial;
+        for (auto line = begin; line < end; ++line) {
+            const auto a = lhs.data() + lineSize * line;
+            const auto b = rhs.data() + lineSize * line;
+            for (size_type i = 0; i < lineSize; i += 4) {
+                for (size_t c = 0; c < 4; ++c) {
+                    const auto error = std::abs(a[i + qsizetype(c)] - b[i + qsizetype(c)]);
+                    partial.squared[c] += double(error) * error;
+                    partial.max[c] = std::max(partial.max[c], error);
+                }
+            }
+        }
+        QMutexLocker locker(&mutex);
+        total.merge(partial);
+    });
+    return total;
+}
+
+std::array<double, 4> windowSsim(
+        const FloatImage &lhs,
+        const FloatImage &rhs,
+        size_type x0, size_type y0, size_type z,
+        size_type width, size_type height)
+{
+    std::array<double, 4> sumA {}, sumB {}, sumAA {}, sumBB {}, sumAB {};
+    for (auto y = y0; y < y0 + height; ++y) {
+        const auto a = lhs.line(y, z) + 4 * x0;
+        const auto b = rhs.line(y, z) + 4 * x0;
+        for (size_type i = 0; i < 4 * width; i += 4) {
+            for (size_t c = 0; c < 4; ++c) {
+                const double va = a[i + qsizetype(c)];
+                const double vb = b[i + qsizetype(c)];
+                sumA[c] += va;
+                sumB[c] += vb;
+                sumAA[c] += va * va;
+                sumBB[c] += vb * vb;
+                sumAB[c] += va * vb;
+            }
+        }
+    }
+
+    std::array<double, 4> result {};
+    const double n = double(width * height);
+    for (size_t c = 0; c < 4; ++c) {
+        const auto meanA = sumA[c] / n;
+        const auto meanB = sumB[c] / n;
+        const auto varA = std::max(sumAA[c] / n - meanA * meanA, 0.0);
+        const auto varB = std::max(sumBB[c] / n - meanB * meanB, 0.0);
+        const auto covariance = sumAB[c] / n - meanA * meanB;
+        result[c] = ((2 * meanA * meanB + ssimC1) * (2 * covariance + ssimC2))
+                / ((meanA * meanA + meanB * meanB + ssimC1) * (varA + varB + ssimC2));
+    }
+    return result;
+}
+
+std::array<double, 4> computeSsim(const FloatImage &lhs, const FloatImage &rhs)
+{
+    // small images are compared as a single window
+    const auto windowWidth = std::min(ssimWindow, lhs.width());
+    const auto windowHeight = std::min(ssimWindow, lhs.height());
+    const auto columns = (lhs.width() - windowWidth) / ssimStep + 1;
+    const auto rows = (lhs.height() - windowHeight) / ssimStep + 1;
+
+    std::array<double, 4> total {};
+    QMutex mutex;
+    const auto cost = columns * windowWidth * windowHeight * 4;
+    Private::parallelFor(rows * lhs.depth(), cost, [&](size_type begin, size_type end)
+    {
+        std::array<double, 4> partial {};
+        for (auto row = begin; row < end; ++row) {
+            const auto z = row / rows;
+            const auto y = (row % rows) * ssimStep;
+            for (size_type column = 0; column < columns; ++column) {
+                const auto ssim = windowSsim(
+                        lhs, rhs, column * ssimStep, y, z, windowWidth, windowHeight);
+                for (size_t c = 0; c < 4; ++c)
+                    partial[c] += ssim[c];
+            }
+        }
+        QMutexLocker locker(&mutex);
+        for (size_t c = 0; c < 4; ++c)
+            total[c] += partial[c];
+    });
+
+    const auto windows = double(columns * rows * lhs.depth());
+    for (auto &value: total)
+        value /= windows;
+    return total;
+}
+
+double psnr(double mse)
+{
+    if (mse == 0.0)
+        return std::numeric_limits<double>::infinity();
+    return 10.0 * std::log10(1.0 / mse);
+}
+
+Texture makeDiffImage(const FloatImage &lhs, const FloatImage &rhs)
+{
+    Texture result(TextureFormat::RGBA8_Unorm, {lhs.width(), lhs.height(), lhs.depth()});
+    if (result.isNull())
+        return result;
+
+    auto span = result.imageSpan({});
+    const auto lineSize = 4 * lhs.width();
+    Private::parallelFor(lhs.height() * lhs.depth(), lineSize, [&](size_type begin, size_type end)
+    {
+        for (auto line = begin; line < end; ++line) {
+            const auto a = lhs.data() + lineSize * line;
+            const auto b = rhs.data() + lineSize * line;
+            auto dst = span.line(line % lhs.height(), line / lhs.height()).data();
+            for (size_type i = 0; i < lineSize; i += 4) {
+                for (int c = 0; c < 3; ++c) {
+                    const auto error = std::min(std::abs(a[i + c] - b[i + c]), 1.0f);
+                    *dst++ = uchar(error * 255.0f + 0.5f);
+                }
+                *dst++ = 255;
+            }
+        }
+    });
+    return result;
+}
+
+} // namespace
+
+/*!
+  \class TextureComparison
+  \brief TextureComparison computes error metrics between two images.
+
+  Images are compared per channel in the floating point space, so textures of different formats
+  can be compared; values of normalized formats are in the [0, 1] range. Compressed BC1-BC5
+  formats are decoded first.
+
+  The following metrics are computed for each channel and for all channels together:
+  \list
+  \li mean squared error
+  \li peak signal-to-noise ratio in dB, relative to the peak value of 1
+  \li structural similarity, averaged over 8x8 windows
+  \li maximum absolute error
+  \endlist
+
+  Lines and windows are processed in parallel.
+*/
+
+/*!
+  \enum TextureComparison::Option
+  This enum describes comparison options
+
+  \var TextureComparison::Option TextureComparison::NoOptions
+  Only metrics are computed
+
+  \var TextureComparison::Option TextureComparison::DiffImage
+  The absolute difference of RGB channels is stored in an RGBA8_Unorm texture
+*/
+
+/*!
+  \brief Compares images at the given \a index of the \a lhs and \a rhs textures.
+
+  Images should have the same size, otherwise a null object is constructed.
+*/
+TextureComparison::TextureComparison(
+        const Texture &lhs,
+        const Texture &rhs,
+        Texture::ArrayIndex index,
+        Options options)
+{
+    if (lhs.isNull() || rhs.isNull())
+        return;
+
+    const auto level = index.level();
+    if (level >= lhs.levels() || level >= rhs.levels()
+            || lhs.width(level) != rhs.width(level)
+            || lhs.height(level) != rhs.height(level)
+            || lhs.depth(level) != rhs.depth(level)) {
+        qCWarning(::texture) << "Can't compare textures of different sizes";
+        return;
+    }
+
+    const auto a = loadImage(lhs, index);
+    const auto b = loadImage(rhs, index);
+    if (a.isNull() || b.isNull())
+        return;
+
+    const auto errors = computeErrors(a, b);
+    const auto ssim = computeSsim(a, b);
+
+    // a channel stored in either format can differ
+    const auto lhsChannels = storedChannels(lhs.format());
+    const auto rhsChannels = storedChannels(rhs.format());
+    Channels channels {};
+    for (size_t c = 0; c < ChannelCount; ++c)
+        channels[c] = lhsChannels[c] || rhsChannels[c];
+    const auto channelCount = std::count(channels.begin(), channels.end(), true);
+
+    m_texelCount = a.texelCount();
+    for (size_t c = 0; c < ChannelCount; ++c) {
+        auto &metrics = m_channels[c];
+        metrics.mse = errors.squared[c] / m_texelCount;
+        metrics.psnr = psnr(metrics.mse);
+        metrics.ssim = ssim[c];
+        metrics.maxError = errors.max[c];
+
+        if (!channels[c])
+            continue;
+        m_total.mse += metrics.mse / channelCount;
+        m_total.ssim += metrics.ssim / channelCount;
+        m_total.maxError = std::max(m_total.maxError, metrics.maxError);
+    }
+    m_total.psnr = psnr(m_total.mse);
+
+    if (options.testFlag(Option::DiffImage))
+        m_diffImage = makeDiffImage(a, b);
+}
+
+/*!
+  \fn bool TextureComparison::isNull() const noexcept
+  \brief Returns true if the images were not compared.
+*/
+
+/*!
+  \fn const Metrics &TextureComparison::total() const noexcept
+  \brief Returns metrics of all channels; the MSE and the SSIM are averaged, the PSNR is
+  computed from the averaged MSE.
+
+  Only channels stored in the format of either texture are taken into account; channels that are
+  missing in both formats always match and would otherwise inflate the result.
+*/
+
+/*!
+  \fn const Texture &TextureComparison::diffImage() const noexcept
+  \brief Returns the difference image if it was requested with the Option::DiffImage,
+  otherwise returns a null texture.
+*/
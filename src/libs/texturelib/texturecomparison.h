@@ -0,0 +1,62 @@
+#pragma once
+
+#include "texturelib_global.h"
+
+#include <TextureLib/Texture>
+
+#include <array>
+
+class TEXTURELIB_EXPORT TextureComparison
+{
+    Q_GADGET
+public:
+    using size_type = Texture::size_type;
+
+    enum class Option {
+        NoOptions = 0x0,
+        DiffImage = 0x1,
+    };
+    using Options = QFlags<Option>;
+    Q_FLAG(Options)
+
+    struct Metrics
+    {
+        double mse {0.0};
+        // infinite for equal images
+        double psnr {0.0};
+        double ssim {0.0};
+        float maxError {0.0f};
+    };
+
+    enum ChannelIndex {
+        Red = 0,
+        Green,
+        Blue,
+        Alpha,
+        ChannelCount
+    };
+
+    TextureComparison() = default;
+    TextureComparison(
+            const Texture &lhs,
+            const Texture &rhs,
+            Texture::ArrayIndex index = {},
+            Options options = Option::NoOptions);
+
+    bool isNull() const noexcept { return m_texelCount == 0; }
+
+    size_type texelCount() const noexcept { return m_texelCount; }
+
+    const Metrics &channel(ChannelIndex index) const { return m_channels[size_t(index)]; }
+    const Metrics &total() const noexcept { return m_total; }
+
+    const Texture &diffImage() const noexcept { return m_diffImage; }
+
+private:
+    std::array<Metrics, ChannelCount> m_channels {};
+    Metrics m_total;
+    size_type m_texelCount {0};
+    Texture m_diffImage;
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(TextureComparison::Options)
@@ -0,0 +1,207 @@
+#include "texturedecoder_p.h"
+#include "textureparallel_p.h"
+
+#include <algorithm>
+
+namespace Private {
+
+namespace {
+
+using size_type = FloatImage::size_type;
+using Float4 = std::array<float, 4>;
+// Texels of a 4x4 block in row-major order
+using Block = std::array<Float4, 16>;
+
+enum class BlockType {
+    None,
+    Bc1,
+    Bc1Alpha,
+    Bc2,
+    Bc3,
+    Bc4,
+    Bc4Signed,
+    Bc5,
+    Bc5Signed,
+};
+
+BlockType blockType(TextureFormat format) noexcept
+{
+    switch (format) {
+    case TextureFormat::Bc1Rgb_Unorm:
+    case TextureFormat::Bc1Rgb_Srgb: return BlockType::Bc1;
+    case TextureFormat::Bc1Rgba_Unorm:
+    case TextureFormat::Bc1Rgba_Srgb: return BlockType::Bc1Alpha;
+    case TextureFormat::Bc2_Unorm:
+    case TextureFormat::Bc2_Srgb: return BlockType::Bc2;
+    case TextureFormat::Bc3_Unorm:
+    case TextureFormat::Bc3_Srgb: return BlockType::Bc3;
+    case TextureFormat::Bc4_Unorm: return BlockType::Bc4;
+    case TextureFormat::Bc4_Snorm: return BlockType::Bc4Signed;
+    case TextureFormat::Bc5_Unorm: return BlockType::Bc5;
+    case TextureFormat::Bc5_Snorm: return BlockType::Bc5Signed;
+    default: return BlockType::None;
+    }
+}
+
+inline Float4 rgb565(quint16 color) noexcept
+{
+    return {((color >> 11) & 0x1f) / 31.0f, ((color >> 5) & 0x3f) / 63.0f, (color & 0x1f) / 31.0f, 1.0f};
+}
+
+inline Float4 mix(const Float4 &a, const Float4 &b, float wa, float wb) noexcept
+{
+    return {a[0] * wa + b[0] * wb, a[1] * wa + b[1] * wb, a[2] * wa + b[2] * wb, 1.0f};
+}
+
+// Decodes the BC1 color part to the RGB of the block. The 3-color mode with the transparent
+// index is only used by the BC1 itself, BC2 and BC3 always interpolate 4 colors.
+void decodeColor(const uchar *data, Block &block, bool isBc1, bool hasAlpha) noexcept
+{
+    const auto c0 = quint16(data[0] | (data[1] << 8));
+    const auto c1 = quint16(data[2] | (data[3] << 8));
+
+    std::array<Float4, 4> palette;
+    palette[0] = rgb565(c0);
+    palette[1] = rgb565(c1);
+    if (c0 > c1 || !isBc1) {
+        palette[2] = mix(palette[0], palette[1], 2.0f / 3.0f, 1.0f / 3.0f);
+        palette[3] = mix(palette[0], palette[1], 1.0f / 3.0f, 2.0f / 3.0f);
+    } else {
+        palette[2] = mix(palette[0], palette[1], 0.5f, 0.5f);
+        palette[3] = {0.0f, 0.0f, 0.0f, hasAlpha ? 0.0f : 1.0f};
+    }
+
+    const auto indices = quint32(data[4]) | (quint32(data[5]) << 8)
+            | (quint32(data[6]) << 16) | (quint32(data[7]) << 24);
+    for (size_t i = 0; i < 16; ++i) {
+        const auto &color = palette[(indices >> (2 * i)) & 0x3];
+        block[i][0] = color[0];
+        block[i][1] = color[1];
+        block[i][2] = color[2];
+        if (isBc1)
+            block[i][3] = color[3];
+    }
+}
+
+// Decodes a BC3 alpha / BC4 block to the given channel of the block
+void decodeChannel(const uchar *data, Block &block, size_t channel, bool isSigned) noexcept
+{
+    float v0, v1;
+    bool sixValues;
+    if (isSigned) {
+        const auto s0 = qint8(data[0]);
+        const auto s1 = qint8(data[1]);
+        v0 = std::max(s0 / 127.0f, -1.0f);
+        v1 = std::max(s1 / 127.0f, -1.0f);
+        sixValues = s0 <= s1;
+    } else {
+        v0 = data[0] / 255.0f;
+        v1 = data[1] / 255.0f;
+        sixValues = data[0] <= data[1];
+    }
+
+    std::array<float, 8> palette;
+    palette[0] = v0;
+    palette[1] = v1;
+    if (!sixValues) {
+        for (int i = 1; i < 7; ++i)
+            palette[size_t(i + 1)] = (v0 * (7 - i) + v1 * i) / 7.0f;
+    } else {
+        for (int i = 1; i < 5; ++i)
+            palette[size_t(i + 1)] = (v0 * (5 - i) + v1 * i) / 5.0f;
+        palette[6] = isSigned ? -1.0f : 0.0f;
+        palette[7] = 1.0f;
+    }
+
+    quint64 indices = 0;
+    for (int i = 0; i < 6; ++i)
+        indices |= quint64(data[2 + i]) << (8 * i);
+    for (size_t i = 0; i < 16; ++i)
+        block[i][channel] = palette[(indices >> (3 * i)) & 0x7];
+}
+
+void decodeBlock(BlockType type, const uchar *data, Block &block) noexcept
+{
+    switch (type) {
+    case BlockType::Bc1:
+    case BlockType::Bc1Alpha:
+        decodeColor(data, block, true, type == BlockType::Bc1Alpha);
+        break;
+    case BlockType::Bc2:
+        for (size_t i = 0; i < 16; ++i)
+            block[i][3] = ((data[i / 2] >> (4 * (i % 2))) & 0xf) / 15.0f;
+        decodeColor(data + 8, block, false, true);
+        break;
+    case BlockType::Bc3:
+        decodeChannel(data, block, 3, false);
+        decodeColor(data + 8, block, false, true);
+        break;
+    case BlockType::Bc4:
+    case BlockType::Bc4Signed:
+        for (auto &texel: block)
+            texel = {0.0f, 0.0f, 0.0f, 1.0f};
+        decodeChannel(data, block, 0, type == BlockType::Bc4Signed);
+        break;
+    case BlockType::Bc5:
+    case BlockType::Bc5Signed:
+        for (auto &texel: block)
+            texel = {0.0f, 0.0f, 0.0f, 1.0f};
+        decodeChannel(data, block, 0, type == BlockType::Bc5Signed);
+        decodeChannel(data + 8, block, 1, type == BlockType::Bc5Signed);
+        break;
+    case BlockType::None:
+        break;
+    }
+}
+
+} // namespace
+
+/*!
+  \internal
+  Returns true if the compressed \a format can be decoded with decoded().
+*/
+bool canDecode(TextureFormat format) noexcept
+{
+    return blockType(format) != BlockType::None;
+}
+
+/*!
+  \internal
+  Decodes the BC1-BC5 compressed image to floats. Values of sRGB formats are not linearized.
+
+  Returns a null image if the format is not supported.
+*/
+FloatImage decoded(ConstTextureSpan span)
+{
+    const auto type = blockType(span.format());
+    if (type == BlockType::None || span.isNull())
+        return {};
+
+    FloatImage result(span.width(), span.height(), span.depth());
+    const auto blocksPerLine = (span.width() + 3) / 4;
+    const auto blockLines = span.lineCount();
+    parallelFor(blockLines * span.depth(), 16 * blocksPerLine, [&](size_type begin, size_type end)
+    {
+        Block block;
+        for (auto line = begin; line < end; ++line) {
+            const auto z = line / blockLines;
+            const auto by = line % blockLines;
+            const auto data = span.line(by, z).data();
+            for (size_type bx = 0; bx < blocksPerLine; ++bx) {
+                decodeBlock(type, data + bx * span.blockSize(), block);
+                const auto rows = std::min<size_type>(4, span.height() - 4 * by);
+                const auto columns = std::min<size_type>(4, span.width() - 4 * bx);
+                for (size_type y = 0; y < rows; ++y) {
+                    auto dst = result.line(4 * by + y, z) + 4 * 4 * bx;
+                    for (size_type x = 0; x < columns; ++x) {
+                        const auto &texel = block[size_t(4 * y + x)];
+                        std::copy(texel.begin(), texel.end(), dst + 4 * x);
+                    }
+                }
+            }
+        }
+    });
+    return result;
+}
+
+} // namespace Private
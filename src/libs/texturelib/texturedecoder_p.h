@@ -0,0 +1,13 @@
+#ifndef TEXTUREDECODER_P_H
+#define TEXTUREDECODER_P_H
+
+#include "textureresampler_p.h"
+
+namespace Private {
+
+bool canDecode(TextureFormat format) noexcept;
+FloatImage decoded(ConstTextureSpan span);
+
+} // namespace Private
+
+#endif // TEXTUREDECODER_P_H
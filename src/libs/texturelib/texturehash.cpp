@@ -0,0 +1,147 @@
+#include "texturehash_p.h"
+
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <QtCore/QtEndian>
+
+#include <vector>
+
+namespace Private {
+
+namespace {
+
+// XXH64 constants
+constexpr quint64 prime1 = 0x9E3779B185EBCA87ull;
+constexpr quint64 prime2 = 0xC2B2AE3D27D4EB4Full;
+constexpr quint64 prime3 = 0x165667B19E3779F9ull;
+constexpr quint64 prime4 = 0x85EBCA77C2B2AE63ull;
+constexpr quint64 prime5 = 0x27D4EB2F165667C5ull;
+
+// Big enough to amortize the thread overhead, small enough to load all cores on mid-sized
+// textures.
+constexpr qsizetype chunkSize = 1 << 20;
+
+constexpr quint64 rotl(quint64 value, int bits) noexcept
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+constexpr quint64 round(quint64 acc, quint64 input) noexcept
+{
+    acc += input * prime2;
+    acc = rotl(acc, 31);
+    return acc * prime1;
+}
+
+constexpr quint64 mergeRound(quint64 acc, quint64 value) noexcept
+{
+    acc ^= round(0, value);
+    return acc * prime1 + prime4;
+}
+
+inline quint64 read64(const uchar *p) noexcept { return qFromLittleEndian<quint64>(p); }
+inline quint32 read32(const uchar *p) noexcept { return qFromLittleEndian<quint32>(p); }
+
+} // namespace
+
+/*!
+  \internal
+  Returns the 64-bit XXH64 hash of the \a data using the given \a seed.
+
+  The main loop uses four independent accumulators so the compiler is able to keep them in
+  registers and vectorize the multiplications.
+*/
+quint64 hashBytes(gsl::span<const uchar> data, quint64 seed) noexcept
+{
+    auto p = data.data();
+    const auto size = quint64(data.size());
+    const auto end = p + data.size();
+
+    quint64 result = 0;
+    if (size >= 32) {
+        quint64 v1 = seed + prime1 + prime2;
+        quint64 v2 = seed + prime2;
+        quint64 v3 = seed;
+        quint64 v4 = seed - prime1;
+        const auto limit = end - 32;
+        do {
+            v1 = round(v1, read64(p));
+            v2 = round(v2, read64(p + 8));
+            v3 = round(v3, read64(p + 16));
+            v4 = round(v4, read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+
+        result = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        result = mergeRound(result, v1);
+        result = mergeRound(result, v2);
+        result = mergeRound(result, v3);
+        result = mergeRound(result, v4);
+    } else {
+        result = seed + prime5;
+    }
+
+    result += size;
+
+    for (; p + 8 <= end; p += 8) {
+        result ^= round(0, read64(p));
+        result = rotl(result, 27) * prime1 + prime4;
+    }
+    if (p + 4 <= end) {
+        result ^= quint64(read32(p)) * prime1;
+        result = rotl(result, 23) * prime2 + prime3;
+        p += 4;
+    }
+    for (; p < end; ++p) {
+        result ^= (*p) * prime5;
+        result = rotl(result, 11) * prime1;
+    }
+
+    result ^= result >> 33;
+    result *= prime2;
+    result ^= result >> 29;
+    result *= prime3;
+    result ^= result >> 32;
+    return result;
+}
+
+/*!
+  \internal
+  Returns the hash of the \a data using the given \a seed.
+
+  Big buffers are split in chunks which are hashed in parallel, the chunk hashes are then hashed
+  together. The result does not depend on the number of threads, however it differs from
+  the hashBytes() result for buffers bigger than a single chunk.
+*/
+quint64 hashBytesParallel(gsl::span<const uchar> data, quint64 seed)
+{
+    if (data.size() <= chunkSize)
+        return hashBytes(data, seed);
+
+    struct Chunk
+    {
+        gsl::span<const uchar> data;
+        quint64 hash {0};
+    };
+
+    std::vector<Chunk> chunks;
+    chunks.reserve(size_t((data.size() + chunkSize - 1) / chunkSize));
+    for (qsizetype offset = 0; offset < data.size(); offset += chunkSize)
+        chunks.push_back({data.subspan(offset, std::min(chunkSize, data.size() - offset))});
+
+    QtConcurrent::blockingMap(chunks, [seed](Chunk &chunk)
+    {
+        chunk.hash = hashBytes(chunk.data, seed);
+    });
+
+    std::vector<quint64> hashes;
+    hashes.reserve(chunks.size());
+    for (const auto &chunk: chunks)
+        hashes.push_back(qToLittleEndian(chunk.hash));
+
+    return hashBytes(
+            {reinterpret_cast<const uchar *>(hashes.data()), qsizetype(hashes.size() * sizeof(quint64))},
+            seed ^ quint64(data.size()));
+}
+
+} // namespace Private
@@ -0,0 +1,15 @@
+#ifndef TEXTUREHASH_P_H
+#define TEXTUREHASH_P_H
+
+#include <QtCore/qglobal.h>
+
+#include <gsl/span>
+
+namespace Private {
+
+quint64 hashBytes(gsl::span<const uchar> data, quint64 seed = 0) noexcept;
+quint64 hashBytesParallel(gsl::span<const uchar> data, quint64 seed = 0);
+
+} // namespace Private
+
+#endif // TEXTUREHASH_P_H
@@ -0,0 +1,82 @@
+#include "textureinfo.h"
+
+/*!
+  \class TextureInfo
+  \brief TextureInfo describes the layout of a texture without holding its data.
+
+  TextureInfo is returned by TextureIO::readInfo(), which parses only the file header, so the
+  format and the dimensions of a texture can be queried without reading its texels.
+*/
+
+/*!
+  \fn TextureInfo::TextureInfo(TextureFormat format, Size size, ArraySize dimensions)
+  \brief Constructs TextureInfo with the given \a format, \a size and \a dimensions.
+*/
+
+/*!
+  \brief Constructs TextureInfo that describes the given \a texture.
+*/
+TextureInfo::TextureInfo(const Texture &texture) noexcept
+{
+    if (texture.isNull())
+        return;
+
+    m_format = texture.format();
+    m_size = texture.size();
+    m_dimensions = {texture.faces() == 6 ? Texture::IsCubemap::Yes : Texture::IsCubemap::No,
+                    texture.levels(),
+                    texture.layers()};
+}
+
+/*!
+  \fn bool TextureInfo::isNull() const noexcept
+  \brief Returns true if the format is invalid.
+*/
+
+/*!
+  \fn TextureInfo::Size TextureInfo::size(size_type level) const noexcept
+  \brief Returns the size of the given mipmap \a level.
+*/
+
+/*!
+  \brief Returns the size in bytes of a single image of the given mipmap \a level with lines
+  aligned to the \a align.
+
+  File handlers use it to skip images that are not read.
+*/
+qsizetype TextureInfo::bytesPerImage(size_type level, Texture::Alignment align) const
+{
+    if (isNull() || level < 0 || level >= levels())
+        return 0;
+    const auto levelSize = size(level);
+    return Texture::calculateBytesPerSlice(m_format, levelSize.width, levelSize.height, align)
+            * levelSize.depth;
+}
+
+/*!
+  \brief Returns the size in bytes of the whole texture with lines aligned to the \a align.
+
+  This is the amount of memory a Texture with this layout allocates.
+*/
+qsizetype TextureInfo::bytes(Texture::Alignment align) const
+{
+    qsizetype result = 0;
+    for (size_type level = 0; level < levels(); ++level)
+        result += bytesPerImage(level, align);
+    return result * faces() * layers();
+}
+
+/*!
+  \relates TextureInfo
+  Returns true if \a lhs and \a rhs describe the same texture layout.
+*/
+bool operator==(const TextureInfo &lhs, const TextureInfo &rhs) noexcept
+{
+    return lhs.format() == rhs.format()
+            && lhs.width() == rhs.width()
+            && lhs.height() == rhs.height()
+            && lhs.depth() == rhs.depth()
+            && lhs.faces() == rhs.faces()
+            && lhs.levels() == rhs.levels()
+            && lhs.layers() == rhs.layers();
+}
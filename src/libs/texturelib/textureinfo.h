@@ -0,0 +1,58 @@
+#pragma once
+
+#include "texturelib_global.h"
+
+#include <TextureLib/Texture>
+
+#include <algorithm>
+
+class TEXTURELIB_EXPORT TextureInfo
+{
+public:
+    using size_type = Texture::size_type;
+    using Size = Texture::Size;
+    using ArraySize = Texture::ArraySize;
+
+    constexpr TextureInfo() noexcept = default;
+    constexpr TextureInfo(TextureFormat format, Size size, ArraySize dimensions = {1, 1}) noexcept
+        : m_format(format)
+        , m_size(size)
+        , m_dimensions(dimensions)
+    {}
+    explicit TextureInfo(const Texture &texture) noexcept;
+
+    constexpr bool isNull() const noexcept { return m_format == TextureFormat::Invalid; }
+
+    constexpr TextureFormat format() const noexcept { return m_format; }
+
+    constexpr Size size(size_type level = 0) const noexcept
+    {
+        if (!level)
+            return m_size;
+        return {std::max<size_type>(1, m_size.width >> level),
+                std::max<size_type>(1, m_size.height >> level),
+                std::max<size_type>(1, m_size.depth >> level)};
+    }
+    constexpr size_type width(size_type level = 0) const noexcept { return size(level).width; }
+    constexpr size_type height(size_type level = 0) const noexcept { return size(level).height; }
+    constexpr size_type depth(size_type level = 0) const noexcept { return size(level).depth; }
+
+    constexpr ArraySize dimensions() const noexcept { return m_dimensions; }
+    constexpr size_type faces() const noexcept { return m_dimensions.faces(); }
+    constexpr size_type levels() const noexcept { return m_dimensions.levels(); }
+    constexpr size_type layers() const noexcept { return m_dimensions.layers(); }
+    constexpr bool isCubemap() const noexcept { return m_dimensions.isCubemap(); }
+
+    qsizetype bytesPerImage(
+            size_type level = 0, Texture::Alignment align = Texture::Alignment::Byte) const;
+    qsizetype bytes(Texture::Alignment align = Texture::Alignment::Byte) const;
+
+private:
+    TextureFormat m_format {TextureFormat::Invalid};
+    Size m_size;
+    ArraySize m_dimensions;
+};
+
+TEXTURELIB_EXPORT bool operator==(const TextureInfo &lhs, const TextureInfo &rhs) noexcept;
+inline bool operator!=(const TextureInfo &lhs, const TextureInfo &rhs) noexcept
+{ return !(lhs == rhs); }
@@ -6,10 +6,14 @@
 
 #include <OptionalType>
 
+#include <QtCore/QBuffer>
 #include <QtCore/QDebug>
 #include <QtCore/QFile>
 #include <QtCore/QMimeDatabase>
 
+#include <algorithm>
+#include <limits>
+
 using Capability = TextureIOHandlerPlugin::Capability;
 using Capabilities = TextureIOHandlerPlugin::Capabilities;
 
@@ -23,6 +27,49 @@ static inline QIODevice::OpenMode caps2OpenMode(Capabilities caps)
     return result;
 }
 
+// Returns all layers and faces of the given level as a single-level texture
+static Texture copyLevel(const Texture &texture, Texture::size_type level)
+{
+    Texture result(
+            texture.format(),
+            texture.size(level),
+            {texture.faces() == 6 ? Texture::IsCubemap::Yes : Texture::IsCubemap::No,
+             1,
+             texture.layers()},
+            texture.alignment());
+    if (result.isNull())
+        return result;
+
+    for (Texture::size_type layer = 0; layer < texture.layers(); ++layer) {
+        for (Texture::size_type face = 0; face < texture.faces(); ++face) {
+            const auto side = Texture::Side(face);
+            const auto source = texture.constImageData({side, level, layer});
+            const auto data = result.imageData({side, 0, layer});
+            std::copy(source.begin(), source.end(), data.begin());
+        }
+    }
+    return result;
+}
+
+// Unrequested faces of a cubemap are not read, so they are zeroed instead of leaving garbage
+static void clearSkippedFaces(Texture &texture, const TextureReadOptions &options)
+{
+    if (texture.faces() == 1)
+        return;
+
+    for (Texture::size_type face = 0; face < texture.faces(); ++face) {
+        const auto side = Texture::Side(face);
+        if (options.faces().testFlag(TextureReadOptions::face(side)))
+            continue;
+        for (Texture::size_type layer = 0; layer < texture.layers(); ++layer) {
+            for (Texture::size_type level = 0; level < texture.levels(); ++level) {
+                const auto data = texture.imageData({side, level, layer});
+                std::fill(data.begin(), data.end(), uchar(0));
+            }
+        }
+    }
+}
+
 class TextureIOPrivate
 {
     Q_DECLARE_PUBLIC(TextureIO)
@@ -36,12 +83,20 @@ public:
     TextureIOResult ensureDeviceOpened(Capabilities caps);
     TextureIOResult ensureHandlerCreated(Capabilities caps);
     void resetHandler();
+    TextureIOError handlerError() const;
 
     std::unique_ptr<TextureIOHandler> handler;
+    TextureIO::CancelToken cancelToken;
+    TextureIO::ProgressCallback progressCallback;
 
     QString fileName;
     std::unique_ptr<QFile> file;
 
+    // memory passed to setData(), read via a buffer that doesn't copy it
+    std::unique_ptr<QBuffer> buffer;
+    Texture::ConstData memory;
+    TextureIO::MemoryOwner memoryOwner;
+
     QIODevicePointer device;
     Optional<QMimeType> mimeType {};
 };
@@ -70,28 +125,46 @@ TextureIOResult TextureIOPrivate::ensureHandlerCreated(Capabilities caps)
     if (!ok)
         return ok;
 
-    if (handler)
+    if (handler) {
+        handler->setCancelToken(cancelToken);
+        handler->setProgressCallback(progressCallback);
         return TextureIOResult();
+    }
 
-    auto mt = QMimeType();
+    auto db = TextureIOHandlerDatabase::instance();
+
+    QString mimeTypeName;
     if (!mimeType) {
-        // mimeType is not set, try to guess from file
-        if (file)
-            mt = QMimeDatabase().mimeTypeForFile(fileName);
-        else if ((device->openMode() & QIODevice::ReadOnly))
-            mt = QMimeDatabase().mimeTypeForData(device->peek(256));
+        // fast path, plugins declare signatures of their formats
+        if ((caps & Capability::CanRead) && (device->openMode() & QIODevice::ReadOnly))
+            mimeTypeName = db->mimeTypeForHeader(device->peek(db->maxMagicSize()));
+
+        if (mimeTypeName.isEmpty()) {
+            // unknown or ambiguous signature, try to guess from file
+            auto mt = QMimeType();
+            if (file)
+                mt = QMimeDatabase().mimeTypeForFile(fileName);
+            else if ((device->openMode() & QIODevice::ReadOnly))
+                mt = QMimeDatabase().mimeTypeForData(device->peek(256));
+            if (!mt.isValid())
+                return TextureIOError::InvalidMimeType;
+            mimeTypeName = mt.name();
+        }
     } else {
-        mt = *mimeType;
+        if (!mimeType->isValid())
+            return TextureIOError::InvalidMimeType;
+        mimeTypeName = mimeType->name();
     }
 
-    if (!mt.isValid())
-        return TextureIOError::InvalidMimeType;
-
-    auto db = TextureIOHandlerDatabase::instance();
-    handler = db->create(device, mt.name(), caps);
+    handler = db->create(device, mimeTypeName, caps);
     if (!handler)
         return TextureIOError::UnsupportedMimeType;
 
+    if (buffer)
+        handler->setMemory(memory, memoryOwner);
+
+    handler->setCancelToken(cancelToken);
+    handler->setProgressCallback(progressCallback);
     return TextureIOResult();
 }
 
@@ -100,6 +173,12 @@ void TextureIOPrivate::resetHandler()
     handler.reset();
 }
 
+// Handlers fail when the operation is canceled, the reason is reported separately
+TextureIOError TextureIOPrivate::handlerError() const
+{
+    return handler->isCanceled() ? TextureIOError::Canceled : TextureIOError::HandlerError;
+}
+
 /*!
     \class TextureIO
     \brief TextureIO implements Texture loading and saving.
@@ -163,6 +242,19 @@ TextureIO::TextureIO(QIODevicePointer device, QStringView mimeType) :
     setMimeType(mimeType);
 }
 
+/*!
+  \brief Constructs a TextureIO object that reads from the given memory \a data with the given
+  \a mimeType.
+
+  \sa setData()
+*/
+TextureIO::TextureIO(Texture::ConstData data, MemoryOwner owner, const QMimeType &mimeType) :
+    d_ptr(new TextureIOPrivate(this))
+{
+    setData(data, std::move(owner));
+    setMimeType(mimeType);
+}
+
 /*!
   \brief Destroys the TextureIO object.
 */
@@ -199,6 +291,9 @@ void TextureIO::setFileName(const QString &fileName)
         return;
 
     d->file = std::make_unique<QFile>(fileName);
+    d->buffer.reset();
+    d->memory = {};
+    d->memoryOwner.reset();
     d->device.reset(d->file.get());
     d->fileName = fileName;
     d->resetHandler();
@@ -221,10 +316,68 @@ void TextureIO::setDevice(QIODevicePointer device)
     Q_D(TextureIO);
 
     d->file.reset();
+    d->buffer.reset();
+    d->memory = {};
+    d->memoryOwner.reset();
     d->device = device;
     d->resetHandler();
 }
 
+/*!
+  \typedef TextureIO::MemoryOwner
+  A reference to an object that owns memory passed to setData(), such as a memory mapped pack
+  file or an IPC buffer.
+*/
+
+/*!
+  \brief Sets the memory \a data to read from.
+
+  The data is not copied. Handlers that support it return textures that reference the \a data
+  directly rather than reading it, provided the file stores the images in the same layout as
+  Texture does; such textures are read-only and copy the data on the first write. Textures keep
+  the \a owner alive, so the memory remains valid while they exist, even after this TextureIO
+  object is destroyed. Pass an empty owner if the memory outlives all textures.
+
+  The size of the \a data is limited to \c{std::numeric_limits<int>::max()} bytes. Larger data is
+  rejected with a warning and reading fails with TextureIOError::DeviceError.
+*/
+void TextureIO::setData(Texture::ConstData data, MemoryOwner owner)
+{
+    Q_D(TextureIO);
+
+    d->file.reset();
+    d->fileName.clear();
+    d->resetHandler();
+
+    // QByteArray can't reference more than INT_MAX bytes
+    if (data.size() > std::numeric_limits<int>::max()) {
+        qCWarning(::texture) << "Data is too big:" << data.size() << "bytes";
+        d->buffer.reset();
+        d->memory = {};
+        d->memoryOwner.reset();
+        d->device.reset();
+        return;
+    }
+
+    d->buffer = std::make_unique<QBuffer>();
+    d->buffer->setData(QByteArray::fromRawData(
+            reinterpret_cast<const char *>(data.data()), int(data.size())));
+    d->memory = data;
+    d->memoryOwner = std::move(owner);
+    d->device.reset(d->buffer.get());
+}
+
+/*!
+  \overload
+
+  The \a data is shared with the resulting textures, it is not copied.
+*/
+void TextureIO::setData(const QByteArray &data)
+{
+    const auto owner = std::make_shared<const QByteArray>(data);
+    setData({reinterpret_cast<const uchar *>(owner->constData()), owner->size()}, owner);
+}
+
 /*!
   \property TextureIO::mimeType
   \brief This property holds the mime type that is set to this TextureIO object.
@@ -260,6 +413,60 @@ void TextureIO::setMimeType(QStringView mimeType)
     d->resetHandler();
 }
 
+/*!
+  \brief Returns the token that cancels the current operation.
+
+  \sa setCancelToken()
+*/
+TextureIO::CancelToken TextureIO::cancelToken() const
+{
+    Q_D(const TextureIO);
+    return d->cancelToken;
+}
+
+/*!
+  \brief Sets the \a token that cancels the current operation.
+
+  When another thread sets the token, the handler stops reading between subresources and chunks
+  of data, and the operation fails with TextureIOError::Canceled.
+
+  \code
+  auto canceled = std::make_shared<std::atomic_bool>(false);
+  TextureIO io(fileName);
+  io.setCancelToken(canceled);
+  // canceled->store(true) from another thread stops the read
+  const auto result = io.read();
+  \endcode
+*/
+void TextureIO::setCancelToken(CancelToken token)
+{
+    Q_D(TextureIO);
+    d->cancelToken = std::move(token);
+}
+
+/*!
+  \brief Returns the function that is called as the data is read.
+
+  \sa setProgressCallback()
+*/
+TextureIO::ProgressCallback TextureIO::progressCallback() const
+{
+    Q_D(const TextureIO);
+    return d->progressCallback;
+}
+
+/*!
+  \brief Sets the \a callback that is called with the number of bytes read and the size of the
+  device as the data is read.
+
+  The callback is called from the thread that reads the texture.
+*/
+void TextureIO::setProgressCallback(ProgressCallback callback)
+{
+    Q_D(TextureIO);
+    d->progressCallback = std::move(callback);
+}
+
 /*!
   \brief Reads the contents of an texture file.
 
@@ -275,7 +482,7 @@ TextureIO::ReadResult TextureIO::read()
 
     Texture texture;
     if (!d->handler->read(texture))
-        ok = TextureIOError::HandlerError;
+        ok = d->handlerError();
 
     if (!ok)
         return makeUnexpected(ok.error());
@@ -283,6 +490,214 @@ TextureIO::ReadResult TextureIO::read()
     return texture;
 }
 
+/*!
+  \brief Reads subresources of a texture file requested by the \a options.
+
+  Unrequested images are skipped, see TextureReadOptions for the layout of the result.
+
+  Returns the status of the operation.
+*/
+TextureIO::ReadResult TextureIO::read(const ReadOptions &options)
+{
+    Q_D(TextureIO);
+
+    auto ok = d->ensureHandlerCreated(Capability::CanRead);
+    if (!ok)
+        return makeUnexpected(ok.error());
+
+    Texture texture;
+    if (!d->handler->readPartial(texture, options))
+        ok = d->handlerError();
+
+    if (!ok)
+        return makeUnexpected(ok.error());
+
+    clearSkippedFaces(texture, options);
+    return texture;
+}
+
+/*!
+  \brief Reads a texture file into the existing \a texture with the given \a options.
+
+  If the \a texture is not null, the data is read into its storage without allocating, which
+  suits loops that read many files of the same layout, such as animation frames. The texture must
+  have the layout that read() returns for the file: the same format and dimensions as
+  TextureReadOptions::resultInfo() and the alignment used by the handler. The storage is only
+  reused if it is not shared with other copies of the texture. A null \a texture is allocated.
+
+  Returns TextureIOError::TextureMismatch if the format, the dimensions or the alignment don't
+  match. The layout is checked before the data is read. For sequential devices, only the alignment
+  can be checked in advance, a mismatch of the format or the dimensions is reported as
+  TextureIOError::HandlerError. If the read fails, the contents of the \a texture are
+  unspecified.
+*/
+TextureIOResult TextureIO::readInto(Texture &texture, const ReadOptions &options)
+{
+    Q_D(TextureIO);
+
+    const auto ok = d->ensureHandlerCreated(Capability::CanRead);
+    if (!ok)
+        return ok;
+
+    if (!texture.isNull() && texture.alignment() != d->handler->alignment())
+        return TextureIOError::TextureMismatch;
+
+    if (!texture.isNull() && !d->device->isSequential()) {
+        const auto position = d->device->pos();
+        TextureInfo info;
+        if (!d->handler->readInfo(info))
+            return d->handlerError();
+        if (!d->device->seek(position))
+            return TextureIOError::DeviceError;
+        const auto resultInfo = options.resultInfo(info);
+        if (!resultInfo.isNull() && resultInfo != TextureInfo(texture))
+            return TextureIOError::TextureMismatch;
+    }
+
+    if (!d->handler->readPartial(texture, options))
+        return d->handlerError();
+
+    clearSkippedFaces(texture, options);
+    return ok;
+}
+
+/*!
+  \brief Reads the format and the dimensions of a texture without reading its data.
+
+  Only the file header is parsed, so this is much cheaper than read() for large files. The device
+  position is restored afterwards unless the device is sequential, so read() can be called next.
+
+  Returns the status of the operation.
+*/
+TextureIO::ReadInfoResult TextureIO::readInfo()
+{
+    Q_D(TextureIO);
+
+    auto ok = d->ensureHandlerCreated(Capability::CanRead);
+    if (!ok)
+        return makeUnexpected(ok.error());
+
+    const auto position = d->device->pos();
+    TextureInfo info;
+    if (!d->handler->readInfo(info))
+        ok = d->handlerError();
+
+    if (!d->device->isSequential())
+        d->device->seek(position);
+
+    if (!ok)
+        return makeUnexpected(ok.error());
+
+    return info;
+}
+
+/*!
+  \enum TextureIO::LevelOrder
+  This enum describes the order in which readProgressive() delivers mipmap levels.
+
+  \value SmallestFirst The smallest level is delivered first, so a low-resolution preview is
+  available almost immediately.
+  \value LargestFirst The base level is delivered first.
+*/
+
+/*!
+  \typedef TextureIO::LevelCallback
+  A function that is called with the \c level index and a \c texture containing all layers and
+  faces of that level as a single-level texture.
+*/
+
+/*!
+  \brief Reads the contents of a texture file level by level in the given \a order.
+
+  The \a callback is called once for each level as soon as it is read, so the caller can show a
+  preview before the whole file is loaded. The callback is called from the thread that calls this
+  function.
+
+  Each level is read with a separate partial read, which requires a random-access device and a
+  handler that supports partial reads, see TextureIOHandler::supportsPartialRead(). Otherwise,
+  the whole texture is read once and then the levels are delivered in the requested order.
+
+  Returns the whole texture, or the status of the operation in case of an error.
+*/
+TextureIO::ReadResult TextureIO::readProgressive(const LevelCallback &callback, LevelOrder order)
+{
+    Q_D(TextureIO);
+
+    auto ok = d->ensureHandlerCreated(Capability::CanRead);
+    if (!ok)
+        return makeUnexpected(ok.error());
+
+    const auto levelAt = [order](Texture::size_type i, Texture::size_type levels)
+    {
+        return order == LevelOrder::SmallestFirst ? levels - 1 - i : i;
+    };
+
+    // reads the whole texture at once and delivers its levels from memory
+    const auto readAll = [d, &callback, &levelAt]() -> ReadResult
+    {
+        Texture texture;
+        if (!d->handler->read(texture))
+            return makeUnexpected(d->handlerError());
+        if (callback) {
+            const auto levels = texture.levels();
+            for (Texture::size_type i = 0; i < levels; ++i) {
+                const auto level = levelAt(i, levels);
+                callback(level, levels == 1 ? texture : copyLevel(texture, level));
+            }
+        }
+        return texture;
+    };
+
+    if (d->device->isSequential() || !d->handler->supportsPartialRead())
+        return readAll();
+
+    const auto position = d->device->pos();
+    TextureInfo info;
+    if (!d->handler->readInfo(info))
+        return makeUnexpected(d->handlerError());
+
+    if (!d->device->seek(position))
+        return makeUnexpected(TextureIOError::DeviceError);
+
+    const auto levels = info.levels();
+    if (levels == 1)
+        return readAll();
+
+    Texture result;
+    for (Texture::size_type i = 0; i < levels; ++i) {
+        const auto level = levelAt(i, levels);
+        if (!d->device->seek(position))
+            return makeUnexpected(TextureIOError::DeviceError);
+
+        ReadOptions options;
+        options.setLevels(level, 1);
+        Texture texture;
+        if (!d->handler->readPartial(texture, options))
+            return makeUnexpected(d->handlerError());
+
+        // alignment is only known after the first read, it depends on the handler
+        if (result.isNull()) {
+            result = Texture(info.format(), info.size(), info.dimensions(), texture.alignment());
+            if (result.isNull())
+                return makeUnexpected(TextureIOError::HandlerError);
+        }
+
+        for (Texture::size_type layer = 0; layer < texture.layers(); ++layer) {
+            for (Texture::size_type face = 0; face < texture.faces(); ++face) {
+                const auto side = Texture::Side(face);
+                const auto source = texture.constImageData({side, 0, layer});
+                const auto data = result.imageData({side, level, layer});
+                std::copy(source.begin(), source.end(), data.begin());
+            }
+        }
+
+        if (callback)
+            callback(level, texture);
+    }
+
+    return result;
+}
+
 /*!
   \brief Writes the given \a contents with the given \a options to the device.
 
@@ -296,7 +711,7 @@ TextureIO::WriteResult TextureIO::write(const Texture &contents)
         return ok;
 
     if (!d->handler->write(contents))
-        return TextureIOError::HandlerError;
+        return d->handlerError();
 
     if (d->file)
         d->file->flush();
@@ -330,3 +745,15 @@ QString TextureIO::pluginsDirPath()
     return QString();
 #endif
 }
+
+/*!
+  \brief Enables caching of plugin metadata in the file with the given \a path.
+
+  Plugins are indexed by their metadata on the first use of TextureIO. With the cache, the
+  metadata is not read from plugin files that haven't changed since the previous run, which
+  speeds up short-lived command line tools. Must be called before the first read or write.
+*/
+void TextureIO::setPluginIndexCachePath(const QString &path)
+{
+    TextureIOHandlerDatabase::setIndexCachePath(path);
+}
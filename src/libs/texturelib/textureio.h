@@ -3,20 +3,36 @@
 #include "texturelib_global.h"
 
 #include <TextureLib/Texture>
+#include <TextureLib/TextureIOHandler>
 #include <TextureLib/TextureIOHandlerPlugin>
+#include <TextureLib/TextureInfo>
+#include <TextureLib/TextureReadOptions>
 #include <TextureLib/TextureIOResult>
 
 #include <QtCore/QMimeType>
 #include <QtCore/QScopedPointer>
 #include <QtCore/QString>
+#include <QtCore/QStringList>
 
 #include <Expected>
 #include <ObserverPointer>
 
+#include <functional>
+
 QT_BEGIN_NAMESPACE
 class QIODevice;
 QT_END_NAMESPACE
 
+struct TextureReadManyOptions
+{
+    // threads that detect mime types and parse headers, 0 means QThread::idealThreadCount()
+    int cpuThreads {0};
+    // threads that read texture data
+    int ioThreads {2};
+    // bytes of textures that are read but not yet delivered, 0 means no limit
+    qint64 memoryBudget {0};
+};
+
 class TextureIOPrivate;
 class TEXTURELIB_EXPORT TextureIO
 {
@@ -37,12 +53,31 @@ public:
     explicit TextureIO(QIODevicePointer device, const QMimeType &mimeType = QMimeType());
     TextureIO(const QString &fileName, QStringView mimeType);
     TextureIO(QIODevicePointer device, QStringView mimeType);
+    TextureIO(
+            Texture::ConstData data,
+            TextureIOHandler::MemoryOwner owner,
+            const QMimeType &mimeType = QMimeType());
     ~TextureIO();
 
     TextureIO &operator=(TextureIO &&other) noexcept;
 
     using ReadResult = Expected<Texture, TextureIOError>;
+    using ReadInfoResult = Expected<TextureInfo, TextureIOError>;
+    using ReadOptions = TextureReadOptions;
+    using ReadManyOptions = TextureReadManyOptions;
+    using ReadManyCallback = std::function<void(qsizetype index, ReadResult result)>;
     using WriteResult = TextureIOResult;
+    using CancelToken = TextureIOHandler::CancelToken;
+    using ProgressCallback = TextureIOHandler::ProgressCallback;
+    using MemoryOwner = TextureIOHandler::MemoryOwner;
+
+    enum class LevelOrder {
+        SmallestFirst,
+        LargestFirst,
+    };
+    Q_ENUM(LevelOrder)
+
+    using LevelCallback = std::function<void(Texture::size_type level, const Texture &texture)>;
 
     QString fileName() const;
     void setFileName(const QString &fileName);
@@ -50,14 +85,42 @@ public:
     QIODevicePointer device() const;
     void setDevice(QIODevicePointer device);
 
+    void setData(Texture::ConstData data, MemoryOwner owner);
+    void setData(const QByteArray &data);
+
     QMimeType mimeType() const;
     void setMimeType(const QMimeType &mimeType);
     void setMimeType(QStringView mimeType);
 
+    CancelToken cancelToken() const;
+    void setCancelToken(CancelToken token);
+
+    ProgressCallback progressCallback() const;
+    void setProgressCallback(ProgressCallback callback);
+
     ReadResult read();
+    ReadResult read(const ReadOptions &options);
+    TextureIOResult readInto(Texture &texture, const ReadOptions &options = ReadOptions());
+    ReadInfoResult readInfo();
+    ReadResult readProgressive(
+            const LevelCallback &callback, LevelOrder order = LevelOrder::SmallestFirst);
 
     WriteResult write(const Texture &contents);
 
+    static std::vector<ReadResult> readMany(
+            const QStringList &fileNames, const ReadManyOptions &options = ReadManyOptions());
+    static std::vector<ReadResult> readMany(
+            gsl::span<const QIODevicePointer> devices,
+            const ReadManyOptions &options = ReadManyOptions());
+    static void readMany(
+            const QStringList &fileNames,
+            const ReadManyCallback &callback,
+            const ReadManyOptions &options = ReadManyOptions());
+    static void readMany(
+            gsl::span<const QIODevicePointer> devices,
+            const ReadManyCallback &callback,
+            const ReadManyOptions &options = ReadManyOptions());
+
     using Capability = TextureIOHandlerPlugin::Capability;
     using Capabilities = TextureIOHandlerPlugin::Capabilities;
     static std::vector<QStringView> availableMimeTypes(Capabilities caps = Capability::ReadWrite);
@@ -66,6 +129,7 @@ public:
     static gsl::span<const TextureFormat> writableFormats();
 
     static QString pluginsDirPath();
+    static void setPluginIndexCachePath(const QString &path);
 
 private:
     QScopedPointer<TextureIOPrivate> d_ptr;
@@ -0,0 +1,254 @@
+#include "textureio.h"
+
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QIODevice>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace {
+
+using ReadResult = TextureIO::ReadResult;
+using ReadManyCallback = TextureIO::ReadManyCallback;
+using ReadManyOptions = TextureIO::ReadManyOptions;
+
+// Reads textures in two stages. Mime type detection and header probing run in the CPU pool;
+// the probed size is then reserved from the memory budget and the data is read in the IO pool.
+// A CPU worker blocks while the budget is exhausted, which stops probing new files until
+// delivered textures free the budget. The header of a sequential device can't be read twice, so
+// such devices are not probed; they are read at once in the IO pool and the size of the result
+// is reserved afterwards.
+class BatchReader
+{
+public:
+    using MakeIO = std::function<TextureIO(qsizetype index)>;
+
+    BatchReader(const ReadManyCallback &callback, const ReadManyOptions &options);
+
+    void run(qsizetype count, const MakeIO &makeIO);
+
+private:
+    void probe(qsizetype index, const MakeIO &makeIO);
+    void read(qsizetype index, const std::shared_ptr<TextureIO> &io, qint64 bytes);
+    void readSequential(qsizetype index, const std::shared_ptr<TextureIO> &io);
+    void deliver(qsizetype index, ReadResult result);
+
+    void acquire(qint64 bytes);
+    void reserve(qint64 bytes);
+    void release(qint64 bytes);
+
+    const ReadManyCallback &m_callback;
+    const qint64 m_memoryBudget {0};
+
+    QThreadPool m_cpuPool;
+    QThreadPool m_ioPool;
+
+    std::mutex m_callbackMutex;
+
+    std::mutex m_memoryMutex;
+    std::condition_variable m_memoryReleased;
+    qint64 m_memoryInUse {0};
+};
+
+BatchReader::BatchReader(const ReadManyCallback &callback, const ReadManyOptions &options)
+    : m_callback(callback)
+    , m_memoryBudget(options.memoryBudget)
+{
+    m_cpuPool.setMaxThreadCount(
+            options.cpuThreads > 0 ? options.cpuThreads : QThread::idealThreadCount());
+    m_ioPool.setMaxThreadCount(std::max(1, options.ioThreads));
+}
+
+void BatchReader::run(qsizetype count, const MakeIO &makeIO)
+{
+    for (qsizetype index = 0; index < count; ++index)
+        QtConcurrent::run(&m_cpuPool, [this, index, &makeIO]() { probe(index, makeIO); });
+
+    // IO tasks are started by CPU tasks, so the IO pool is not empty until the CPU pool is done
+    m_cpuPool.waitForDone();
+    m_ioPool.waitForDone();
+}
+
+void BatchReader::probe(qsizetype index, const MakeIO &makeIO)
+{
+    auto io = std::make_shared<TextureIO>(makeIO(index));
+    const auto device = io->device();
+    if (device && device->isSequential()) {
+        QtConcurrent::run(&m_ioPool, [this, index, io]() { readSequential(index, io); });
+        return;
+    }
+
+    const auto info = io->readInfo();
+    if (!info) {
+        deliver(index, makeUnexpected(info.error()));
+        return;
+    }
+
+    const auto bytes = info->bytes(Texture::Alignment::Word);
+    acquire(bytes);
+    QtConcurrent::run(&m_ioPool, [this, index, io, bytes]() { read(index, io, bytes); });
+}
+
+void BatchReader::read(qsizetype index, const std::shared_ptr<TextureIO> &io, qint64 bytes)
+{
+    deliver(index, io->read());
+    release(bytes);
+}
+
+void BatchReader::readSequential(qsizetype index, const std::shared_ptr<TextureIO> &io)
+{
+    auto result = io->read();
+    const qint64 bytes = result ? result->bytes() : 0;
+    // the texture is already allocated, waiting for the budget here could block the IO tasks
+    // that free it
+    reserve(bytes);
+    deliver(index, std::move(result));
+    release(bytes);
+}
+
+void BatchReader::deliver(qsizetype index, ReadResult result)
+{
+    std::lock_guard<std::mutex> lock(m_callbackMutex);
+    m_callback(index, std::move(result));
+}
+
+void BatchReader::acquire(qint64 bytes)
+{
+    std::unique_lock<std::mutex> lock(m_memoryMutex);
+    if (m_memoryBudget > 0) {
+        // a texture bigger than the whole budget is read alone
+        m_memoryReleased.wait(lock, [this, bytes]()
+        {
+            return m_memoryInUse == 0 || m_memoryInUse + bytes <= m_memoryBudget;
+        });
+    }
+    m_memoryInUse += bytes;
+}
+
+void BatchReader::reserve(qint64 bytes)
+{
+    std::lock_guard<std::mutex> lock(m_memoryMutex);
+    m_memoryInUse += bytes;
+}
+
+void BatchReader::release(qint64 bytes)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_memoryMutex);
+        m_memoryInUse -= bytes;
+    }
+    m_memoryReleased.notify_all();
+}
+
+std::vector<ReadResult> collected(
+        qsizetype count,
+        const std::function<void(const ReadManyCallback &callback)> &readMany)
+{
+    std::vector<ReadResult> result(size_t(count), makeUnexpected(TextureIOError::DeviceError));
+    readMany([&result](qsizetype index, ReadResult texture)
+    {
+        result[size_t(index)] = std::move(texture);
+    });
+    return result;
+}
+
+} // namespace
+
+/*!
+  \class TextureReadManyOptions
+  \brief TextureReadManyOptions limits the concurrency and the memory usage of
+  TextureIO::readMany().
+
+  Reading a texture is split into two stages. The first stage detects the mime type and parses
+  the file header, it is mostly CPU bound and runs on \c cpuThreads threads. The second stage
+  allocates the texture and reads its data, it is IO bound and runs on \c ioThreads threads.
+
+  Before the second stage starts, the size of the texture is reserved from the
+  \c memoryBudget. When the budget is exhausted, header probing waits until delivered textures
+  free it, so the number of textures in flight is bounded by the memory rather than by the
+  number of files.
+
+  Sequential devices, such as pipes and sockets, can't be probed without consuming the header, so
+  they skip the first stage. Their textures are read in the second stage without waiting for the
+  budget and are accounted in it once they are read.
+*/
+
+/*!
+  \typedef TextureIO::ReadManyCallback
+  A function that is called with the \c index of a file in the batch and its read \c result.
+*/
+
+/*!
+  \brief Reads textures from the files with the given \a fileNames in parallel.
+
+  Returns the results in the same order as the \a fileNames. Files are read using bounded thread
+  pools according to the \a options; note that the memory budget only bounds textures that are
+  read but not yet stored in the resulting vector, use the overload that takes a callback to
+  process textures as they are read.
+*/
+std::vector<TextureIO::ReadResult> TextureIO::readMany(
+        const QStringList &fileNames, const ReadManyOptions &options)
+{
+    return collected(fileNames.size(), [&](const ReadManyCallback &callback)
+    {
+        readMany(fileNames, callback, options);
+    });
+}
+
+/*!
+  \brief Reads textures from the given \a devices in parallel.
+
+  Returns the results in the same order as the \a devices. Each device must only be used by this
+  function until it returns.
+*/
+std::vector<TextureIO::ReadResult> TextureIO::readMany(
+        gsl::span<const QIODevicePointer> devices, const ReadManyOptions &options)
+{
+    return collected(devices.size(), [&](const ReadManyCallback &callback)
+    {
+        readMany(devices, callback, options);
+    });
+}
+
+/*!
+  \brief Reads textures from the files with the given \a fileNames in parallel and passes them to
+  the \a callback as they are read.
+
+  The callback is called from worker threads, but never concurrently, so it doesn't need
+  additional synchronization. The memory reserved for a texture is freed from the budget when
+  the callback returns. This function returns when all files are read.
+*/
+void TextureIO::readMany(
+        const QStringList &fileNames,
+        const ReadManyCallback &callback,
+        const ReadManyOptions &options)
+{
+    BatchReader reader(callback, options);
+    reader.run(fileNames.size(), [&fileNames](qsizetype index)
+    {
+        return TextureIO(fileNames.at(int(index)));
+    });
+}
+
+/*!
+  \brief Reads textures from the given \a devices in parallel and passes them to the \a callback
+  as they are read.
+
+  \sa readMany()
+*/
+void TextureIO::readMany(
+        gsl::span<const QIODevicePointer> devices,
+        const ReadManyCallback &callback,
+        const ReadManyOptions &options)
+{
+    BatchReader reader(callback, options);
+    reader.run(devices.size(), [devices](qsizetype index)
+    {
+        return TextureIO(devices[index]);
+    });
+}
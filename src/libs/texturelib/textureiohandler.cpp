@@ -1,4 +1,21 @@
 #include "textureiohandler.h"
+#include "textureinfo.h"
+#include "texturereadoptions.h"
+
+#include <QtCore/QIODevice>
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+// Returns the alignment of texel data that is safe to read as whole words: the largest power of two
+// that divides the texel or the block size, up to 8 bytes
+static quintptr elementAlignment(TextureFormat format)
+{
+    const auto size = quintptr(TextureFormatInfo::formatInfo(format).size());
+    return std::min<quintptr>(size & (~size + 1), 8);
+}
 
 /*!
     \class TextureIOHandler
@@ -36,6 +53,93 @@ TextureIOHandler::~TextureIOHandler() noexcept = default;
     Specific error can be logged to the stderr.
 */
 
+/*!
+    Reimplement this function to read the format and the dimensions of a texture from the device
+    without reading its data.
+
+    The read header is stored to the given \a info. Should return true if the header is
+    successfully read; otherwise should return false.
+
+    The default implementation reads the whole texture using read().
+*/
+bool TextureIOHandler::readInfo(TextureInfo &info)
+{
+    Texture texture;
+    if (!read(texture))
+        return false;
+    info = TextureInfo(texture);
+    return true;
+}
+
+/*!
+    Reimplement this function to read only the subresources requested by the \a options.
+
+    The read data is stored to the given \a texture with the layout returned by
+    TextureReadOptions::resultInfo(). Should return true if the data is successfully read;
+    otherwise should return false. Implementations should skip unrequested images using skip(),
+    so IO and memory usage scale with the requested data.
+
+    The default implementation reads the whole texture using read() and copies the requested
+    subresources.
+
+    \sa prepareTexture()
+*/
+bool TextureIOHandler::readPartial(Texture &texture, const TextureReadOptions &options)
+{
+    if (options.readsAll())
+        return read(texture);
+
+    Texture source;
+    if (!read(source))
+        return false;
+
+    const TextureInfo sourceInfo(source);
+    const auto info = options.resultInfo(sourceInfo);
+    if (info.isNull())
+        return false;
+
+    if (!prepareTexture(texture, info, source.alignment()))
+        return false;
+
+    for (int layer = 0; layer < source.layers(); ++layer) {
+        for (int level = 0; level < source.levels(); ++level) {
+            for (int face = 0; face < source.faces(); ++face) {
+                const Texture::ArrayIndex index(Texture::Side(face), level, layer);
+                if (!options.contains(sourceInfo, index))
+                    continue;
+                const auto data = source.imageData(index);
+                std::memcpy(texture.imageData(options.mapped(sourceInfo, index)).data(),
+                            data.data(),
+                            size_t(data.size()));
+            }
+        }
+    }
+
+    return true;
+}
+
+/*!
+    Reimplement this function to return true if readPartial() reads only the requested data.
+
+    TextureIO::readProgressive() reads levels one by one only if this returns true; otherwise, the
+    whole texture is read once. The default implementation returns false.
+*/
+bool TextureIOHandler::supportsPartialRead() const noexcept
+{
+    return false;
+}
+
+/*!
+    Reimplement this function to return the line alignment of the textures read by this handler.
+
+    TextureIO::readInto() uses it to check the layout of the provided texture before reading. The
+    default implementation returns Texture::Alignment::Byte.
+*/
+Texture::Alignment TextureIOHandler::alignment() const noexcept
+{
+    return Texture::Alignment::Byte;
+}
+
 /*!
     Reimplement this function to write the given \a texture data to the device.
 
@@ -50,3 +154,192 @@ bool TextureIOHandler::write(const Texture &texture)
     Q_UNUSED(texture);
     return false;
 }
+
+/*!
+    \typedef TextureIOHandler::CancelToken
+    A shared flag that is set by another thread to cancel the current operation.
+*/
+
+/*!
+    \typedef TextureIOHandler::ProgressCallback
+    A function that is called with the number of bytes read and the total number of bytes of the
+    device, the total is 0 for sequential devices.
+*/
+
+/*!
+    \fn bool TextureIOHandler::isCanceled() const noexcept
+    Returns true if the current operation is canceled via the cancelToken().
+
+    Implementations should check this between subresources and return false as soon as possible.
+*/
+
+/*!
+    Reads \a size bytes to the \a data in chunks of ChunkSize bytes.
+
+    Cancellation is checked and progress is reported after each chunk, so large images do not
+    delay cancellation. Returns false if the device has not enough data or if the operation is
+    canceled.
+*/
+bool TextureIOHandler::readData(char *data, qint64 size)
+{
+    while (size > 0) {
+        if (isCanceled())
+            return false;
+        const auto chunk = std::min(size, ChunkSize);
+        if (m_device->read(data, chunk) != chunk)
+            return false;
+        data += chunk;
+        size -= chunk;
+        reportProgress();
+    }
+    return true;
+}
+
+/*!
+    Skips \a size bytes of the device.
+
+    Seeks if the device is random-access, which includes files and memory buffers; otherwise
+    reads and discards the data. Returns true on success.
+*/
+bool TextureIOHandler::skip(qint64 size)
+{
+    if (size <= 0)
+        return size == 0;
+
+    if (!m_device->isSequential())
+        return m_device->seek(m_device->pos() + size);
+
+    char buffer[4096];
+    while (size > 0) {
+        if (isCanceled())
+            return false;
+        const auto read = m_device->read(buffer, std::min<qint64>(size, sizeof(buffer)));
+        if (read <= 0)
+            return false;
+        size -= read;
+    }
+    return true;
+}
+
+/*!
+    Writes the given \a chunks to the device one after another.
+
+    Chunks smaller than ChunkSize, such as headers and small mipmap levels, are gathered into a
+    single buffer, so a whole file of them takes a few device writes instead of one per chunk,
+    which matters for unbuffered devices. Larger chunks are written directly without copying.
+    Returns false if not all data is written.
+*/
+bool TextureIOHandler::writeData(gsl::span<const Texture::ConstData> chunks)
+{
+    const auto total = std::accumulate(chunks.begin(), chunks.end(), qint64(0),
+            [](qint64 size, Texture::ConstData chunk) { return size + chunk.size(); });
+
+    std::vector<char> buffer;
+    buffer.reserve(size_t(std::min(total, ChunkSize)));
+
+    const auto write = [this](const char *data, qint64 size)
+    {
+        return m_device->write(data, size) == size;
+    };
+
+    const auto flush = [&buffer, &write]()
+    {
+        const auto ok = write(buffer.data(), qint64(buffer.size()));
+        buffer.clear();
+        return ok;
+    };
+
+    for (const auto chunk: chunks) {
+        const auto data = reinterpret_cast<const char *>(chunk.data());
+        if (qint64(buffer.size()) + chunk.size() > ChunkSize && !buffer.empty() && !flush())
+            return false;
+        if (chunk.size() >= ChunkSize) {
+            if (!write(data, chunk.size()))
+                return false;
+            continue;
+        }
+        buffer.insert(buffer.end(), data, data + chunk.size());
+    }
+
+    return buffer.empty() || flush();
+}
+
+/*!
+    Prepares the \a texture to store data with the layout described by the \a info and the given
+    \a align.
+
+    A null texture is allocated. A texture that is not null is storage provided by the caller, see
+    TextureIO::readInto(); it is reused as is if its layout matches, so reading into it doesn't
+    allocate unless its data is shared. Returns false if the texture can't be allocated or its
+    layout doesn't match.
+*/
+bool TextureIOHandler::prepareTexture(
+        Texture &texture, const TextureInfo &info, Texture::Alignment align)
+{
+    if (!texture.isNull()) {
+        if (TextureInfo(texture) != info || texture.alignment() != align) {
+            qCWarning(::texture) << "Texture layout doesn't match the file";
+            return false;
+        }
+        return true;
+    }
+
+    texture = Texture(info.format(), info.size(), info.dimensions(), align);
+    if (texture.isNull()) {
+        qCWarning(::texture) << "Can't create texture, file is too big or corrupted";
+        return false;
+    }
+    return true;
+}
+
+/*!
+    Makes the \a texture reference the data at the current device position instead of reading it.
+
+    This is only possible if the device contents are the memory() set by TextureIO and the
+    texture is null. The data must be stored exactly in the layout of a texture described by the
+    \a info and the \a align, see Texture::imageData(), and be aligned in memory so texels or
+    blocks can be read as whole words. The texture is read-only and keeps the
+    memoryOwner() alive, it is copied on the first write. On success, the device is advanced past
+    the data.
+
+    Returns false if the data can't be referenced; nothing is consumed then and the data should be
+    read as usual.
+*/
+bool TextureIOHandler::mapTexture(
+        Texture &texture, const TextureInfo &info, Texture::Alignment align)
+{
+    if (!texture.isNull() || m_memory.empty())
+        return false;
+
+    const auto position = m_device->pos();
+    const auto size = info.bytes(align);
+    if (position < 0 || size <= 0 || position + size > qint64(m_memory.size()))
+        return false;
+
+    const auto alignment = elementAlignment(info.format());
+    if (alignment == 0 || quintptr(m_memory.data() + position) % alignment != 0)
+        return false;
+
+    auto result = Texture::fromRawData(
+            m_memory.subspan(position, size),
+            [owner = m_memoryOwner](uchar[]) {},
+            info.format(),
+            info.size(),
+            info.dimensions(),
+            align);
+    if (result.isNull() || !m_device->seek(position + size))
+        return false;
+
+    reportProgress();
+    texture = std::move(result);
+    return true;
+}
+
+/*!
+    Reports the current position of the device to the progressCallback().
+*/
+void TextureIOHandler::reportProgress()
+{
+    if (m_progressCallback)
+        m_progressCallback(m_device->pos(), m_device->isSequential() ? 0 : m_device->size());
+}
@@ -1,20 +1,29 @@
 #pragma once
 
 #include "texturelib_global.h"
+#include "texture.h"
 
 #include <ObserverPointer>
 
+#include <atomic>
+#include <functional>
+#include <memory>
+
 QT_BEGIN_NAMESPACE
 class QIODevice;
 QT_END_NAMESPACE
 
-class Texture;
+class TextureInfo;
+class TextureReadOptions;
 
 class TEXTURELIB_EXPORT TextureIOHandler
 {
     Q_DISABLE_COPY(TextureIOHandler)
 public:
     using QIODevicePointer = ObserverPointer<QIODevice>;
+    using CancelToken = std::shared_ptr<const std::atomic_bool>;
+    using ProgressCallback = std::function<void(qint64 bytesRead, qint64 bytesTotal)>;
+    using MemoryOwner = std::shared_ptr<const void>;
 
     TextureIOHandler() noexcept = default;
     TextureIOHandler(TextureIOHandler &&) noexcept = default;
@@ -25,9 +34,39 @@ public:
     QIODevicePointer device() const noexcept { return m_device; }
     void setDevice(QIODevicePointer device) noexcept { m_device = device; }
 
+    CancelToken cancelToken() const noexcept { return m_cancelToken; }
+    void setCancelToken(CancelToken token) noexcept { m_cancelToken = std::move(token); }
+    bool isCanceled() const noexcept { return m_cancelToken && *m_cancelToken; }
+
+    ProgressCallback progressCallback() const { return m_progressCallback; }
+    void setProgressCallback(ProgressCallback callback) { m_progressCallback = std::move(callback); }
+
+    Texture::ConstData memory() const noexcept { return m_memory; }
+    MemoryOwner memoryOwner() const noexcept { return m_memoryOwner; }
+    void setMemory(Texture::ConstData memory, MemoryOwner owner) noexcept
+    { m_memory = memory; m_memoryOwner = std::move(owner); }
+
     virtual bool read(Texture &texture) = 0;
+    virtual bool readInfo(TextureInfo &info);
+    virtual bool readPartial(Texture &texture, const TextureReadOptions &options);
+    virtual bool supportsPartialRead() const noexcept;
+    virtual Texture::Alignment alignment() const noexcept;
     virtual bool write(const Texture &texture);
 
+protected:
+    static constexpr qint64 ChunkSize = 1024 * 1024;
+
+    bool readData(char *data, qint64 size);
+    bool skip(qint64 size);
+    bool writeData(gsl::span<const Texture::ConstData> chunks);
+    bool prepareTexture(Texture &texture, const TextureInfo &info, Texture::Alignment align);
+    bool mapTexture(Texture &texture, const TextureInfo &info, Texture::Alignment align);
+    void reportProgress();
+
 private:
     QIODevicePointer m_device;
+    CancelToken m_cancelToken;
+    ProgressCallback m_progressCallback;
+    Texture::ConstData m_memory;
+    MemoryOwner m_memoryOwner;
 };
@@ -1,66 +1,137 @@
 #include "textureiohandlerdatabase.h"
 
 #include <QtCore/QCoreApplication>
+#include <QtCore/QDateTime>
 #include <QtCore/QDebug>
 #include <QtCore/QDir>
+#include <QtCore/QFileInfo>
 #include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QMetaEnum>
 #include <QtCore/QMimeDatabase>
 #include <QtCore/QPluginLoader>
+#include <QtCore/QSaveFile>
 
-TextureIOHandlerDatabase::TextureIOHandlerDatabase()
+#include <algorithm>
+
+namespace {
+
+using Capability = TextureIOHandlerPlugin::Capability;
+using Capabilities = TextureIOHandlerPlugin::Capabilities;
+using FormatCapabilites = TextureIOHandlerPlugin::FormatCapabilites;
+
+Q_GLOBAL_STATIC(QString, globalIndexCachePath)
+
+Capabilities capabilitiesFromJson(const QJsonArray &array)
 {
-    for (auto staticPlugin : QPluginLoader::staticPlugins()) {
-        auto plugin = staticPlugin.instance();
-        auto handlerPlugin = qobject_cast<TextureIOHandlerPlugin *>(plugin);
-        if (!handlerPlugin)
-            continue;
+    Capabilities result;
+    for (const auto &value: array) {
+        const auto name = value.toString();
+        if (name == QLatin1String("CanRead"))
+            result |= Capability::CanRead;
+        else if (name == QLatin1String("CanWrite"))
+            result |= Capability::CanWrite;
+        else
+            qWarning() << "TextureIOHandlerDatabase: unknown capability" << name;
+    }
+    return result;
+}
+
+// Returns false if the metadata doesn't declare formats, so the plugin has to be loaded
+bool formatsFromJson(const QJsonObject &metaData, std::vector<FormatCapabilites> &formats)
+{
+    const auto value = metaData.value(QLatin1String("Formats"));
+    if (!value.isArray())
+        return false;
 
-        const auto metaData = staticPlugin.metaData().value("MetaData").toObject();
-        const auto mimeTypes = metaData.value("MimeTypes").toArray();
-        for (const auto &mimeType : mimeTypes) {
-            registerPlugin(mimeType.toString(), handlerPlugin);
+    const auto formatEnum = QMetaEnum::fromType<TextureFormat>();
+    for (const auto &item: value.toArray()) {
+        const auto object = item.toObject();
+        const auto name = object.value(QLatin1String("Format")).toString().toLatin1();
+        bool ok = false;
+        const auto format = formatEnum.keyToValue(name.constData(), &ok);
+        if (!ok) {
+            qWarning() << "TextureIOHandlerDatabase: unknown format" << name;
+            continue;
         }
+        formats.push_back({
+                TextureFormat(format),
+                capabilitiesFromJson(object.value(QLatin1String("Capabilities")).toArray())});
     }
+    return true;
+}
 
-    for (const auto &folder : qApp->libraryPaths()) {
-        QDir dir(folder);
-        if (!dir.cd("textureformats"))
-            continue;
-        for (const auto &fileName : dir.entryList(QDir::Files)) {
-            auto loader = std::make_unique<QPluginLoader>(dir.absoluteFilePath(fileName));
-            const auto metaData = loader->metaData().value("MetaData").toObject();
-            const auto mimeTypes = metaData.value("MimeTypes").toArray();
-            if (mimeTypes.isEmpty()) {
-                qWarning() << "File" << dir.absoluteFilePath(fileName)
-                           << "does not contain 'MimeTypes' key";
-                continue;
-            }
-            const auto plugin = loader->instance();
-            if (!plugin) {
-                qWarning() << "File" << dir.absoluteFilePath(fileName) << "is not a Qt plugin";
-                continue;
-            }
+// The cache maps absolute plugin paths to their metadata, an entry is valid while the plugin
+// file has the same size and modification time
+QJsonObject readIndexCache(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    return QJsonDocument::fromJson(file.readAll()).object();
+}
 
-            auto handlerPlugin = qobject_cast<TextureIOHandlerPlugin *>(plugin);
-            if (!handlerPlugin) {
-                qWarning() << "File" << dir.absoluteFilePath(fileName)
-                           << "does not contain an textureformat plugin";
-                continue;
-            }
-            for (const auto &mimeTypeName : mimeTypes) {
-                registerPlugin(mimeTypeName.toString(), handlerPlugin);
-            }
-            loaders.push_back(std::move(loader));
-        }
+void writeIndexCache(const QString &path, const QJsonObject &cache)
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "TextureIOHandlerDatabase: can't write plugin index cache" << path;
+        return;
     }
+    file.write(QJsonDocument(cache).toJson(QJsonDocument::Compact));
+    file.commit();
+}
+
+QJsonObject fileStamp(const QFileInfo &info)
+{
+    return {
+        {QStringLiteral("size"), double(info.size())},
+        {QStringLiteral("lastModified"), double(info.lastModified().toMSecsSinceEpoch())}
+    };
+}
+
+} // namespace
+
+/*!
+    \class TextureIOHandlerDatabase
+    \internal
+
+    The database indexes plugins by their JSON metadata, so plugins are only loaded when one of
+    their mime types is requested. Besides the required "MimeTypes" key, the metadata can
+    declare "Capabilities" (a list of "CanRead" and "CanWrite" flags that apply to all mime
+    types of the plugin) and "Formats" (a list of objects with "Format" and "Capabilities"
+    keys). Plugins that omit these keys are loaded when the corresponding information is
+    requested.
+
+    The metadata can also declare "Magic", a list of hex-encoded signatures that files of the
+    plugin's mime types start with. Signatures allow to detect the format of a file without
+    QMimeDatabase, see mimeTypeForHeader().
+*/
+
+TextureIOHandlerDatabase::TextureIOHandlerDatabase()
+{
+    for (auto staticPlugin : QPluginLoader::staticPlugins()) {
+        auto entry = std::make_unique<Entry>();
+        entry->staticPlugin = staticPlugin;
+        entry->metaData = staticPlugin.metaData().value(QLatin1String("MetaData")).toObject();
+        // static plugins of other types are compiled in as well, they have no mime types
+        if (entry->metaData.value(QLatin1String("MimeTypes")).toArray().isEmpty())
+            continue;
+        addEntry(std::move(entry));
+    }
+
+    indexDynamicPlugins();
 }
 
 TextureIOHandlerDatabase::~TextureIOHandlerDatabase()
 {
     // TODO (abbapoh): should we unload plugins?..
     // What is the current Qt policy with those awful QStringLiteral crashes?..
-    for (const auto &loader: loaders)
-        loader->unload();
+    for (const auto &entry: m_entries) {
+        if (entry->loader)
+            entry->loader->unload();
+    }
 }
 
 std::unique_ptr<TextureIOHandler> TextureIOHandlerDatabase::create(QIODevicePointer device, QStringView mimeType, Capabilities caps)
@@ -71,7 +142,7 @@ std::unique_ptr<TextureIOHandler> TextureIOHandlerDatabase::create(QIODevicePoin
         return result;
     }
 
-    auto plugin = map.value(mimeType.toString());
+    auto plugin = this->plugin(mimeType.toString());
     if (!plugin)
         return result;
 
@@ -90,19 +161,64 @@ std::unique_ptr<TextureIOHandler> TextureIOHandlerDatabase::create(QIODevicePoin
 
 std::vector<QStringView> TextureIOHandlerDatabase::availableMimeTypes(Capabilities caps) const
 {
+    QWriteLocker locker(&m_lock); // plugins without declared capabilities are loaded
     std::vector<QStringView> result;
     for (auto it = map.begin(), end = map.end(); it != end; it++) {
         const auto mt = QStringView(it.key());
-        if (it.value()->capabilities(mt) & caps)
+        if (capabilities(it.key(), *it.value()) & caps)
             result.push_back(mt);
     }
     std::sort(result.begin(), result.end());
     return result;
 }
 
+/*!
+    Returns the plugin that handles the given \a mimeType, loading it if needed.
+*/
 TextureIOHandlerPlugin *TextureIOHandlerDatabase::plugin(const QString &mimeType) const
 {
-    return map.value(mimeType);
+    {
+        QReadLocker locker(&m_lock);
+        const auto entry = map.value(mimeType);
+        if (!entry)
+            return nullptr;
+        if (entry->instance || entry->failed)
+            return entry->instance;
+    }
+
+    QWriteLocker locker(&m_lock);
+    const auto entry = map.value(mimeType);
+    return entry ? load(*entry) : nullptr;
+}
+
+/*!
+    Returns the name of the mime type whose declared signature the \a header starts with.
+
+    Returns an empty string if no signature matches, or if signatures of different mime types
+    match, so the caller can fall back to QMimeDatabase.
+*/
+QString TextureIOHandlerDatabase::mimeTypeForHeader(const QByteArray &header) const
+{
+    QReadLocker locker(&m_lock);
+    QString result;
+    for (const auto &magic: m_magics) {
+        if (!header.startsWith(magic.bytes) || magic.mimeType == result)
+            continue;
+        if (!result.isEmpty())
+            return QString(); // ambiguous
+        result = magic.mimeType;
+    }
+    return result;
+}
+
+/*!
+    Returns the size of the longest declared signature, that is the number of bytes
+    mimeTypeForHeader() needs.
+*/
+qsizetype TextureIOHandlerDatabase::maxMagicSize() const
+{
+    QReadLocker locker(&m_lock);
+    return m_maxMagicSize;
 }
 
 void TextureIOHandlerDatabase::registerPlugin(const QString &mimeType, TextureIOHandlerPlugin *plugin)
@@ -118,23 +234,197 @@ void TextureIOHandlerDatabase::registerPlugin(const QString &mimeType, TextureIO
         return;
     }
 
-    const auto caps = plugin->formatCapabilites(mimeType);
-    m_readableFormats.reserve(m_readableFormats.size() + size_t(caps.size()));
-    m_writableFormats.reserve(m_writableFormats.size() + size_t(caps.size()));
-    for (const auto &cap: caps) {
-        if (cap.capabilities & TextureIOHandlerPlugin::Capability::CanRead)
-            m_readableFormats.push_back(cap.format);
-        if (cap.capabilities & TextureIOHandlerPlugin::Capability::CanWrite)
-            m_writableFormats.push_back(cap.format);
-    }
-    std::sort(m_readableFormats.begin(), m_readableFormats.end());
-    std::sort(m_writableFormats.begin(), m_writableFormats.end());
+    auto entry = std::make_unique<Entry>();
+    entry->instance = plugin;
+    entry->metaData.insert(QStringLiteral("MimeTypes"), QJsonArray{mimeType});
 
-    map.insert(mimeType, plugin);
+    QWriteLocker locker(&m_lock);
+    addEntry(std::move(entry));
+    m_formatsCollected = false;
 }
 
+/*!
+    Returns the formats that can be read by the available plugins.
+
+    The returned span is invalidated by registerPlugin().
+*/
+gsl::span<const TextureFormat> TextureIOHandlerDatabase::readableFormats()
+{
+    ensureFormatsCollected();
+    return m_readableFormats;
+}
+
+/*!
+    Returns the formats that can be written by the available plugins.
+
+    The returned span is invalidated by registerPlugin().
+*/
+gsl::span<const TextureFormat> TextureIOHandlerDatabase::writableFormats()
+{
+    ensureFormatsCollected();
+    return m_writableFormats;
+}
+
+/*!
+    Returns the path of the file that caches metadata of dynamic plugins.
+
+    \sa setIndexCachePath()
+*/
+QString TextureIOHandlerDatabase::indexCachePath()
+{
+    return *globalIndexCachePath;
+}
+
+/*!
+    Sets the \a path of the file that caches metadata of dynamic plugins between runs.
+
+    Reading the metadata requires opening each plugin file; with the cache, only the size and the
+    modification time of the files are checked. The cache is disabled when the \a path is empty,
+    which is the default. This function should be called before the first use of the database.
+*/
+void TextureIOHandlerDatabase::setIndexCachePath(const QString &path)
+{
+    *globalIndexCachePath = path;
+}
+
+/*!
+    Returns the global database.
+
+    The database is created on the first call in a thread-safe way. Its functions can be called
+    from several threads concurrently; the spans returned by readableFormats() and
+    writableFormats() are invalidated by registerPlugin().
+*/
 TextureIOHandlerDatabase *TextureIOHandlerDatabase::instance()
 {
     static TextureIOHandlerDatabase staticInstance;
     return &staticInstance;
 }
+
+void TextureIOHandlerDatabase::addEntry(std::unique_ptr<Entry> entry)
+{
+    const auto mimeTypes = entry->metaData.value(QLatin1String("MimeTypes")).toArray();
+    const auto magics = entry->metaData.value(QLatin1String("Magic")).toArray();
+    for (const auto &mimeType: mimeTypes) {
+        map.insert(mimeType.toString(), entry.get());
+        for (const auto &magic: magics) {
+            const auto bytes = QByteArray::fromHex(magic.toString().toLatin1());
+            if (bytes.isEmpty())
+                continue;
+            m_magics.push_back({bytes, mimeType.toString()});
+            m_maxMagicSize = std::max<qsizetype>(m_maxMagicSize, bytes.size());
+        }
+    }
+    m_entries.push_back(std::move(entry));
+}
+
+void TextureIOHandlerDatabase::indexDynamicPlugins()
+{
+    const auto cachePath = indexCachePath();
+    const auto cache = cachePath.isEmpty() ? QJsonObject() : readIndexCache(cachePath);
+    QJsonObject newCache;
+
+    for (const auto &folder : QCoreApplication::libraryPaths()) {
+        QDir dir(folder);
+        if (!dir.cd("textureformats"))
+            continue;
+        for (const auto &fileInfo : dir.entryInfoList(QDir::Files)) {
+            const auto filePath = fileInfo.absoluteFilePath();
+            const auto stamp = fileStamp(fileInfo);
+
+            auto entry = std::make_unique<Entry>();
+            entry->fileName = filePath;
+
+            const auto cached = cache.value(filePath).toObject();
+            if (!cached.isEmpty() && cached.value(QLatin1String("stamp")).toObject() == stamp) {
+                entry->metaData = cached.value(QLatin1String("metaData")).toObject();
+            } else {
+                entry->loader = std::make_unique<QPluginLoader>(filePath);
+                entry->metaData =
+                        entry->loader->metaData().value(QLatin1String("MetaData")).toObject();
+            }
+
+            if (!cachePath.isEmpty()) {
+                newCache.insert(filePath, QJsonObject{
+                        {QStringLiteral("stamp"), stamp},
+                        {QStringLiteral("metaData"), entry->metaData}});
+            }
+
+            if (entry->metaData.value(QLatin1String("MimeTypes")).toArray().isEmpty()) {
+                qWarning() << "File" << filePath << "does not contain 'MimeTypes' key";
+                continue;
+            }
+            addEntry(std::move(entry));
+        }
+    }
+
+    if (!cachePath.isEmpty() && newCache != cache)
+        writeIndexCache(cachePath, newCache);
+}
+
+// Must be called with the write lock held
+TextureIOHandlerPlugin *TextureIOHandlerDatabase::load(Entry &entry) const
+{
+    if (entry.instance || entry.failed)
+        return entry.instance;
+
+    QObject *object = nullptr;
+    if (entry.fileName.isEmpty()) {
+        object = entry.staticPlugin.instance();
+    } else {
+        if (!entry.loader)
+            entry.loader = std::make_unique<QPluginLoader>(entry.fileName);
+        object = entry.loader->instance();
+        if (!object)
+            qWarning() << "File" << entry.fileName << "is not a Qt plugin";
+    }
+
+    entry.instance = qobject_cast<TextureIOHandlerPlugin *>(object);
+    if (!entry.instance) {
+        if (object) {
+            qWarning() << "File" << entry.fileName
+                       << "does not contain an textureformat plugin";
+        }
+        entry.failed = true;
+    }
+    return entry.instance;
+}
+
+// Must be called with the write lock held
+auto TextureIOHandlerDatabase::capabilities(const QString &mimeType, Entry &entry) const
+        -> Capabilities
+{
+    const auto value = entry.metaData.value(QLatin1String("Capabilities"));
+    if (value.isArray())
+        return capabilitiesFromJson(value.toArray());
+
+    const auto plugin = load(entry);
+    return plugin ? plugin->capabilities(mimeType) : Capabilities();
+}
+
+void TextureIOHandlerDatabase::ensureFormatsCollected()
+{
+    QWriteLocker locker(&m_lock);
+    if (m_formatsCollected)
+        return;
+
+    m_readableFormats.clear();
+    m_writableFormats.clear();
+    for (auto it = map.begin(), end = map.end(); it != end; it++) {
+        std::vector<FormatCapabilites> formats;
+        if (!formatsFromJson(it.value()->metaData, formats)) {
+            if (const auto plugin = load(*it.value())) {
+                const auto caps = plugin->formatCapabilites(it.key());
+                formats.assign(caps.begin(), caps.end());
+            }
+        }
+        for (const auto &caps: formats) {
+            if (caps.capabilities & Capability::CanRead)
+                m_readableFormats.push_back(caps.format);
+            if (caps.capabilities & Capability::CanWrite)
+                m_writableFormats.push_back(caps.format);
+        }
+    }
+    std::sort(m_readableFormats.begin(), m_readableFormats.end());
+    std::sort(m_writableFormats.begin(), m_writableFormats.end());
+    m_formatsCollected = true;
+}
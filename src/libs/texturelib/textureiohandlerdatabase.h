@@ -6,11 +6,12 @@
 #include <TextureLib/TextureIOHandlerPlugin>
 
 #include <QtCore/QHash>
+#include <QtCore/QJsonObject>
+#include <QtCore/QPluginLoader>
+#include <QtCore/QReadWriteLock>
 
 #include <memory>
 
-class QPluginLoader;
-
 class TEXTURELIB_EXPORT TextureIOHandlerDatabase
 {
     Q_DISABLE_COPY(TextureIOHandlerDatabase)
@@ -27,16 +28,48 @@ public:
     std::unique_ptr<TextureIOHandler> create(QIODevicePointer device, QStringView mimeType, Capabilities caps);
     std::vector<QStringView> availableMimeTypes(Capabilities caps) const;
     TextureIOHandlerPlugin *plugin(const QString &mimeType) const;
+    QString mimeTypeForHeader(const QByteArray &header) const;
+    qsizetype maxMagicSize() const;
     void registerPlugin(const QString &mimeType, TextureIOHandlerPlugin *plugin);
 
-    gsl::span<const TextureFormat> readableFormats() { return m_readableFormats; }
-    gsl::span<const TextureFormat> writableFormats() { return m_writableFormats; }
+    gsl::span<const TextureFormat> readableFormats();
+    gsl::span<const TextureFormat> writableFormats();
+
+    static QString indexCachePath();
+    static void setIndexCachePath(const QString &path);
 
     static TextureIOHandlerDatabase *instance();
 
 private:
-    QHash<QString, TextureIOHandlerPlugin *> map;
+    struct Entry
+    {
+        QStaticPlugin staticPlugin {};
+        QString fileName;
+        QJsonObject metaData;
+        std::unique_ptr<QPluginLoader> loader;
+        TextureIOHandlerPlugin *instance {nullptr};
+        bool failed {false};
+    };
+
+    struct Magic
+    {
+        QByteArray bytes;
+        QString mimeType;
+    };
+
+    void addEntry(std::unique_ptr<Entry> entry);
+    void indexDynamicPlugins();
+    TextureIOHandlerPlugin *load(Entry &entry) const;
+    Capabilities capabilities(const QString &mimeType, Entry &entry) const;
+    void ensureFormatsCollected();
+
+    // guards the members below, the database is shared between threads that read textures
+    mutable QReadWriteLock m_lock;
+    std::vector<std::unique_ptr<Entry>> m_entries;
+    QHash<QString, Entry *> map;
+    std::vector<Magic> m_magics;
+    qsizetype m_maxMagicSize {0};
+    bool m_formatsCollected {false};
     std::vector<TextureFormat> m_readableFormats;
     std::vector<TextureFormat> m_writableFormats;
-    std::vector<std::unique_ptr<QPluginLoader>> loaders;
 };
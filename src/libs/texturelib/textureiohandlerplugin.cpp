@@ -8,6 +8,10 @@
     Plugins serve as factories for TextureIOHandler objects.
 
     Each plugin can support multiple mime types with different capabilities.
+
+    A plugin is shared by all threads that read or write textures, so capabilities(), create()
+    and formatCapabilites() must be reentrant. Each created handler is used by one thread at a
+    time.
 */
 
 /*!
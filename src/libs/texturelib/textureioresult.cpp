@@ -16,6 +16,11 @@
     \var TextureIOError HandlerError
     An error occured within a handler, which means that data is corrupted (when reading) or the
     passed texture can't be saved (when writing). See stderr to see the details.
+    \var TextureIOError Canceled
+    The operation was canceled via the cancel token set by TextureIO::setCancelToken().
+    \var TextureIOError TextureMismatch
+    The texture passed to TextureIO::readInto() has a different format, dimensions or alignment
+    than the file.
 */
 
 /*!
@@ -35,6 +40,10 @@ QString toUserString(TextureIOError status)
         return TextureIOResult::tr("Unsupported format");
     case TextureIOError::HandlerError:
         return TextureIOResult::tr("Handler error");
+    case TextureIOError::Canceled:
+        return TextureIOResult::tr("Canceled");
+    case TextureIOError::TextureMismatch:
+        return TextureIOResult::tr("Texture doesn't match the file");
     }
     return QString();
 }
@@ -14,6 +14,8 @@ enum class TextureIOError
     DeviceError,
     UnsupportedMimeType,
     HandlerError,
+    Canceled,
+    TextureMismatch,
 };
 
 QString TEXTURELIB_EXPORT toUserString(TextureIOError status);
@@ -1,5 +1,24 @@
 #include "texturemodel.h"
 
+namespace {
+
+// Formats the statistics of all channels as "red, green, blue, alpha"
+template<typename Getter>
+QString channelsToString(const TextureStatistics &statistics, Getter getter)
+{
+    if (statistics.isNull())
+        return QString();
+
+    QStringList result;
+    for (int c = 0; c < TextureStatistics::ChannelCount; ++c) {
+        const auto &channel = statistics.channel(TextureStatistics::ChannelIndex(c));
+        result.append(QString::number(getter(channel), 'g', 4));
+    }
+    return result.join(QStringLiteral(", "));
+}
+
+} // namespace
+
 TextureModel::TextureModel(QObject *parent) :
     QAbstractTableModel(parent)
 {
@@ -17,14 +36,43 @@ void TextureModel::setTexture(const Texture& contents)
 
     beginResetModel();
     m_texture = contents;
+    m_info = TextureInfo(contents);
+    m_statistics = {};
+    m_statisticsValid = false;
+    endResetModel();
+}
+
+/*!
+  \brief Returns the info of the current texture or the info set by setInfo().
+*/
+TextureInfo TextureModel::info() const
+{
+    return m_info;
+}
+
+/*!
+  \brief Shows the given \a info without texture data, e.g. as returned by TextureIO::readInfo().
+
+  Rows that require texels, like statistics, are not shown.
+*/
+void TextureModel::setInfo(const TextureInfo &info)
+{
+    if (m_texture.isNull() && m_info == info)
+        return;
+
+    beginResetModel();
+    m_texture = Texture();
+    m_info = info;
+    m_statistics = {};
+    m_statisticsValid = false;
     endResetModel();
 }
 
 int TextureModel::rowCount(const QModelIndex &parent) const
 {
-    if (parent.isValid())
+    if (parent.isValid() || m_info.isNull())
         return 0;
-    return m_texture.isNull() ? 0 : RowCount;
+    return m_texture.isNull() ? RowMinimum : RowCount;
 }
 
 int TextureModel::columnCount(const QModelIndex &parent) const
@@ -63,20 +111,43 @@ QVariant TextureModel::data(const QModelIndex &index, int role) const
             case RowFaces: return tr("Faces count");
             case RowLevels: return tr("Levels count");
             case RowLayers: return tr("Layers count");
+            case RowMinimum: return tr("Minimum");
+            case RowMaximum: return tr("Maximum");
+            case RowMean: return tr("Mean");
+            case RowStdDev: return tr("Std. deviation");
+            case RowNanCount: return tr("NaN count");
+            case RowInfCount: return tr("Inf count");
+            case RowAlphaUsage: return tr("Alpha usage");
             default:
                 break;
             }
         } else if (index.column() == ColumnValue) {
-            if (m_texture.isNull())
+            if (m_info.isNull())
                 return QString();
             switch (index.row()) {
-            case RowFormat: return toQString(m_texture.format());
-            case RowWidth: return m_texture.width();
-            case RowHeight: return m_texture.height();
-            case RowDepth: return m_texture.depth();
-            case RowFaces: return m_texture.faces();
-            case RowLevels: return m_texture.levels();
-            case RowLayers: return m_texture.layers();
+            case RowFormat: return toQString(m_info.format());
+            case RowWidth: return m_info.width();
+            case RowHeight: return m_info.height();
+            case RowDepth: return m_info.depth();
+            case RowFaces: return m_info.faces();
+            case RowLevels: return m_info.levels();
+            case RowLayers: return m_info.layers();
+            case RowMinimum:
+                return channelsToString(statistics(), [](const auto &c) { return c.min; });
+            case RowMaximum:
+                return channelsToString(statistics(), [](const auto &c) { return c.max; });
+            case RowMean:
+                return channelsToString(statistics(), [](const auto &c) { return c.mean; });
+            case RowStdDev:
+                return channelsToString(statistics(), [](const auto &c) { return c.stdDev; });
+            case RowNanCount:
+                return statistics().isNull() ? QVariant() : statistics().nanCount();
+            case RowInfCount:
+                return statistics().isNull() ? QVariant() : statistics().infCount();
+            case RowAlphaUsage:
+                return statistics().isNull()
+                        ? QString()
+                        : toQString(statistics().alphaUsage());
             default:
                 break;
             }
@@ -85,3 +156,18 @@ QVariant TextureModel::data(const QModelIndex &index, int role) const
 
     return QVariant();
 }
+
+/*!
+  \internal
+  Returns the statistics of the first image of the texture. Compressed textures have no
+  statistics, rows are left empty in that case.
+*/
+const TextureStatistics &TextureModel::statistics() const
+{
+    if (!m_statisticsValid) {
+        if (!m_texture.isCompressed())
+            m_statistics = TextureStatistics(m_texture);
+        m_statisticsValid = true;
+    }
+    return m_statistics;
+}
@@ -4,6 +4,8 @@
 #include "texturelib_global.h"
 
 #include <TextureLib/Texture>
+#include <TextureLib/TextureInfo>
+#include <TextureLib/TextureStatistics>
 
 #include <QtCore/QAbstractTableModel>
 
@@ -24,6 +26,13 @@ public:
         RowFaces,
         RowLevels,
         RowLayers,
+        RowMinimum,
+        RowMaximum,
+        RowMean,
+        RowStdDev,
+        RowNanCount,
+        RowInfCount,
+        RowAlphaUsage,
         RowCount
     };
 
@@ -32,6 +41,9 @@ public:
     Texture texture() const;
     void setTexture(const Texture &texture);
 
+    TextureInfo info() const;
+    void setInfo(const TextureInfo &info);
+
 public: // QAbstractItemModel interface
     int rowCount(const QModelIndex &parent) const override;
     int columnCount(const QModelIndex &parent) const override;
@@ -39,7 +51,13 @@ public: // QAbstractItemModel interface
     QVariant data(const QModelIndex &index, int role) const override;
 
 private:
+    const TextureStatistics &statistics() const;
+
     Texture m_texture;
+    TextureInfo m_info;
+    // computed on demand, it takes a full pass over the data
+    mutable TextureStatistics m_statistics;
+    mutable bool m_statisticsValid {false};
 };
 
 #endif // TEXTUREMODEL_H
@@ -0,0 +1,41 @@
+#ifndef TEXTUREPARALLEL_P_H
+#define TEXTUREPARALLEL_P_H
+
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+#include <vector>
+
+namespace Private {
+
+// Calls func(begin, end) for bands of items in [0, count), distributing bands across threads.
+// Workloads cheaper than a single band run in the calling thread.
+template<typename Func>
+void parallelFor(qsizetype count, qsizetype costPerItem, const Func &func)
+{
+    // Smaller workloads are not worth the thread overhead
+    constexpr qsizetype minBandCost = 1 << 16;
+
+    const auto itemsPerBand = std::max<qsizetype>(1, minBandCost / std::max<qsizetype>(1, costPerItem));
+    if (count <= itemsPerBand) {
+        func(qsizetype(0), count);
+        return;
+    }
+
+    struct Band
+    {
+        qsizetype begin {0};
+        qsizetype end {0};
+    };
+
+    std::vector<Band> bands;
+    bands.reserve(size_t((count + itemsPerBand - 1) / itemsPerBand));
+    for (qsizetype begin = 0; begin < count; begin += itemsPerBand)
+        bands.push_back({begin, std::min(count, begin + itemsPerBand)});
+
+    QtConcurrent::blockingMap(bands, [&func](const Band &band) { func(band.begin, band.end); });
+}
+
+} // namespace Private
+
+#endif // TEXTUREPARALLEL_P_H
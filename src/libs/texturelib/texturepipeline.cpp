@@ -0,0 +1,570 @@
+#include "texturepipeline.h"
+#include "texture_p.h"
+#include "textureparallel_p.h"
+#include "textureresampler_p.h"
+#include "texturerowoperation_p.h"
+
+#include <QtCore/QDebug>
+
+#include <algorithm>
+
+namespace {
+
+using size_type = TexturePipeline::size_type;
+using Operations = std::vector<Private::RowOperation>;
+
+// Recorded steps reduced to the order in which they are executed
+struct Schedule
+{
+    TextureFormat format {TextureFormat::Invalid};
+    bool resize {false};
+    Texture::Size size;
+    Texture::Filter filter {Texture::Filter::Box};
+    bool mipmaps {false};
+    Texture::Filter mipmapFilter {Texture::Filter::Box};
+    Texture::MipmapOptions mipmapOptions;
+    // applied to the source texels before resizing
+    Operations inputOperations;
+    // applied to the first level before it is used to generate mipmaps
+    Operations outputOperations;
+    // applied to every level after all levels are generated
+    Operations finalOperations;
+};
+
+void applyOperations(const Operations *operations, gsl::span<Rgba128Float> colors)
+{
+    if (!operations)
+        return;
+    for (const auto &operation: *operations)
+        operation.floatRow(colors);
+}
+
+// Resamples a source image into a destination image of the same or a smaller or larger size
+struct Pass
+{
+    ConstTextureSpan source;
+    TextureData::RowReader reader;
+    TextureSpan destination;
+    TextureData::RowWriter writer;
+    bool gamma {false};
+    const Operations *inputOperations {nullptr};
+    const Operations *outputOperations {nullptr};
+    // null if the size is not changed along the axis
+    const Private::Weights *weightsX {nullptr};
+    const Private::Weights *weightsY {nullptr};
+};
+
+size_type maxContributors(const Private::Weights *weights)
+{
+    if (!weights)
+        return 1;
+    size_type result = 1;
+    for (size_t i = 0; i + 1 < weights->offsets.size(); ++i)
+        result = std::max(result, weights->offsets[i + 1] - weights->offsets[i]);
+    return result;
+}
+
+void resampleRow(gsl::span<const Rgba128Float> source, const Private::Weights &weights, float *dst)
+{
+    const auto width = size_type(weights.offsets.size()) - 1;
+    for (size_type x = 0; x < width; ++x) {
+        float acc[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        for (auto k = weights.offsets[size_t(x)]; k < weights.offsets[size_t(x + 1)]; ++k) {
+            const auto &texel = source[weights.indices[size_t(k)]];
+            const auto weight = weights.values[size_t(k)];
+            acc[0] += weight * texel.red();
+            acc[1] += weight * texel.green();
+            acc[2] += weight * texel.blue();
+            acc[3] += weight * texel.alpha();
+        }
+        std::copy(acc, acc + 4, dst + 4 * x);
+    }
+}
+
+// The destination is processed in bands of lines. Source lines contributing to a band are decoded
+// and resampled horizontally into the scratch buffer of the band, then each destination line is
+// accumulated from the scratch lines and encoded directly into the destination. The band height
+// is chosen so the scratch buffer fits into the budget.
+void runPass(const Pass &pass, qsizetype scratchBytes)
+{
+    const auto srcWidth = pass.source.width();
+    const auto srcHeight = pass.source.height();
+    const auto width = pass.destination.width();
+    const auto height = pass.destination.height();
+    const auto lineSize = 4 * width;
+
+    const auto contributors = maxContributors(pass.weightsY);
+    const auto scratchLines = scratchBytes / qsizetype(sizeof(float) * size_t(lineSize));
+    const auto bandLines = std::max<size_type>(
+            1, (scratchLines - contributors) * height / std::max<size_type>(srcHeight, 1));
+    const auto bands = (height + bandLines - 1) / bandLines;
+
+    const auto cost = bandLines * lineSize * contributors;
+    Private::parallelFor(bands, cost, [&](size_type begin, size_type end)
+    {
+        std::vector<Rgba128Float> input(static_cast<size_t>(srcWidth));
+        std::vector<Rgba128Float> output(static_cast<size_t>(width));
+        std::vector<float> accumulator(static_cast<size_t>(lineSize));
+        std::vector<float> scratch;
+        std::vector<size_type> lines;
+
+        for (auto band = begin; band < end; ++band) {
+            const auto y0 = band * bandLines;
+            const auto y1 = std::min(height, y0 + bandLines);
+
+            lines.clear();
+            if (pass.weightsY) {
+                const auto &weights = *pass.weightsY;
+                lines.insert(lines.end(),
+                             weights.indices.begin() + weights.offsets[size_t(y0)],
+                             weights.indices.begin() + weights.offsets[size_t(y1)]);
+                std::sort(lines.begin(), lines.end());
+                lines.erase(std::unique(lines.begin(), lines.end()), lines.end());
+            } else {
+                for (auto y = y0; y < y1; ++y)
+                    lines.push_back(y);
+            }
+
+            scratch.resize(lines.size() * size_t(lineSize));
+            for (size_t i = 0; i < lines.size(); ++i) {
+                pass.reader(pass.source.line(lines[i]), input);
+                if (pass.gamma)
+                    Private::srgbToLinear(input);
+                applyOperations(pass.inputOperations, input);
+                const auto dst = scratch.data() + i * size_t(lineSize);
+                if (pass.weightsX) {
+                    resampleRow(input, *pass.weightsX, dst);
+                } else {
+                    for (size_type x = 0; x < srcWidth; ++x) {
+                        const auto &color = input[size_t(x)];
+                        dst[4 * x + 0] = color.red();
+                        dst[4 * x + 1] = color.green();
+                        dst[4 * x + 2] = color.blue();
+                        dst[4 * x + 3] = color.alpha();
+                    }
+                }
+            }
+
+            for (auto y = y0; y < y1; ++y) {
+                const float *result = nullptr;
+                if (pass.weightsY) {
+                    const auto &weights = *pass.weightsY;
+                    std::fill(accumulator.begin(), accumulator.end(), 0.0f);
+                    for (auto k = weights.offsets[size_t(y)]; k < weights.offsets[size_t(y + 1)]; ++k) {
+                        const auto slot = std::lower_bound(
+                                lines.begin(), lines.end(), weights.indices[size_t(k)]) - lines.begin();
+                        const auto src = scratch.data() + size_t(slot) * size_t(lineSize);
+                        const auto weight = weights.values[size_t(k)];
+                        for (size_type j = 0; j < lineSize; ++j)
+                            accumulator[size_t(j)] += weight * src[j];
+                    }
+                    result = accumulator.data();
+                } else {
+                    result = scratch.data() + size_t(y - y0) * size_t(lineSize);
+                }
+
+                for (size_type x = 0; x < width; ++x) {
+                    const auto texel = result + 4 * x;
+                    output[size_t(x)] = rgba128Float(texel[0], texel[1], texel[2], texel[3]);
+                }
+                applyOperations(pass.outputOperations, output);
+                if (pass.gamma)
+                    Private::linearToSrgb(output);
+                pass.writer(output, pass.destination.line(y));
+            }
+        }
+    });
+}
+
+std::vector<float> alphaValues(ConstTextureSpan span, const TextureData::RowReader &reader)
+{
+    std::vector<float> result;
+    result.reserve(size_t(span.width() * span.height()));
+    std::vector<Rgba128Float> buffer(static_cast<size_t>(span.width()));
+    for (size_type y = 0; y < span.height(); ++y) {
+        reader(span.line(y), buffer);
+        for (const auto &color: buffer)
+            result.push_back(color.alpha());
+    }
+    return result;
+}
+
+float alphaCoverage(const std::vector<float> &alpha, float reference, float scale)
+{
+    if (alpha.empty())
+        return 0.0f;
+    const auto covered = std::count_if(alpha.begin(), alpha.end(),
+                                       [=](float value) { return value * scale > reference; });
+    return float(covered) / alpha.size();
+}
+
+// The same search as Private::findAlphaScale(), over alpha values only
+float findAlphaScale(const std::vector<float> &alpha, float coverage, float reference)
+{
+    auto minScale = 0.0f;
+    auto maxScale = 4.0f;
+    auto scale = 1.0f;
+    for (int i = 0; i < 10; ++i) {
+        const auto current = alphaCoverage(alpha, reference, scale);
+        if (current < coverage)
+            minScale = scale;
+        else if (current > coverage)
+            maxScale = scale;
+        else
+            break;
+        scale = (minScale + maxScale) / 2;
+    }
+    return scale;
+}
+
+// Scales the alpha and applies operations in place
+void finishLevel(
+        TextureSpan span,
+        const TextureData::RowReader &reader,
+        const TextureData::RowWriter &writer,
+        bool gamma,
+        float alphaScale,
+        const Operations &operations)
+{
+    const auto width = span.width();
+    Private::parallelFor(span.height(), 4 * width, [&](size_type begin, size_type end)
+    {
+        std::vector<Rgba128Float> buffer(static_cast<size_t>(width));
+        for (auto y = begin; y < end; ++y) {
+            const auto line = span.line(y);
+            reader(line, buffer);
+            if (gamma)
+                Private::srgbToLinear(buffer);
+            if (alphaScale != 1.0f) {
+                for (auto &color: buffer)
+                    color.setAlpha(std::min(color.alpha() * alphaScale, 1.0f));
+            }
+            applyOperations(&operations, buffer);
+            if (gamma)
+                Private::linearToSrgb(buffer);
+            writer(buffer, line);
+        }
+    });
+}
+
+bool isSrgb(TextureFormat format)
+{
+    return Private::linearFormat(format) != format;
+}
+
+} // namespace
+
+/*!
+  \class TexturePipeline
+  \brief TexturePipeline records texture operations and executes them in a single pass.
+
+  Chaining Texture::convert(), Texture::resized() and Texture::generateMipmaps() allocates a
+  full-size intermediate texture at every step. The pipeline records the same operations and
+  executes them when execute() is called, writing directly into the resulting texture:
+
+  \code
+  const auto result = TexturePipeline(texture)
+          .premultiply()
+          .resize({512, 512}, Texture::Filter::Kaiser)
+          .generateMipmaps()
+          .convert(TextureFormat::RGBA8_Unorm)
+          .execute();
+  \endcode
+
+  Each image is processed in bands of lines; the source lines of a band are decoded to floats
+  into a scratch buffer of scratchBytes() size, which is kept small enough to stay in the L2
+  cache, and the band is encoded to the output format right away. Bands run in parallel, so the
+  peak memory is the resulting texture plus a scratch buffer per thread. Each mipmap level is
+  filtered from the previous level stored in the result.
+
+  Intermediate values are kept in floating point, so convert() only sets the format of the
+  result regardless of where it is recorded; resize() should be recorded once and before
+  generateMipmaps(). Swizzle and alpha operations are applied in the recorded order relative to
+  the resizing and the mipmap generation. sRGB colors are resized and filtered in the linear
+  space.
+
+  Compressed and volume textures are not supported, neither is compressed output.
+*/
+
+/*!
+  \brief Constructs a pipeline that processes the \a source texture.
+*/
+TexturePipeline::TexturePipeline(const Texture &source)
+    : m_source(source)
+{
+}
+
+/*!
+  \fn qsizetype TexturePipeline::scratchBytes() const noexcept
+  \brief Returns the size of the per-thread scratch buffer used to process a band of lines.
+*/
+
+/*!
+  \brief Sets the format of the result to the \a format.
+*/
+TexturePipeline &TexturePipeline::convert(TextureFormat format)
+{
+    Step step;
+    step.type = Step::Type::Convert;
+    step.format = format;
+    m_steps.push_back(step);
+    return *this;
+}
+
+/*!
+  \brief Resizes the first level of each image to the \a size using the \a filter.
+
+  Unlike Texture::resized(), the image is not prefiltered, so the filter covers all source texels
+  in a single pass.
+*/
+TexturePipeline &TexturePipeline::resize(Texture::Size size, Texture::Filter filter)
+{
+    Step step;
+    step.type = Step::Type::Resize;
+    step.size = size;
+    step.filter = filter;
+    m_steps.push_back(step);
+    return *this;
+}
+
+/*!
+  \brief Rearranges channels, see Texture::swizzled().
+*/
+TexturePipeline &TexturePipeline::swizzle(const Texture::Swizzle &swizzle)
+{
+    Step step;
+    step.type = Step::Type::Swizzle;
+    step.swizzle = swizzle;
+    m_steps.push_back(step);
+    return *this;
+}
+
+/*!
+  \brief Multiplies colors by the alpha, see Texture::premultiplied().
+*/
+TexturePipeline &TexturePipeline::premultiply()
+{
+    Step step;
+    step.type = Step::Type::Premultiply;
+    m_steps.push_back(step);
+    return *this;
+}
+
+/*!
+  \brief Divides colors by the alpha, see Texture::unpremultiplied().
+*/
+TexturePipeline &TexturePipeline::unpremultiply()
+{
+    Step step;
+    step.type = Step::Type::Unpremultiply;
+    m_steps.push_back(step);
+    return *this;
+}
+
+/*!
+  \brief Generates a full mipmap chain using the \a filter and \a options, see
+  Texture::generateMipmaps().
+*/
+TexturePipeline &TexturePipeline::generateMipmaps(Texture::Filter filter, Texture::MipmapOptions options)
+{
+    Step step;
+    step.type = Step::Type::Mipmaps;
+    step.filter = filter;
+    step.options = options;
+    m_steps.push_back(step);
+    return *this;
+}
+
+/*!
+  \brief Executes recorded operations and returns the result.
+
+  Returns null texture if the operations can't be executed.
+*/
+Texture TexturePipeline::execute() const
+{
+    if (m_source.isNull())
+        return Texture();
+
+    if (m_source.isCompressed()) {
+        qCWarning(texture) << "TexturePipeline does not support compressed format"
+                           << m_source.format();
+        return Texture();
+    }
+
+    if (m_source.depth() > 1) {
+        qCWarning(texture) << "TexturePipeline does not support volume textures";
+        return Texture();
+    }
+
+    Schedule schedule;
+    schedule.format = m_source.format();
+    schedule.size = m_source.size();
+    for (const auto &step: m_steps) {
+        switch (step.type) {
+        case Step::Type::Convert:
+            if (TextureFormatInfo::formatInfo(step.format).isCompressed()) {
+                qCWarning(texture) << "TexturePipeline does not support encoding to compressed format"
+                                   << step.format;
+                return Texture();
+            }
+            schedule.format = step.format;
+            break;
+        case Step::Type::Resize:
+            if (schedule.resize || schedule.mipmaps) {
+                qCWarning(texture) << "resize() should be recorded once before generateMipmaps()";
+                return Texture();
+            }
+            if (!step.size.isValid() || step.size.depth != 1) {
+                qCWarning(texture) << "resize() was recorded with an invalid size";
+                return Texture();
+            }
+            schedule.resize = true;
+            schedule.size = step.size;
+            schedule.filter = step.filter;
+            // operations recorded so far are applied before resizing
+            schedule.inputOperations = std::move(schedule.outputOperations);
+            schedule.outputOperations.clear();
+            break;
+        case Step::Type::Mipmaps:
+            if (schedule.mipmaps) {
+                qCWarning(texture) << "generateMipmaps() should be recorded once";
+                return Texture();
+            }
+            schedule.mipmaps = true;
+            schedule.mipmapFilter = step.filter;
+            schedule.mipmapOptions = step.options;
+            break;
+        case Step::Type::Swizzle:
+        case Step::Type::Premultiply:
+        case Step::Type::Unpremultiply: {
+            const auto operation = step.type == Step::Type::Swizzle
+                    ? Private::swizzleOperation(step.swizzle)
+                    : step.type == Step::Type::Premultiply
+                      ? Private::premultiplyOperation()
+                      : Private::unpremultiplyOperation();
+            (schedule.mipmaps ? schedule.finalOperations : schedule.outputOperations)
+                    .push_back(operation);
+            break;
+        }
+        }
+    }
+
+    const auto reader = TextureData::getRowReader(Private::linearFormat(m_source.format()));
+    const auto writer = TextureData::getRowWriter(Private::linearFormat(schedule.format));
+    const auto outputReader = TextureData::getRowReader(Private::linearFormat(schedule.format));
+    if (!reader) {
+        qCWarning(texture) << "TexturePipeline does not support format" << m_source.format();
+        return Texture();
+    }
+    if (!writer || !outputReader) {
+        qCWarning(texture) << "TexturePipeline does not support format" << schedule.format;
+        return Texture();
+    }
+
+    const auto filtered = schedule.resize || schedule.mipmaps;
+    const auto gamma = filtered
+            && (isSrgb(m_source.format()) || isSrgb(schedule.format)
+                || schedule.mipmapOptions.testFlag(Texture::MipmapOption::SrgbGamma));
+
+    size_type levels = filtered ? 1 : m_source.levels();
+    if (schedule.mipmaps) {
+        const auto maxSize = std::max(schedule.size.width, schedule.size.height);
+        while (maxSize >> levels)
+            ++levels;
+    }
+
+    const auto isCubemap = m_source.faces() == 6 ? Texture::IsCubemap::Yes : Texture::IsCubemap::No;
+    Texture result(
+            schedule.format,
+            schedule.size,
+            {isCubemap, levels, m_source.layers()},
+            m_source.alignment());
+    if (result.isNull()) // invalid size for a cubemap or allocation failed
+        return Texture();
+
+    Private::Weights weightsX;
+    Private::Weights weightsY;
+    if (schedule.resize) {
+        if (schedule.size.width != m_source.width()) {
+            weightsX = Private::computeWeights(
+                    m_source.width(), schedule.size.width, schedule.filter, Private::EdgeMode::Clamp);
+        }
+        if (schedule.size.height != m_source.height()) {
+            weightsY = Private::computeWeights(
+                    m_source.height(), schedule.size.height, schedule.filter, Private::EdgeMode::Clamp);
+        }
+    }
+
+    const auto edgeMode = schedule.mipmapOptions.testFlag(Texture::MipmapOption::WrapEdges)
+            ? Private::EdgeMode::Wrap
+            : Private::EdgeMode::Clamp;
+    const auto preserveCoverage = schedule.mipmaps
+            && schedule.mipmapOptions.testFlag(Texture::MipmapOption::PreserveAlphaCoverage);
+    constexpr auto alphaReference = 0.5f;
+
+    for (size_type layer = 0; layer < m_source.layers(); ++layer) {
+        for (size_type face = 0; face < m_source.faces(); ++face) {
+            const auto sourceLevels = filtered ? 1 : m_source.levels();
+            for (size_type level = 0; level < sourceLevels; ++level) {
+                const Texture::ArrayIndex index(Texture::Side(face), level, layer);
+                Pass pass;
+                pass.source = m_source.constImageSpan(index);
+                pass.reader = reader;
+                pass.destination = result.imageSpan(index);
+                pass.writer = writer;
+                pass.gamma = gamma;
+                pass.inputOperations = &schedule.inputOperations;
+                pass.outputOperations = &schedule.outputOperations;
+                pass.weightsX = weightsX.values.empty() ? nullptr : &weightsX;
+                pass.weightsY = weightsY.values.empty() ? nullptr : &weightsY;
+                runPass(pass, m_scratchBytes);
+            }
+
+            for (size_type level = 1; level < levels; ++level) {
+                const auto previous = result.constImageSpan({Texture::Side(face), level - 1, layer});
+                const auto current = result.imageSpan({Texture::Side(face), level, layer});
+                Private::Weights mipWeightsX;
+                Private::Weights mipWeightsY;
+                if (current.width() != previous.width()) {
+                    mipWeightsX = Private::computeWeights(
+                            previous.width(), current.width(), schedule.mipmapFilter, edgeMode);
+                }
+                if (current.height() != previous.height()) {
+                    mipWeightsY = Private::computeWeights(
+                            previous.height(), current.height(), schedule.mipmapFilter, edgeMode);
+                }
+
+                Pass pass;
+                pass.source = previous;
+                pass.reader = outputReader;
+                pass.destination = current;
+                pass.writer = writer;
+                pass.gamma = gamma;
+                pass.weightsX = mipWeightsX.values.empty() ? nullptr : &mipWeightsX;
+                pass.weightsY = mipWeightsY.values.empty() ? nullptr : &mipWeightsY;
+                runPass(pass, m_scratchBytes);
+            }
+
+            if (!preserveCoverage && schedule.finalOperations.empty())
+                continue;
+
+            // levels are filtered from unscaled previous levels, so alpha is scaled afterwards
+            const auto coverage = preserveCoverage
+                    ? alphaCoverage(alphaValues(result.constImageSpan({Texture::Side(face), 0, layer}),
+                                                outputReader),
+                                    alphaReference, 1.0f)
+                    : 0.0f;
+            for (size_type level = 0; level < levels; ++level) {
+                const Texture::ArrayIndex index(Texture::Side(face), level, layer);
+                const auto scale = preserveCoverage && level > 0
+                        ? findAlphaScale(alphaValues(result.constImageSpan(index), outputReader),
+                                         coverage, alphaReference)
+                        : 1.0f;
+                finishLevel(result.imageSpan(index), outputReader, writer, gamma, scale,
+                            schedule.finalOperations);
+            }
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "texturelib_global.h"
+
+#include <TextureLib/Texture>
+
+#include <vector>
+
+class TEXTURELIB_EXPORT TexturePipeline
+{
+public:
+    using size_type = Texture::size_type;
+
+    static constexpr qsizetype DefaultScratchBytes = 256 * 1024;
+
+    TexturePipeline() = default;
+    explicit TexturePipeline(const Texture &source);
+
+    const Texture &source() const noexcept { return m_source; }
+
+    qsizetype scratchBytes() const noexcept { return m_scratchBytes; }
+    void setScratchBytes(qsizetype bytes) noexcept { m_scratchBytes = bytes; }
+
+    TexturePipeline &convert(TextureFormat format);
+    TexturePipeline &resize(Texture::Size size, Texture::Filter filter = Texture::Filter::Box);
+    TexturePipeline &swizzle(const Texture::Swizzle &swizzle);
+    TexturePipeline &premultiply();
+    TexturePipeline &unpremultiply();
+    TexturePipeline &generateMipmaps(
+            Texture::Filter filter = Texture::Filter::Box,
+            Texture::MipmapOptions options = Texture::MipmapOption::NoOptions);
+
+    Texture execute() const;
+
+private:
+    struct Step
+    {
+        enum class Type {
+            Convert,
+            Resize,
+            Swizzle,
+            Premultiply,
+            Unpremultiply,
+            Mipmaps,
+        };
+
+        Type type {Type::Convert};
+        TextureFormat format {TextureFormat::Invalid};
+        Texture::Size size;
+        Texture::Filter filter {Texture::Filter::Box};
+        Texture::MipmapOptions options;
+        Texture::Swizzle swizzle {};
+    };
+
+    Texture m_source;
+    std::vector<Step> m_steps;
+    qsizetype m_scratchBytes {DefaultScratchBytes};
+};
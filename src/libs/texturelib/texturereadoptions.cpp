@@ -0,0 +1,154 @@
+#include "texturereadoptions.h"
+
+#include <QtCore/QDebug>
+
+#include <algorithm>
+
+namespace {
+
+using size_type = TextureReadOptions::size_type;
+
+bool isSingleFace(TextureReadOptions::Faces faces) noexcept
+{
+    const auto value = uint(faces & TextureReadOptions::Face::AllFaces);
+    return value && !(value & (value - 1));
+}
+
+// Clamps [first, first + count) to [0, total), count < 0 means all remaining items
+size_type resolvedCount(size_type first, size_type count, size_type total) noexcept
+{
+    return count < 0 ? total - first : std::min(count, total - first);
+}
+
+bool inRange(size_type value, size_type first, size_type count) noexcept
+{
+    return value >= first && (count < 0 || value < first + count);
+}
+
+} // namespace
+
+/*!
+  \class TextureReadOptions
+  \brief TextureReadOptions selects subresources read by TextureIO::read().
+
+  By default, all levels, layers and faces are read. When a range of levels is requested, the
+  first requested level becomes the level 0 of the resulting texture, and so on; the same applies
+  to layers. Unrequested images are skipped in the file, so memory usage and IO scale with the
+  requested data.
+
+  Faces are only taken into account for cubemaps. If a single face is requested, the result is a
+  2D texture; if several but not all faces are requested, the result is a cubemap with
+  unrequested faces filled with zeros.
+
+  \code
+  // reads only the current subresource of a cubemap array
+  TextureReadOptions options;
+  options.setLevels(level, 1);
+  options.setLayers(layer, 1);
+  options.setFaces(TextureReadOptions::face(side));
+  const auto result = TextureIO(fileName).read(options);
+  \endcode
+*/
+
+/*!
+  \enum TextureReadOptions::Face
+  This enum describes requested faces of a cubemap, one flag per Texture::Side.
+*/
+
+/*!
+  \fn TextureReadOptions::Face TextureReadOptions::face(Texture::Side side) noexcept
+  \brief Returns the flag that corresponds to the given \a side.
+*/
+
+/*!
+  \brief Requests \a count levels starting from the \a first level; a negative \a count requests
+  all levels starting from the \a first level.
+*/
+void TextureReadOptions::setLevels(size_type first, size_type count) noexcept
+{
+    m_firstLevel = first;
+    m_levelCount = count;
+}
+
+/*!
+  \brief Requests \a count layers starting from the \a first layer; a negative \a count requests
+  all layers starting from the \a first layer.
+*/
+void TextureReadOptions::setLayers(size_type first, size_type count) noexcept
+{
+    m_firstLayer = first;
+    m_layerCount = count;
+}
+
+/*!
+  \brief Returns true if all subresources are requested.
+*/
+bool TextureReadOptions::readsAll() const noexcept
+{
+    return m_firstLevel == 0 && m_levelCount < 0
+            && m_firstLayer == 0 && m_layerCount < 0
+            && (m_faces & Face::AllFaces) == Faces(Face::AllFaces);
+}
+
+/*!
+  \brief Returns the layout of the texture that is read from the file described by the
+  \a source.
+
+  Returns null info if no subresources of the \a source are requested.
+*/
+TextureInfo TextureReadOptions::resultInfo(const TextureInfo &source) const
+{
+    if (source.isNull())
+        return {};
+
+    if (m_firstLevel < 0 || m_firstLevel >= source.levels() || m_levelCount == 0) {
+        qCWarning(texture) << "Requested levels are out of range:" << m_firstLevel
+                           << "texture has" << source.levels() << "levels";
+        return {};
+    }
+
+    if (m_firstLayer < 0 || m_firstLayer >= source.layers() || m_layerCount == 0) {
+        qCWarning(texture) << "Requested layers are out of range:" << m_firstLayer
+                           << "texture has" << source.layers() << "layers";
+        return {};
+    }
+
+    auto isCubemap = source.isCubemap();
+    if (isCubemap) {
+        if (!(m_faces & Face::AllFaces)) {
+            qCWarning(texture) << "No faces of a cubemap are requested";
+            return {};
+        }
+        isCubemap = !isSingleFace(m_faces);
+    }
+
+    return {source.format(),
+            source.size(m_firstLevel),
+            {isCubemap ? Texture::IsCubemap::Yes : Texture::IsCubemap::No,
+             resolvedCount(m_firstLevel, m_levelCount, source.levels()),
+             resolvedCount(m_firstLayer, m_layerCount, source.layers())}};
+}
+
+/*!
+  \brief Returns true if the image at the \a index of the file described by the \a source is
+  requested.
+*/
+bool TextureReadOptions::contains(const TextureInfo &source, ArrayIndex index) const noexcept
+{
+    return inRange(index.level(), m_firstLevel, m_levelCount)
+            && inRange(index.layer(), m_firstLayer, m_layerCount)
+            && (!source.isCubemap() || m_faces.testFlag(face(index.side())));
+}
+
+/*!
+  \brief Returns the index in the resulting texture of the requested image at the \a index of the
+  file described by the \a source.
+*/
+Texture::ArrayIndex TextureReadOptions::mapped(
+        const TextureInfo &source, ArrayIndex index) const noexcept
+{
+    const auto side = source.isCubemap() && isSingleFace(m_faces)
+            ? Texture::Side::PositiveX
+            : index.side();
+    return {side, index.level() - m_firstLevel, index.layer() - m_firstLayer};
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "texturelib_global.h"
+
+#include <TextureLib/Texture>
+#include <TextureLib/TextureInfo>
+
+class TEXTURELIB_EXPORT TextureReadOptions
+{
+    Q_GADGET
+public:
+    using size_type = Texture::size_type;
+    using ArrayIndex = Texture::ArrayIndex;
+
+    enum class Face {
+        NoFaces = 0x00,
+        PositiveX = 0x01,
+        NegativeX = 0x02,
+        PositiveY = 0x04,
+        NegativeY = 0x08,
+        PositiveZ = 0x10,
+        NegativeZ = 0x20,
+        AllFaces = 0x3f,
+    };
+    using Faces = QFlags<Face>;
+    Q_FLAG(Faces)
+
+    static constexpr Face face(Texture::Side side) noexcept { return Face(1 << int(side)); }
+
+    TextureReadOptions() noexcept = default;
+
+    constexpr size_type firstLevel() const noexcept { return m_firstLevel; }
+    constexpr size_type levelCount() const noexcept { return m_levelCount; }
+    void setLevels(size_type first, size_type count = -1) noexcept;
+
+    constexpr size_type firstLayer() const noexcept { return m_firstLayer; }
+    constexpr size_type layerCount() const noexcept { return m_layerCount; }
+    void setLayers(size_type first, size_type count = -1) noexcept;
+
+    Faces faces() const noexcept { return m_faces; }
+    void setFaces(Faces faces) noexcept { m_faces = faces; }
+
+    bool readsAll() const noexcept;
+
+    TextureInfo resultInfo(const TextureInfo &source) const;
+    bool contains(const TextureInfo &source, ArrayIndex index) const noexcept;
+    ArrayIndex mapped(const TextureInfo &source, ArrayIndex index) const noexcept;
+
+private:
+    size_type m_firstLevel {0};
+    size_type m_levelCount {-1};
+    size_type m_firstLayer {0};
+    size_type m_layerCount {-1};
+    Faces m_faces {Face::AllFaces};
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(TextureReadOptions::Faces)
@@ -0,0 +1,399 @@
+#include "textureresampler_p.h"
+#include "textureparallel_p.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Private {
+
+namespace {
+
+using size_type = FloatImage::size_type;
+
+constexpr double pi = 3.14159265358979323846;
+
+double sinc(double x)
+{
+    if (std::abs(x) < 1e-6)
+        return 1.0;
+    return std::sin(pi * x) / (pi * x);
+}
+
+// Modified Bessel function of the first kind of order 0
+double bessel0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+    const auto halfX = x / 2.0;
+    for (int k = 1; k < 32; ++k) {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+        if (term < sum * 1e-12)
+            break;
+    }
+    return sum;
+}
+
+double filterSupport(Texture::Filter filter)
+{
+    switch (filter) {
+    case Texture::Filter::Box: return 0.5;
+    case Texture::Filter::Kaiser: return 3.0;
+    case Texture::Filter::Lanczos: return 3.0;
+    }
+    return 0.5;
+}
+
+double filterValue(Texture::Filter filter, double x)
+{
+    switch (filter) {
+    case Texture::Filter::Box:
+        return x >= -0.5 && x < 0.5 ? 1.0 : 0.0;
+    case Texture::Filter::Kaiser: {
+        constexpr double width = 3.0;
+        constexpr double alpha = 4.0;
+        const auto t = x / width;
+        if (t * t >= 1.0)
+            return 0.0;
+        return sinc(x) * bessel0(alpha * std::sqrt(1.0 - t * t)) / bessel0(alpha);
+    }
+    case Texture::Filter::Lanczos:
+        return std::abs(x) < 3.0 ? sinc(x) * sinc(x / 3.0) : 0.0;
+    }
+    return 0.0;
+}
+
+FloatImage resampleX(const FloatImage &image, size_type width, const Weights &weights)
+{
+    FloatImage result(width, image.height(), image.depth());
+    const auto lines = image.height() * image.depth();
+    const auto cost = 4 * weights.values.size();
+    parallelFor(lines, size_type(cost), [&](size_type begin, size_type end)
+    {
+        for (auto line = begin; line < end; ++line) {
+            const auto src = image.data() + 4 * image.width() * line;
+            const auto dst = result.data() + 4 * width * line;
+            for (size_type x = 0; x < width; ++x) {
+                float acc[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+                for (auto k = weights.offsets[size_t(x)]; k < weights.offsets[size_t(x + 1)]; ++k) {
+                    const auto texel = src + 4 * weights.indices[size_t(k)];
+                    const auto weight = weights.values[size_t(k)];
+                    for (int c = 0; c < 4; ++c)
+                        acc[c] += weight * texel[c];
+                }
+                for (int c = 0; c < 4; ++c)
+                    dst[4 * x + c] = acc[c];
+            }
+        }
+    });
+    return result;
+}
+
+// Each destination line is a weighted sum of whole source lines, this is the same for the Y and Z
+// axes and allows to accumulate contiguous arrays.
+template<typename SourceLine>
+void resampleLines(
+        FloatImage &result,
+        size_type lines,
+        const Weights &weights,
+        const SourceLine &sourceLine)
+{
+    const auto lineSize = 4 * result.width();
+    const auto contributors = size_type(weights.values.size() / (weights.offsets.size() - 1));
+    parallelFor(lines, lineSize * contributors, [&](size_type begin, size_type end)
+    {
+        for (auto line = begin; line < end; ++line) {
+            const auto dst = result.data() + lineSize * line;
+            std::fill(dst, dst + lineSize, 0.0f);
+            // y for the Y axis, z for the Z axis
+            const auto i = sourceLine.destinationIndex(line);
+            for (auto k = weights.offsets[size_t(i)]; k < weights.offsets[size_t(i + 1)]; ++k) {
+                const auto src = sourceLine(line, weights.indices[size_t(k)]);
+                const auto weight = weights.values[size_t(k)];
+                for (size_type j = 0; j < lineSize; ++j)
+                    dst[j] += weight * src[j];
+            }
+        }
+    });
+}
+
+} // namespace
+
+/*!
+  \internal
+  Computes contributions of \a srcSize source texels to each of \a dstSize destination texels
+  along one axis.
+*/
+Weights computeWeights(
+        size_type srcSize, size_type dstSize, Texture::Filter filter, EdgeMode edgeMode)
+{
+    Weights result;
+
+    const auto scale = double(dstSize) / srcSize;
+    // when downsampling, the filter is stretched to cover all source texels
+    const auto filterScale = std::min(scale, 1.0);
+    const auto support = filterSupport(filter) / filterScale;
+
+    const auto address = [srcSize, edgeMode](size_type i)
+    {
+        if (edgeMode == EdgeMode::Clamp)
+            return qBound<size_type>(0, i, srcSize - 1);
+        i %= srcSize;
+        return i < 0 ? i + srcSize : i;
+    };
+
+    result.offsets.reserve(size_t(dstSize + 1));
+    result.offsets.push_back(0);
+    for (size_type i = 0; i < dstSize; ++i) {
+        const auto center = (i + 0.5) / scale;
+        const auto first = size_type(std::floor(center - support));
+        const auto last = size_type(std::ceil(center + support));
+        const auto start = result.values.size();
+
+        double sum = 0.0;
+        for (auto j = first; j <= last; ++j) {
+            const auto weight = filterValue(filter, (j + 0.5 - center) * filterScale);
+            if (weight == 0.0)
+                continue;
+            result.indices.push_back(address(j));
+            result.values.push_back(float(weight));
+            sum += weight;
+        }
+
+        if (sum != 0.0) {
+            for (auto k = start; k < result.values.size(); ++k)
+                result.values[k] = float(result.values[k] / sum);
+        } else {
+            result.values.resize(start);
+            result.indices.resize(start);
+            result.indices.push_back(address(size_type(center)));
+            result.values.push_back(1.0f);
+        }
+        result.offsets.push_back(size_type(result.indices.size()));
+    }
+
+    return result;
+}
+
+FloatImage::FloatImage(size_type width, size_type height, size_type depth)
+    : m_data(size_t(4 * width * height * depth))
+    , m_width(width)
+    , m_height(height)
+    , m_depth(depth)
+{
+}
+
+FloatImage FloatImage::fromSpan(ConstTextureSpan span, const TextureData::RowReader &reader)
+{
+    FloatImage result(span.width(), span.height(), span.depth());
+    const auto width = span.width();
+    parallelFor(span.height() * span.depth(), 4 * width, [&](size_type begin, size_type end)
+    {
+        std::vector<Rgba128Float> buffer(static_cast<size_t>(width));
+        for (auto line = begin; line < end; ++line) {
+            reader(span.line(line % span.height(), line / span.height()), buffer);
+            auto dst = result.data() + 4 * width * line;
+            for (const auto &color: buffer) {
+                *dst++ = color.red();
+                *dst++ = color.green();
+                *dst++ = color.blue();
+                *dst++ = color.alpha();
+            }
+        }
+    });
+    return result;
+}
+
+void FloatImage::toSpan(TextureSpan span, const TextureData::RowWriter &writer) const
+{
+    Q_ASSERT(span.width() == m_width && span.height() == m_height && span.depth() == m_depth);
+    parallelFor(m_height * m_depth, 4 * m_width, [&](size_type begin, size_type end)
+    {
+        std::vector<Rgba128Float> buffer(static_cast<size_t>(m_width));
+        for (auto line = begin; line < end; ++line) {
+            auto src = data() + 4 * m_width * line;
+            for (auto &color: buffer) {
+                color = rgba128Float(src[0], src[1], src[2], src[3]);
+                src += 4;
+            }
+            writer(buffer, span.line(line % m_height, line / m_height));
+        }
+    });
+}
+
+FloatImage resampled(
+        FloatImage image, Texture::Size size, Texture::Filter filter, EdgeMode edgeMode)
+{
+    // the image is taken by value, so passes that don't apply cost nothing when it is moved in
+    auto result = std::move(image);
+
+    if (size.width != result.width()) {
+        const auto weights = computeWeights(result.width(), size.width, filter, edgeMode);
+        result = resampleX(result, size.width, weights);
+    }
+
+    if (size.height != result.height()) {
+        const auto weights = computeWeights(result.height(), size.height, filter, edgeMode);
+        FloatImage lines(result.width(), size.height, result.depth());
+        struct SourceLine
+        {
+            const FloatImage &image;
+            size_type height;
+            size_type destinationIndex(size_type line) const { return line % height; }
+            const float *operator()(size_type line, size_type y) const
+            { return image.line(y, line / height); }
+        } sourceLine {result, size.height};
+        resampleLines(lines, size.height * result.depth(), weights, sourceLine);
+        result = std::move(lines);
+    }
+
+    if (size.depth != result.depth()) {
+        const auto weights = computeWeights(result.depth(), size.depth, filter, edgeMode);
+        FloatImage lines(result.width(), result.height(), size.depth);
+        struct SourceLine
+        {
+            const FloatImage &image;
+            size_type height;
+            size_type destinationIndex(size_type line) const { return line / height; }
+            const float *operator()(size_type line, size_type z) const
+            { return image.line(line % height, z); }
+        } sourceLine {result, result.height()};
+        resampleLines(lines, result.height() * size.depth, weights, sourceLine);
+        result = std::move(lines);
+    }
+
+    return result;
+}
+
+/*!
+  \internal
+  Halves the \a image with the box filter until it is less than 4 times larger than the \a size
+  along each axis.
+
+  This bounds the support of the final filter, so downscaling by large factors costs about the
+  same as downscaling by 2.
+*/
+FloatImage prefiltered(FloatImage image, Texture::Size size)
+{
+    const auto reduce = [](size_type current, size_type target)
+    { return current / 2 >= 2 * target ? current / 2 : current; };
+
+    auto result = std::move(image);
+    while (true) {
+        const Texture::Size halfSize(
+                reduce(result.width(), size.width),
+                reduce(result.height(), size.height),
+                reduce(result.depth(), size.depth));
+        if (halfSize.width == result.width()
+                && halfSize.height == result.height()
+                && halfSize.depth == result.depth()) {
+            break;
+        }
+        result = resampled(std::move(result), halfSize, Texture::Filter::Box, EdgeMode::Clamp);
+    }
+    return result;
+}
+
+// sRGB formats share the layout with the UNorm ones, so the same readers and writers can be used
+// after converting colors to the linear space
+TextureFormat linearFormat(TextureFormat format) noexcept
+{
+    switch (format) {
+    case TextureFormat::RGBA8_Srgb: return TextureFormat::RGBA8_Unorm;
+    case TextureFormat::BGRA8_Srgb: return TextureFormat::BGRA8_Unorm;
+    case TextureFormat::BGRX8_Srgb: return TextureFormat::BGRX8_Unorm;
+    default: return format;
+    }
+}
+
+void srgbToLinear(FloatImage &image)
+{
+    parallelFor(image.texelCount(), 64, [&image](size_type begin, size_type end)
+    {
+        for (auto texel = image.data() + 4 * begin; texel != image.data() + 4 * end; texel += 4) {
+            for (int c = 0; c < 3; ++c)
+                texel[c] = srgbToLinear(texel[c]);
+        }
+    });
+}
+
+void linearToSrgb(FloatImage &image)
+{
+    parallelFor(image.texelCount(), 64, [&image](size_type begin, size_type end)
+    {
+        for (auto texel = image.data() + 4 * begin; texel != image.data() + 4 * end; texel += 4) {
+            for (int c = 0; c < 3; ++c)
+                texel[c] = linearToSrgb(texel[c]);
+        }
+    });
+}
+
+/*!
+  \internal
+  Returns the fraction of texels which alpha multiplied by the \a scale is greater than the
+  \a reference value.
+*/
+float alphaCoverage(const FloatImage &image, float reference, float scale)
+{
+    const auto count = image.texelCount();
+    if (!count)
+        return 0.0f;
+
+    size_type covered = 0;
+    for (auto alpha = image.data() + 3; alpha < image.data() + 4 * count; alpha += 4) {
+        if (*alpha * scale > reference)
+            ++covered;
+    }
+    return float(covered) / count;
+}
+
+/*!
+  \internal
+  Finds the alpha scale that makes the alpha coverage of the \a image close to \a coverage.
+*/
+float findAlphaScale(const FloatImage &image, float coverage, float reference)
+{
+    auto minScale = 0.0f;
+    auto maxScale = 4.0f;
+    auto scale = 1.0f;
+    for (int i = 0; i < 10; ++i) {
+        const auto current = alphaCoverage(image, reference, scale);
+        if (current < coverage)
+            minScale = scale;
+        else if (current > coverage)
+            maxScale = scale;
+        else
+            break;
+        scale = (minScale + maxScale) / 2;
+    }
+    return scale;
+}
+
+void srgbToLinear(gsl::span<Rgba128Float> colors)
+{
+    for (auto &color: colors) {
+        color = {srgbToLinear(color.red()),
+                 srgbToLinear(color.green()),
+                 srgbToLinear(color.blue()),
+                 color.alpha()};
+    }
+}
+
+void linearToSrgb(gsl::span<Rgba128Float> colors)
+{
+    for (auto &color: colors) {
+        color = {linearToSrgb(color.red()),
+                 linearToSrgb(color.green()),
+                 linearToSrgb(color.blue()),
+                 color.alpha()};
+    }
+}
+
+void scaleAlpha(FloatImage &image, float scale)
+{
+    const auto end = image.data() + 4 * image.texelCount();
+    for (auto alpha = image.data() + 3; alpha < end; alpha += 4)
+        *alpha = std::min(*alpha * scale, 1.0f);
+}
+
+} // namespace Private
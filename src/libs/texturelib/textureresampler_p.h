@@ -0,0 +1,100 @@
+#ifndef TEXTURERESAMPLER_P_H
+#define TEXTURERESAMPLER_P_H
+
+#include "texture.h"
+#include "texture_p.h"
+
+#include <cmath>
+#include <vector>
+
+namespace Private {
+
+// An image of 4-component float texels, used as an intermediate storage by image operations
+class FloatImage
+{
+public:
+    using size_type = Texture::size_type;
+
+    FloatImage() = default;
+    FloatImage(size_type width, size_type height, size_type depth = 1);
+
+    static FloatImage fromSpan(ConstTextureSpan span, const TextureData::RowReader &reader);
+    void toSpan(TextureSpan span, const TextureData::RowWriter &writer) const;
+
+    bool isNull() const noexcept { return m_data.empty(); }
+
+    size_type width() const noexcept { return m_width; }
+    size_type height() const noexcept { return m_height; }
+    size_type depth() const noexcept { return m_depth; }
+    size_type texelCount() const noexcept { return m_width * m_height * m_depth; }
+
+    float *data() noexcept { return m_data.data(); }
+    const float *data() const noexcept { return m_data.data(); }
+
+    float *line(size_type y, size_type z = 0) noexcept
+    { return m_data.data() + 4 * (m_width * (m_height * z + y)); }
+    const float *line(size_type y, size_type z = 0) const noexcept
+    { return m_data.data() + 4 * (m_width * (m_height * z + y)); }
+
+private:
+    std::vector<float> m_data;
+    size_type m_width {0};
+    size_type m_height {0};
+    size_type m_depth {0};
+};
+
+enum class EdgeMode {
+    Clamp,
+    Wrap,
+};
+
+// Contributions of source texels to each destination texel along one axis
+struct Weights
+{
+    using size_type = Texture::size_type;
+
+    // contributors of the i-th texel are in [offsets[i], offsets[i + 1])
+    std::vector<size_type> offsets;
+    std::vector<size_type> indices;
+    std::vector<float> values;
+};
+
+Weights computeWeights(
+        Texture::size_type srcSize,
+        Texture::size_type dstSize,
+        Texture::Filter filter,
+        EdgeMode edgeMode);
+
+FloatImage resampled(
+        FloatImage image, Texture::Size size, Texture::Filter filter, EdgeMode edgeMode);
+FloatImage prefiltered(FloatImage image, Texture::Size size);
+
+TextureFormat linearFormat(TextureFormat format) noexcept;
+
+inline float srgbToLinear(float value) noexcept
+{
+    return value <= 0.04045f
+            ? value / 12.92f
+            : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+inline float linearToSrgb(float value) noexcept
+{
+    value = std::max(value, 0.0f);
+    return value <= 0.0031308f
+            ? value * 12.92f
+            : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+void srgbToLinear(FloatImage &image);
+void linearToSrgb(FloatImage &image);
+void srgbToLinear(gsl::span<Rgba128Float> colors);
+void linearToSrgb(gsl::span<Rgba128Float> colors);
+
+float alphaCoverage(const FloatImage &image, float reference, float scale = 1.0f);
+float findAlphaScale(const FloatImage &image, float coverage, float reference);
+void scaleAlpha(FloatImage &image, float scale);
+
+} // namespace Private
+
+#endif // TEXTURERESAMPLER_P_H
@@ -0,0 +1,192 @@
+#include "texturerowoperation_p.h"
+#include "texture_p.h"
+#include "textureparallel_p.h"
+
+#include <QtCore/QDebug>
+
+#include <algorithm>
+#include <vector>
+
+namespace Private {
+
+namespace {
+
+using size_type = Texture::size_type;
+using SwizzleValue = Texture::SwizzleValue;
+using Offsets = RowOperation::Offsets;
+
+// 8-bit formats with 4 channels are processed without decoding, offsets are -1 for other formats
+Offsets rgba8Offsets(TextureFormat format) noexcept
+{
+    switch (format) {
+    case TextureFormat::RGBA8_Unorm:
+    case TextureFormat::RGBA8_Srgb: return {0, 1, 2, 3};
+    case TextureFormat::BGRA8_Unorm:
+    case TextureFormat::BGRA8_Srgb: return {2, 1, 0, 3};
+    default: return {-1, -1, -1, -1};
+    }
+}
+
+template<typename T>
+T swizzleValue(SwizzleValue value, const std::array<T, 4> &source, T one) noexcept
+{
+    switch (value) {
+    case SwizzleValue::Red: return source[0];
+    case SwizzleValue::Green: return source[1];
+    case SwizzleValue::Blue: return source[2];
+    case SwizzleValue::Alpha: return source[3];
+    case SwizzleValue::Zero: return T(0);
+    case SwizzleValue::One: return one;
+    }
+    return T(0);
+}
+
+// Rounded c * a / 255 without the division
+inline uchar multiply8(uint c, uint a) noexcept
+{
+    const auto x = c * a + 128;
+    return uchar((x + (x >> 8)) >> 8);
+}
+
+inline uchar divide8(uint c, uint a) noexcept
+{
+    return uchar(std::min(255u, (c * 255 + a / 2) / a));
+}
+
+} // namespace
+
+RowOperation swizzleOperation(const Texture::Swizzle &swizzle)
+{
+    RowOperation result;
+    result.floatRow = [swizzle](gsl::span<Rgba128Float> colors)
+    {
+        for (auto &color: colors) {
+            const std::array<float, 4> source = {color.red(), color.green(), color.blue(), color.alpha()};
+            color = {swizzleValue(swizzle[0], source, 1.0f),
+                     swizzleValue(swizzle[1], source, 1.0f),
+                     swizzleValue(swizzle[2], source, 1.0f),
+                     swizzleValue(swizzle[3], source, 1.0f)};
+        }
+    };
+    result.rgba8Row = [swizzle](Texture::Data line, const Offsets &offsets)
+    {
+        for (auto texel = line.data(), end = texel + line.size(); texel < end; texel += 4) {
+            const std::array<uchar, 4> source = {
+                texel[offsets[0]], texel[offsets[1]], texel[offsets[2]], texel[offsets[3]]
+            };
+            for (size_t c = 0; c < 4; ++c)
+                texel[offsets[c]] = swizzleValue(swizzle[c], source, uchar(255));
+        }
+    };
+    return result;
+}
+
+RowOperation premultiplyOperation()
+{
+    RowOperation result;
+    result.floatRow = [](gsl::span<Rgba128Float> colors)
+    {
+        for (auto &color: colors) {
+            const auto alpha = color.alpha();
+            color = {color.red() * alpha, color.green() * alpha, color.blue() * alpha, alpha};
+        }
+    };
+    result.rgba8Row = [](Texture::Data line, const Offsets &offsets)
+    {
+        for (auto texel = line.data(), end = texel + line.size(); texel < end; texel += 4) {
+            const uint alpha = texel[offsets[3]];
+            if (alpha == 255)
+                continue;
+            for (size_t c = 0; c < 3; ++c)
+                texel[offsets[c]] = multiply8(texel[offsets[c]], alpha);
+        }
+    };
+    return result;
+}
+
+RowOperation unpremultiplyOperation()
+{
+    RowOperation result;
+    result.floatRow = [](gsl::span<Rgba128Float> colors)
+    {
+        for (auto &color: colors) {
+            const auto alpha = color.alpha();
+            if (alpha == 0.0f) {
+                color = {0.0f, 0.0f, 0.0f, 0.0f};
+                continue;
+            }
+            color = {color.red() / alpha, color.green() / alpha, color.blue() / alpha, alpha};
+        }
+    };
+    result.rgba8Row = [](Texture::Data line, const Offsets &offsets)
+    {
+        for (auto texel = line.data(), end = texel + line.size(); texel < end; texel += 4) {
+            const uint alpha = texel[offsets[3]];
+            if (alpha == 255)
+                continue;
+            for (size_t c = 0; c < 3; ++c)
+                texel[offsets[c]] = alpha ? divide8(texel[offsets[c]], alpha) : 0;
+        }
+    };
+    return result;
+}
+
+Texture applied(
+        const Texture &texture,
+        gsl::span<const RowOperation> operations,
+        const char *function)
+{
+    if (texture.isNull())
+        return Texture();
+
+    if (texture.isCompressed()) {
+        qCWarning(::texture) << function << "is not supported for compressed format"
+                             << texture.format();
+        return Texture();
+    }
+
+    const auto offsets = rgba8Offsets(texture.format());
+    const auto native = offsets[0] >= 0
+            && std::all_of(operations.begin(), operations.end(),
+                           [](const RowOperation &operation) { return bool(operation.rgba8Row); });
+    const auto reader = native ? TextureData::RowReader() : TextureData::getRowReader(texture.format());
+    const auto writer = native ? TextureData::RowWriter() : TextureData::getRowWriter(texture.format());
+    if (!native && (!reader || !writer)) {
+        qCWarning(::texture) << function << "is not supported for format" << texture.format();
+        return Texture();
+    }
+
+    auto result = texture.copy();
+    if (result.isNull()) // allocation failed
+        return Texture();
+
+    for (size_type layer = 0; layer < result.layers(); ++layer) {
+        for (size_type level = 0; level < result.levels(); ++level) {
+            for (size_type face = 0; face < result.faces(); ++face) {
+                const auto span = result.imageSpan({Texture::Side(face), level, layer});
+                const auto height = span.height();
+                const auto width = span.width();
+                Private::parallelFor(height * span.depth(), 4 * width, [&](size_type begin, size_type end)
+                {
+                    std::vector<Rgba128Float> buffer(static_cast<size_t>(native ? 0 : width));
+                    for (auto item = begin; item < end; ++item) {
+                        const auto line = span.line(item % height, item / height);
+                        if (native) {
+                            for (const auto &operation: operations)
+                                operation.rgba8Row(line, offsets);
+                            continue;
+                        }
+                        reader(line, buffer);
+                        for (const auto &operation: operations)
+                            operation.floatRow(buffer);
+                        writer(buffer, line);
+                    }
+                });
+            }
+        }
+    }
+
+    return result;
+}
+
+} // namespace Private
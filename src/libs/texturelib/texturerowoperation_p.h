@@ -0,0 +1,37 @@
+#ifndef TEXTUREROWOPERATION_P_H
+#define TEXTUREROWOPERATION_P_H
+
+#include "texture.h"
+
+#include <array>
+#include <functional>
+
+namespace Private {
+
+// An operation applied to each line of an image in place. Operations are chained, so several of
+// them are applied in a single pass over the texture without intermediate images.
+struct RowOperation
+{
+    // Byte offsets of the red, green, blue and alpha channels in a 4-byte texel
+    using Offsets = std::array<int, 4>;
+
+    // Processes colors of any uncompressed format decoded to floats
+    std::function<void(gsl::span<Rgba128Float>)> floatRow;
+    // Processes texels of 8-bit RGBA formats directly in the texture memory
+    std::function<void(Texture::Data, const Offsets &)> rgba8Row;
+};
+
+RowOperation swizzleOperation(const Texture::Swizzle &swizzle);
+RowOperation premultiplyOperation();
+RowOperation unpremultiplyOperation();
+
+// Returns a copy of the texture with operations applied to all images; the function name is used
+// in warnings when the format is not supported
+Texture applied(
+        const Texture &texture,
+        gsl::span<const RowOperation> operations,
+        const char *function);
+
+} // namespace Private
+
+#endif // TEXTUREROWOPERATION_P_H
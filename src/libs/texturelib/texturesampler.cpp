@@ -0,0 +1,337 @@
+#include "texturesampler.h"
+#include "cubemath_p.h"
+#include "texture_p.h"
+
+#include <QtCore/QDebug>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+using Float4 = std::array<float, 4>;
+using size_type = TextureSampler::size_type;
+using FetchFunc = Float4(*)(const uchar *);
+
+// Fast paths for the most common formats, the rest go through the generic reader
+
+Float4 fetchR8_Unorm(const uchar *d)
+{
+    return {d[0] / 255.0f, 0.0f, 0.0f, 1.0f};
+}
+
+Float4 fetchRGB8_Unorm(const uchar *d)
+{
+    return {d[0] / 255.0f, d[1] / 255.0f, d[2] / 255.0f, 1.0f};
+}
+
+Float4 fetchRGBA8_Unorm(const uchar *d)
+{
+    return {d[0] / 255.0f, d[1] / 255.0f, d[2] / 255.0f, d[3] / 255.0f};
+}
+
+Float4 fetchBGRA8_Unorm(const uchar *d)
+{
+    return {d[2] / 255.0f, d[1] / 255.0f, d[0] / 255.0f, d[3] / 255.0f};
+}
+
+Float4 fetchRGBA32_Float(const uchar *d)
+{
+    Float4 result;
+    memcpy(result.data(), d, sizeof(result));
+    return result;
+}
+
+FetchFunc fastFetchFunc(TextureFormat format)
+{
+    switch (format) {
+    case TextureFormat::R8_Unorm: return fetchR8_Unorm;
+    case TextureFormat::RGB8_Unorm: return fetchRGB8_Unorm;
+    case TextureFormat::RGBA8_Unorm: return fetchRGBA8_Unorm;
+    case TextureFormat::BGRA8_Unorm: return fetchBGRA8_Unorm;
+    case TextureFormat::RGBA32_Float: return fetchRGBA32_Float;
+    default: return nullptr;
+    }
+}
+
+constexpr Float4 lerp(const Float4 &a, const Float4 &b, float t) noexcept
+{
+    return {
+        a[0] + (b[0] - a[0]) * t,
+        a[1] + (b[1] - a[1]) * t,
+        a[2] + (b[2] - a[2]) * t,
+        a[3] + (b[3] - a[3]) * t
+    };
+}
+
+inline size_type address(size_type i, size_type size, TextureSampler::AddressMode mode) noexcept
+{
+    if (mode == TextureSampler::AddressMode::Clamp)
+        return qBound<size_type>(0, i, size - 1);
+    i %= size;
+    return i < 0 ? i + size : i;
+}
+
+inline Rgba128Float toRgba(const Float4 &color) noexcept
+{
+    return rgba128Float(color[0], color[1], color[2], color[3]);
+}
+
+} // namespace
+
+/*!
+  \class TextureSampler
+  \brief TextureSampler is a helper class to read filtered texels from a Texture.
+
+  Unlike Texture::texelColor(), the sampler resolves the format reader and the location of every
+  image only once at construction, so it is suitable for reading millions of texels.
+  Colors are returned as Rgba128Float.
+
+  The sampler holds a shallow copy of the texture, so modifying the original texture does not
+  affect the sampled data.
+
+  Only uncompressed formats are supported. For 3D textures, only the first slice is sampled.
+*/
+
+/*!
+  \enum TextureSampler::Filter
+  This enum describes how texels are filtered
+
+  \var TextureSampler::Filter TextureSampler::Point
+  The nearest texel of the nearest mipmap level is used
+
+  \var TextureSampler::Filter TextureSampler::Bilinear
+  4 nearest texels of the nearest mipmap level are interpolated
+
+  \var TextureSampler::Filter TextureSampler::Trilinear
+  Bilinear samples of the 2 nearest mipmap levels are interpolated
+*/
+
+/*!
+  \enum TextureSampler::AddressMode
+  This enum describes how texture coordinates outside the [0, 1] range are handled
+
+  \var TextureSampler::AddressMode TextureSampler::Wrap
+  The texture is repeated
+
+  \var TextureSampler::AddressMode TextureSampler::Clamp
+  Coordinates are clamped to the edge texels
+*/
+
+/*!
+  \brief Constructs a sampler bound to the given \a layer of the \a texture with the given
+  \a filter and \a addressMode.
+
+  If the texture format can't be read or the layer is out of range, a null sampler is constructed.
+*/
+TextureSampler::TextureSampler(
+        const Texture &texture,
+        Filter filter,
+        AddressMode addressMode,
+        size_type layer)
+    : m_layer(layer)
+    , m_filter(filter)
+    , m_addressMode(addressMode)
+{
+    if (texture.isNull())
+        return;
+
+    if (layer < 0 || layer >= texture.layers()) {
+        qCWarning(::texture) << "layer" << layer << "is out of bounds";
+        return;
+    }
+
+    m_reader = TextureData::getFormatReader(texture.format());
+    if (!m_reader) {
+        qCWarning(::texture) << "Sampling is not supported for format" << texture.format();
+        return;
+    }
+
+    m_texture = texture;
+    m_fetch = fastFetchFunc(texture.format());
+    m_levels = texture.levels();
+    m_faces = texture.faces();
+    m_bytesPerTexel = texture.bytesPerTexel();
+
+    m_images.reserve(size_t(m_faces * m_levels));
+    for (size_type face = 0; face < m_faces; ++face) {
+        for (size_type level = 0; level < m_levels; ++level) {
+            const auto span = m_texture.constImageSpan({Texture::Side(face), level, layer});
+            m_images.push_back({span.data(), span.width(), span.height(), span.bytesPerLine()});
+        }
+    }
+}
+
+/*!
+  \fn bool TextureSampler::isNull() const noexcept
+  \brief Returns true if the sampler is not bound to a texture.
+*/
+
+/*!
+  \fn const Texture &TextureSampler::texture() const noexcept
+  \brief Returns the texture this sampler is bound to.
+*/
+
+/*!
+  \brief Returns the color at the normalized coordinates \a u and \a v of the mipmap level
+  selected by the \a lod.
+
+  Returns a default-constructed color for a null sampler.
+*/
+Rgba128Float TextureSampler::sample(float u, float v, float lod) const
+{
+    if (isNull())
+        return {};
+    return toRgba(sampleImpl<false>(0, u, v, lod));
+}
+
+/*!
+  \brief Samples the texture at each of the given \a coords using the same \a lod and stores
+  the colors in the \a result.
+
+  The \a result should be at least as long as the \a coords.
+*/
+void TextureSampler::sample(
+        gsl::span<const TexCoord> coords,
+        gsl::span<Rgba128Float> result,
+        float lod) const
+{
+    if (result.size() < coords.size()) {
+        qCWarning(::texture) << "result is too small:" << result.size() << "<" << coords.size();
+        return;
+    }
+
+    if (isNull()) {
+        std::fill(result.begin(), result.end(), Rgba128Float());
+        return;
+    }
+
+    for (qsizetype i = 0; i < coords.size(); ++i)
+        result[i] = toRgba(sampleImpl<false>(0, coords[i].u, coords[i].v, lod));
+}
+
+/*!
+  \overload
+  \brief Samples the texture at each of the given \a coords using the same \a lod and returns
+  the colors.
+*/
+std::vector<Rgba128Float> TextureSampler::sample(
+        gsl::span<const TexCoord> coords, float lod) const
+{
+    std::vector<Rgba128Float> result(size_t(coords.size()));
+    sample(coords, result, lod);
+    return result;
+}
+
+/*!
+  \brief Returns the color of the cubemap in the direction (\a x, \a y, \a z).
+
+  Bilinear filtering is seamless - texels outside of a face are fetched from the adjacent face.
+  The address mode is ignored.
+
+  Returns a default-constructed color if the texture is not a cubemap.
+*/
+Rgba128Float TextureSampler::sampleCube(float x, float y, float z, float lod) const
+{
+    if (isNull())
+        return {};
+
+    if (m_faces != 6) {
+        qCWarning(::texture) << "sampleCube() requires a cubemap texture";
+        return {};
+    }
+
+    const auto coord = Private::directionToFace(x, y, z);
+    return toRgba(sampleImpl<true>(coord.face, coord.u, coord.v, lod));
+}
+
+TextureSampler::Float4 TextureSampler::fetch(const Image &image, size_type x, size_type y) const
+{
+    const auto data = image.data + image.bytesPerLine * y + m_bytesPerTexel * x;
+    if (m_fetch)
+        return m_fetch(data);
+    const auto color = m_reader({data, m_bytesPerTexel}).convert<Rgba128Float>();
+    return {color.red(), color.green(), color.blue(), color.alpha()};
+}
+
+TextureSampler::Float4 TextureSampler::fetchCube(
+        size_type face, size_type level, size_type x, size_type y) const
+{
+    const auto &img = image(face, level);
+    const auto size = img.width;
+    if (x >= 0 && x < size && y >= 0 && y < size)
+        return fetch(img, x, y);
+
+    // The texel lies outside of the face, find it on the adjacent one by reprojecting
+    // the direction to its center.
+    const auto s = 2.0f * (x + 0.5f) / size - 1.0f;
+    const auto t = 2.0f * (y + 0.5f) / size - 1.0f;
+    const auto dir = Private::faceToDirection(face, s, t);
+    const auto coord = Private::directionToFace(dir[0], dir[1], dir[2]);
+    const auto &other = image(coord.face, level);
+    return fetch(
+            other,
+            qBound<size_type>(0, size_type(coord.u * size), size - 1),
+            qBound<size_type>(0, size_type(coord.v * size), size - 1));
+}
+
+template<bool isCube>
+TextureSampler::Float4 TextureSampler::sampleLevel(
+        size_type face, size_type level, float u, float v, bool linear) const
+{
+    const auto &img = image(face, level);
+    const auto texel = [&](size_type x, size_type y)
+    {
+        if constexpr (isCube) {
+            return fetchCube(face, level, x, y);
+        } else {
+            return fetch(
+                    img,
+                    address(x, img.width, m_addressMode),
+                    address(y, img.height, m_addressMode));
+        }
+    };
+
+    const auto fx = u * img.width;
+    const auto fy = v * img.height;
+    if (!linear)
+        return texel(size_type(std::floor(fx)), size_type(std::floor(fy)));
+
+    const auto x = fx - 0.5f;
+    const auto y = fy - 0.5f;
+    const auto x0 = std::floor(x);
+    const auto y0 = std::floor(y);
+    const auto tx = x - x0;
+    const auto ty = y - y0;
+    const auto ix = size_type(x0);
+    const auto iy = size_type(y0);
+
+    const auto top = lerp(texel(ix, iy), texel(ix + 1, iy), tx);
+    const auto bottom = lerp(texel(ix, iy + 1), texel(ix + 1, iy + 1), tx);
+    return lerp(top, bottom, ty);
+}
+
+template<bool isCube>
+TextureSampler::Float4 TextureSampler::sampleImpl(
+        size_type face, float u, float v, float lod) const
+{
+    const auto maxLevel = float(m_levels - 1);
+    lod = qBound(0.0f, lod, maxLevel);
+
+    switch (m_filter) {
+    case Filter::Point:
+        return sampleLevel<isCube>(face, size_type(lod + 0.5f), u, v, false);
+    case Filter::Bilinear:
+        return sampleLevel<isCube>(face, size_type(lod + 0.5f), u, v, true);
+    case Filter::Trilinear: {
+        const auto level = size_type(lod);
+        const auto t = lod - level;
+        const auto color = sampleLevel<isCube>(face, level, u, v, true);
+        if (t == 0.0f)
+            return color;
+        return lerp(color, sampleLevel<isCube>(face, level + 1, u, v, true), t);
+    }
+    }
+    return {};
+}
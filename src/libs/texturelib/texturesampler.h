@@ -0,0 +1,103 @@
+#pragma once
+
+#include "texturelib_global.h"
+
+#include <TextureLib/RgbaTypes>
+#include <TextureLib/Texture>
+
+#include <gsl/span>
+
+#include <array>
+#include <functional>
+#include <vector>
+
+class TEXTURELIB_EXPORT TextureSampler
+{
+    Q_GADGET
+public:
+    using size_type = Texture::size_type;
+
+    enum class Filter {
+        Point,
+        Bilinear,
+        Trilinear,
+    };
+    Q_ENUM(Filter)
+
+    enum class AddressMode {
+        Wrap,
+        Clamp,
+    };
+    Q_ENUM(AddressMode)
+
+    struct TexCoord
+    {
+        constexpr TexCoord() noexcept = default;
+        constexpr TexCoord(float u, float v) noexcept : u(u), v(v) {}
+
+        float u {0.0f};
+        float v {0.0f};
+    };
+
+    TextureSampler() = default;
+    explicit TextureSampler(
+            const Texture &texture,
+            Filter filter = Filter::Bilinear,
+            AddressMode addressMode = AddressMode::Wrap,
+            size_type layer = 0);
+
+    bool isNull() const noexcept { return m_images.empty(); }
+
+    const Texture &texture() const noexcept { return m_texture; }
+    size_type layer() const noexcept { return m_layer; }
+
+    Filter filter() const noexcept { return m_filter; }
+    void setFilter(Filter filter) noexcept { m_filter = filter; }
+
+    AddressMode addressMode() const noexcept { return m_addressMode; }
+    void setAddressMode(AddressMode mode) noexcept { m_addressMode = mode; }
+
+    Rgba128Float sample(float u, float v, float lod = 0.0f) const;
+    Rgba128Float sample(TexCoord coord, float lod = 0.0f) const
+    { return sample(coord.u, coord.v, lod); }
+    void sample(
+            gsl::span<const TexCoord> coords,
+            gsl::span<Rgba128Float> result,
+            float lod = 0.0f) const;
+    std::vector<Rgba128Float> sample(gsl::span<const TexCoord> coords, float lod = 0.0f) const;
+
+    Rgba128Float sampleCube(float x, float y, float z, float lod = 0.0f) const;
+
+private:
+    using Float4 = std::array<float, 4>;
+    using FetchFunc = Float4(*)(const uchar *);
+
+    struct Image
+    {
+        const uchar *data {nullptr};
+        size_type width {0};
+        size_type height {0};
+        size_type bytesPerLine {0};
+    };
+
+    const Image &image(size_type face, size_type level) const
+    { return m_images[size_t(face * m_levels + level)]; }
+
+    Float4 fetch(const Image &image, size_type x, size_type y) const;
+    Float4 fetchCube(size_type face, size_type level, size_type x, size_type y) const;
+    template<bool isCube>
+    Float4 sampleLevel(size_type face, size_type level, float u, float v, bool linear) const;
+    template<bool isCube>
+    Float4 sampleImpl(size_type face, float u, float v, float lod) const;
+
+    Texture m_texture;
+    std::function<ColorVariant(Texture::ConstData)> m_reader;
+    FetchFunc m_fetch {nullptr};
+    std::vector<Image> m_images;
+    size_type m_levels {0};
+    size_type m_faces {0};
+    size_type m_bytesPerTexel {0};
+    size_type m_layer {0};
+    Filter m_filter {Filter::Bilinear};
+    AddressMode m_addressMode {AddressMode::Wrap};
+};
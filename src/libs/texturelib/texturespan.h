@@ -0,0 +1,203 @@
+#ifndef TEXTURESPAN_H
+#define TEXTURESPAN_H
+
+#include "texturelib_global.h"
+
+#include <TextureLib/TextureFormat>
+#include <TextureLib/TextureFormatInfo>
+
+#include <gsl/span>
+
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+
+template<typename T>
+class BasicTextureSpan
+{
+public:
+    using size_type = qsizetype;
+    using value_type = T;
+    using pointer = T *;
+    using Line = gsl::span<T>;
+
+    class LineIterator;
+
+    constexpr BasicTextureSpan() noexcept = default;
+    BasicTextureSpan(
+            pointer data,
+            TextureFormat format,
+            size_type width,
+            size_type height,
+            size_type depth,
+            size_type bytesPerLine,
+            size_type bytesPerSlice) noexcept
+        : m_data(data)
+        , m_format(format)
+        , m_width(width)
+        , m_height(height)
+        , m_depth(depth)
+        , m_bytesPerLine(bytesPerLine)
+        , m_bytesPerSlice(bytesPerSlice)
+    {
+        const auto &info = TextureFormatInfo::formatInfo(format);
+        m_bytesPerTexel = info.bytesPerTexel();
+        m_blockSize = info.blockSize();
+    }
+
+    template<typename U, typename = std::enable_if_t<
+                 std::is_same<const U, T>::value && !std::is_same<U, T>::value>>
+    constexpr BasicTextureSpan(const BasicTextureSpan<U> &other) noexcept
+        : m_data(other.data())
+        , m_format(other.format())
+        , m_width(other.width())
+        , m_height(other.height())
+        , m_depth(other.depth())
+        , m_bytesPerLine(other.bytesPerLine())
+        , m_bytesPerSlice(other.bytesPerSlice())
+        , m_bytesPerTexel(other.bytesPerTexel())
+        , m_blockSize(other.blockSize())
+    {}
+
+    constexpr bool isNull() const noexcept { return !m_data; }
+
+    constexpr pointer data() const noexcept { return m_data; }
+    constexpr TextureFormat format() const noexcept { return m_format; }
+    constexpr bool isCompressed() const noexcept { return m_blockSize != 0; }
+
+    constexpr size_type width() const noexcept { return m_width; }
+    constexpr size_type height() const noexcept { return m_height; }
+    constexpr size_type depth() const noexcept { return m_depth; }
+
+    constexpr size_type bytesPerTexel() const noexcept { return m_bytesPerTexel; }
+    constexpr size_type blockSize() const noexcept { return m_blockSize; }
+    constexpr size_type bytesPerLine() const noexcept { return m_bytesPerLine; }
+    constexpr size_type bytesPerSlice() const noexcept { return m_bytesPerSlice; }
+
+    constexpr size_type lineCount() const noexcept
+    { return isCompressed() ? std::max<size_type>(1, (m_height + 3) / 4) : m_height; }
+    constexpr size_type lineSize() const noexcept
+    {
+        return isCompressed()
+                ? std::max<size_type>(1, (m_width + 3) / 4) * m_blockSize
+                : m_width * m_bytesPerTexel;
+    }
+
+    constexpr size_type bytes() const noexcept
+    {
+        if (isNull())
+            return 0;
+        return (m_depth - 1) * m_bytesPerSlice + (lineCount() - 1) * m_bytesPerLine + lineSize();
+    }
+
+    constexpr gsl::span<T> bytesSpan() const noexcept { return {m_data, bytes()}; }
+
+    constexpr Line line(size_type y, size_type z = 0) const noexcept
+    {
+        if (y < 0 || y >= lineCount() || z < 0 || z >= m_depth)
+            return {};
+        return {m_data + m_bytesPerSlice * z + m_bytesPerLine * y, lineSize()};
+    }
+
+    constexpr Line texel(size_type x, size_type y, size_type z = 0) const noexcept
+    {
+        if (isCompressed() || x < 0 || x >= m_width)
+            return {};
+        const auto result = line(y, z);
+        if (result.empty())
+            return {};
+        return result.subspan(m_bytesPerTexel * x, m_bytesPerTexel);
+    }
+
+    constexpr BasicTextureSpan slice(size_type z) const noexcept
+    { return subSpan(0, 0, z, m_width, m_height, 1); }
+
+    constexpr BasicTextureSpan subSpan(
+            size_type x,
+            size_type y,
+            size_type z,
+            size_type width,
+            size_type height,
+            size_type depth = 1) const noexcept
+    {
+        if (isNull()
+                || x < 0 || y < 0 || z < 0
+                || width <= 0 || height <= 0 || depth <= 0
+                || x + width > m_width || y + height > m_height || z + depth > m_depth) {
+            return {};
+        }
+
+        auto result = *this;
+        result.m_width = width;
+        result.m_height = height;
+        result.m_depth = depth;
+        if (isCompressed()) {
+            // only block-aligned regions can be addressed in compressed data
+            if (x % 4 || y % 4 || (width % 4 && x + width != m_width)
+                    || (height % 4 && y + height != m_height)) {
+                return {};
+            }
+            result.m_data = m_data + m_bytesPerSlice * z + m_bytesPerLine * (y / 4)
+                    + m_blockSize * (x / 4);
+        } else {
+            result.m_data = m_data + m_bytesPerSlice * z + m_bytesPerLine * y
+                    + m_bytesPerTexel * x;
+        }
+        return result;
+    }
+
+    constexpr LineIterator begin() const noexcept { return LineIterator(*this, 0); }
+    constexpr LineIterator end() const noexcept
+    { return LineIterator(*this, isNull() ? 0 : lineCount() * m_depth); }
+
+private:
+    pointer m_data {nullptr};
+    TextureFormat m_format {TextureFormat::Invalid};
+    size_type m_width {0};
+    size_type m_height {0};
+    size_type m_depth {0};
+    size_type m_bytesPerLine {0};
+    size_type m_bytesPerSlice {0};
+    size_type m_bytesPerTexel {0};
+    size_type m_blockSize {0};
+};
+
+template<typename T>
+class BasicTextureSpan<T>::LineIterator
+{
+public:
+    using size_type = typename BasicTextureSpan::size_type;
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename BasicTextureSpan::Line;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = typename BasicTextureSpan::Line;
+
+    constexpr LineIterator() noexcept = default;
+    constexpr LineIterator(const BasicTextureSpan &span, size_type index) noexcept
+        : m_span(span)
+        , m_index(index)
+    {}
+
+    constexpr size_type y() const noexcept { return m_index % m_span.lineCount(); }
+    constexpr size_type z() const noexcept { return m_index / m_span.lineCount(); }
+
+    constexpr reference operator*() const noexcept { return m_span.line(y(), z()); }
+
+    constexpr LineIterator &operator++() noexcept { ++m_index; return *this; }
+    constexpr LineIterator operator++(int) noexcept { auto result = *this; ++m_index; return result; }
+
+    friend constexpr bool operator==(const LineIterator &lhs, const LineIterator &rhs) noexcept
+    { return lhs.m_span.data() == rhs.m_span.data() && lhs.m_index == rhs.m_index; }
+    friend constexpr bool operator!=(const LineIterator &lhs, const LineIterator &rhs) noexcept
+    { return !(lhs == rhs); }
+
+private:
+    BasicTextureSpan m_span;
+    size_type m_index {0};
+};
+
+using TextureSpan = BasicTextureSpan<uchar>;
+using ConstTextureSpan = BasicTextureSpan<const uchar>;
+
+#endif // TEXTURESPAN_H
@@ -0,0 +1,284 @@
+#include "texturestatistics.h"
+#include "texture_p.h"
+#include "textureparallel_p.h"
+
+#include <QtCore/QDebug>
+#include <QtCore/QMetaEnum>
+#include <QtCore/QMutex>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+using size_type = TextureStatistics::size_type;
+using Histogram = TextureStatistics::Histogram;
+
+// Reduction state of a band of rows, merged into the total when the band is done
+struct Partial
+{
+    std::array<float, 4> min;
+    std::array<float, 4> max;
+    std::array<double, 4> sum {};
+    std::array<double, 4> sumSquares {};
+    std::array<size_type, 4> count {};
+    std::array<Histogram, 4> histogram {};
+    size_type nanCount {0};
+    size_type infCount {0};
+    // alpha values that are neither 0 nor 1
+    size_type partialAlphaCount {0};
+
+    Partial()
+    {
+        min.fill(std::numeric_limits<float>::max());
+        max.fill(std::numeric_limits<float>::lowest());
+    }
+
+    void merge(const Partial &other)
+    {
+        for (size_t c = 0; c < 4; ++c) {
+            min[c] = std::min(min[c], other.min[c]);
+            max[c] = std::max(max[c], other.max[c]);
+            sum[c] += other.sum[c];
+            sumSquares[c] += other.sumSquares[c];
+            count[c] += other.count[c];
+            for (size_t i = 0; i < size_t(TextureStatistics::HistogramSize); ++i)
+                histogram[c][i] += other.histogram[c][i];
+        }
+        nanCount += other.nanCount;
+        infCount += other.infCount;
+        partialAlphaCount += other.partialAlphaCount;
+    }
+};
+
+inline size_t histogramBin(float value) noexcept
+{
+    constexpr auto size = TextureStatistics::HistogramSize;
+    return size_t(qBound(0, int(value * size), size - 1));
+}
+
+// Byte offsets of the red, green, blue and alpha channels in a texel, -1 if there is no channel
+struct Layout8
+{
+    int bytesPerTexel {0};
+    std::array<int, 4> offsets {};
+};
+
+// 8-bit UNorm formats are reduced in integers directly over the texture data
+Layout8 layout8(TextureFormat format)
+{
+    switch (format) {
+    case TextureFormat::R8_Unorm: return {1, {0, -1, -1, -1}};
+    case TextureFormat::RG8_Unorm: return {2, {0, 1, -1, -1}};
+    case TextureFormat::RGB8_Unorm: return {3, {0, 1, 2, -1}};
+    case TextureFormat::RGBA8_Unorm: return {4, {0, 1, 2, 3}};
+    case TextureFormat::BGRA8_Unorm: return {4, {2, 1, 0, 3}};
+    default: return {};
+    }
+}
+
+void reduce8(const Layout8 &layout, Texture::ConstData line, Partial &partial)
+{
+    std::array<int, 4> min = {255, 255, 255, 255};
+    std::array<int, 4> max = {0, 0, 0, 0};
+    std::array<quint64, 4> sum {};
+    std::array<quint64, 4> sumSquares {};
+
+    const auto texelCount = line.size() / layout.bytesPerTexel;
+    const auto data = line.data();
+    for (size_t c = 0; c < 4; ++c) {
+        const auto offset = layout.offsets[c];
+        auto &histogram = partial.histogram[c];
+        if (offset < 0) {
+            // missing color channels read as 0, missing alpha as 1
+            const auto value = c == 3 ? 255 : 0;
+            min[c] = max[c] = value;
+            sum[c] = quint64(value) * quint64(texelCount);
+            sumSquares[c] = quint64(value * value) * quint64(texelCount);
+            histogram[size_t(value)] += quint64(texelCount);
+            continue;
+        }
+
+        auto p = data + offset;
+        for (qsizetype i = 0; i < texelCount; ++i, p += layout.bytesPerTexel) {
+            const int value = *p;
+            min[c] = std::min(min[c], value);
+            max[c] = std::max(max[c], value);
+            sum[c] += quint64(value);
+            sumSquares[c] += quint64(value * value);
+            ++histogram[size_t(value)];
+        }
+    }
+
+    for (size_t c = 0; c < 4; ++c) {
+        partial.min[c] = std::min(partial.min[c], min[c] / 255.0f);
+        partial.max[c] = std::max(partial.max[c], max[c] / 255.0f);
+        partial.sum[c] += sum[c] / 255.0;
+        partial.sumSquares[c] += sumSquares[c] / (255.0 * 255.0);
+        partial.count[c] += texelCount;
+    }
+}
+
+void reduceFloat(gsl::span<const Rgba128Float> colors, Partial &partial)
+{
+    for (const auto &color: colors) {
+        const std::array<float, 4> values = {color.red(), color.green(), color.blue(), color.alpha()};
+        for (size_t c = 0; c < 4; ++c) {
+            const auto value = values[c];
+            if (std::isnan(value)) {
+                ++partial.nanCount;
+                continue;
+            }
+            if (std::isinf(value)) {
+                ++partial.infCount;
+                continue;
+            }
+            partial.min[c] = std::min(partial.min[c], value);
+            partial.max[c] = std::max(partial.max[c], value);
+            partial.sum[c] += value;
+            partial.sumSquares[c] += double(value) * value;
+            ++partial.count[c];
+            ++partial.histogram[c][histogramBin(value)];
+        }
+        if (values[3] != 0.0f && values[3] != 1.0f && !std::isnan(values[3]))
+            ++partial.partialAlphaCount;
+    }
+}
+
+} // namespace
+
+/*!
+  \class TextureStatistics
+  \brief TextureStatistics contains per-channel statistics of a texture image.
+
+  Statistics are computed over the colors converted to the [0, 1] range for normalized formats;
+  channels missing in the format read as 0 for colors and as 1 for the alpha. NaN and infinite
+  values are counted separately and excluded from other statistics.
+
+  8-bit normalized formats are reduced directly over the texture data, other formats are decoded
+  line by line. Bands of lines are processed in parallel, partial results of each band are merged
+  at the end.
+*/
+
+/*!
+  \enum TextureStatistics::AlphaUsage
+  This enum describes how the alpha channel is used
+
+  \var TextureStatistics::AlphaUsage TextureStatistics::Opaque
+  All texels are opaque, the alpha channel can be dropped
+
+  \var TextureStatistics::AlphaUsage TextureStatistics::Binary
+  All texels are either opaque or fully transparent, 1-bit alpha is enough
+
+  \var TextureStatistics::AlphaUsage TextureStatistics::Full
+  The alpha channel has intermediate values
+*/
+
+/*!
+  \brief Computes statistics of the image at the given \a index of the \a texture.
+
+  For 3D textures, all slices are included. Compressed formats are not supported, a null
+  object is constructed in that case.
+*/
+TextureStatistics::TextureStatistics(const Texture &texture, Texture::ArrayIndex index)
+{
+    if (texture.isNull())
+        return;
+
+    if (texture.isCompressed()) {
+        qCWarning(::texture) << "Statistics are not supported for compressed format"
+                             << texture.format();
+        return;
+    }
+
+    const auto span = texture.constImageSpan(index);
+    if (span.isNull()) // invalid index
+        return;
+
+    const auto layout = layout8(texture.format());
+    const auto reader = layout.bytesPerTexel
+            ? TextureData::RowReader()
+            : TextureData::getRowReader(texture.format());
+    if (!layout.bytesPerTexel && !reader) {
+        qCWarning(::texture) << "Statistics are not supported for format" << texture.format();
+        return;
+    }
+
+    Partial total;
+    QMutex mutex;
+    const auto width = span.width();
+    const auto height = span.height();
+    Private::parallelFor(height * span.depth(), 4 * width, [&](size_type begin, size_type end)
+    {
+        Partial partial;
+        std::vector<Rgba128Float> buffer(static_cast<size_t>(reader ? width : 0));
+        for (auto line = begin; line < end; ++line) {
+            const auto data = span.line(line % height, line / height);
+            if (reader) {
+                reader(data, buffer);
+                reduceFloat(buffer, partial);
+            } else {
+                reduce8(layout, data, partial);
+            }
+        }
+        QMutexLocker locker(&mutex);
+        total.merge(partial);
+    });
+
+    m_texelCount = width * height * span.depth();
+    m_nanCount = total.nanCount;
+    m_infCount = total.infCount;
+    for (size_t c = 0; c < ChannelCount; ++c) {
+        auto &channel = m_channels[c];
+        const auto count = total.count[c];
+        channel.histogram = total.histogram[c];
+        if (!count)
+            continue;
+        channel.min = total.min[c];
+        channel.max = total.max[c];
+        channel.mean = total.sum[c] / count;
+        const auto variance = total.sumSquares[c] / count - channel.mean * channel.mean;
+        channel.stdDev = std::sqrt(std::max(variance, 0.0));
+    }
+
+    const auto &alphaHistogram = m_channels[Alpha].histogram;
+    if (m_channels[Alpha].min >= 1.0f)
+        m_alphaUsage = AlphaUsage::Opaque;
+    else if (layout.bytesPerTexel ? std::all_of(alphaHistogram.begin() + 1, alphaHistogram.end() - 1,
+                                                [](quint64 bin) { return bin == 0; })
+                                  : total.partialAlphaCount == 0)
+        m_alphaUsage = AlphaUsage::Binary;
+    else
+        m_alphaUsage = AlphaUsage::Full;
+}
+
+/*!
+  \fn bool TextureStatistics::isNull() const noexcept
+  \brief Returns true if statistics were not computed.
+*/
+
+/*!
+  \fn size_type TextureStatistics::texelCount() const noexcept
+  \brief Returns the number of texels in the image.
+*/
+
+/*!
+  \fn size_type TextureStatistics::nanCount() const noexcept
+  \brief Returns the number of NaN channel values.
+*/
+
+/*!
+  \fn size_type TextureStatistics::infCount() const noexcept
+  \brief Returns the number of infinite channel values.
+*/
+
+/*!
+  \fn AlphaUsage TextureStatistics::alphaUsage() const noexcept
+  \brief Returns how the alpha channel is used.
+*/
+
+QString toQString(TextureStatistics::AlphaUsage usage)
+{
+    return QMetaEnum::fromType<TextureStatistics::AlphaUsage>().valueToKey(int(usage));
+}
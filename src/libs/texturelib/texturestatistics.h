@@ -0,0 +1,68 @@
+#pragma once
+
+#include "texturelib_global.h"
+
+#include <TextureLib/Texture>
+
+#include <array>
+
+class TEXTURELIB_EXPORT TextureStatistics
+{
+    Q_GADGET
+public:
+    using size_type = Texture::size_type;
+
+    enum class AlphaUsage {
+        Opaque, // all texels are opaque
+        Binary, // all texels are either opaque or fully transparent
+        Full,
+    };
+    Q_ENUM(AlphaUsage)
+
+    static constexpr int HistogramSize = 256;
+    using Histogram = std::array<quint64, HistogramSize>;
+
+    struct Channel
+    {
+        float min {0.0f};
+        float max {0.0f};
+        double mean {0.0};
+        double stdDev {0.0};
+        // values in [0, 1] range, values outside are counted in the first or the last bin
+        Histogram histogram {};
+    };
+
+    enum ChannelIndex {
+        Red = 0,
+        Green,
+        Blue,
+        Alpha,
+        ChannelCount
+    };
+
+    TextureStatistics() = default;
+    explicit TextureStatistics(const Texture &texture, Texture::ArrayIndex index = {});
+
+    bool isNull() const noexcept { return m_texelCount == 0; }
+
+    size_type texelCount() const noexcept { return m_texelCount; }
+    size_type nanCount() const noexcept { return m_nanCount; }
+    size_type infCount() const noexcept { return m_infCount; }
+
+    const Channel &channel(ChannelIndex index) const { return m_channels[size_t(index)]; }
+    const Channel &red() const noexcept { return m_channels[Red]; }
+    const Channel &green() const noexcept { return m_channels[Green]; }
+    const Channel &blue() const noexcept { return m_channels[Blue]; }
+    const Channel &alpha() const noexcept { return m_channels[Alpha]; }
+
+    AlphaUsage alphaUsage() const noexcept { return m_alphaUsage; }
+
+private:
+    std::array<Channel, ChannelCount> m_channels {};
+    size_type m_texelCount {0};
+    size_type m_nanCount {0};
+    size_type m_infCount {0};
+    AlphaUsage m_alphaUsage {AlphaUsage::Opaque};
+};
+
+QString TEXTURELIB_EXPORT toQString(TextureStatistics::AlphaUsage usage);
@@ -0,0 +1,275 @@
+#include "texturetransform_p.h"
+#include "textureparallel_p.h"
+
+#include <array>
+#include <cstring>
+#include <type_traits>
+
+namespace Private {
+
+namespace {
+
+using size_type = TextureSpan::size_type;
+
+// Texels of a 4x4 block; new texel i takes the old texel permutation[i]
+using BlockPermutation = std::array<int, 16>;
+
+// Per-texel indices of a block stored in 16 * bits consecutive bits starting at the byte offset
+struct IndexField
+{
+    int offset {0};
+    int bits {0};
+};
+
+// Block-compressed formats whose texels are addressed only by per-texel indices, so moving
+// blocks and permuting index bits transforms the image without decoding it
+struct BlockLayout
+{
+    int fieldCount {0};
+    std::array<IndexField, 2> fields {};
+};
+
+BlockLayout blockLayout(TextureFormat format) noexcept
+{
+    switch (format) {
+    case TextureFormat::Bc1Rgb_Unorm:
+    case TextureFormat::Bc1Rgb_Srgb:
+    case TextureFormat::Bc1Rgba_Unorm:
+    case TextureFormat::Bc1Rgba_Srgb: return {1, {{{4, 2}}}};
+    case TextureFormat::Bc2_Unorm:
+    case TextureFormat::Bc2_Srgb: return {2, {{{0, 4}, {12, 2}}}};
+    case TextureFormat::Bc3_Unorm:
+    case TextureFormat::Bc3_Srgb: return {2, {{{2, 3}, {12, 2}}}};
+    case TextureFormat::Bc4_Unorm:
+    case TextureFormat::Bc4_Snorm: return {1, {{{2, 3}}}};
+    case TextureFormat::Bc5_Unorm:
+    case TextureFormat::Bc5_Snorm: return {2, {{{2, 3}, {10, 3}}}};
+    default: return {};
+    }
+}
+
+void permuteField(uchar *data, const IndexField &field, const BlockPermutation &permutation) noexcept
+{
+    const auto bytes = 2 * field.bits;
+    const auto mask = (quint64(1) << field.bits) - 1;
+
+    quint64 indices = 0;
+    for (int i = 0; i < bytes; ++i)
+        indices |= quint64(data[i]) << (8 * i);
+
+    quint64 result = 0;
+    for (int i = 0; i < 16; ++i)
+        result |= ((indices >> (permutation[size_t(i)] * field.bits)) & mask) << (i * field.bits);
+
+    for (int i = 0; i < bytes; ++i)
+        data[i] = uchar(result >> (8 * i));
+}
+
+void permuteBlocks(
+        gsl::span<uchar> line,
+        size_type blockSize,
+        const BlockLayout &layout,
+        const BlockPermutation &permutation) noexcept
+{
+    for (auto block = line.data(), end = block + line.size(); block < end; block += blockSize) {
+        for (int i = 0; i < layout.fieldCount; ++i) {
+            const auto &field = layout.fields[size_t(i)];
+            permuteField(block + field.offset, field, permutation);
+        }
+    }
+}
+
+// Reverses the first rows (or columns) of a block, the rest of the block is outside of the image
+BlockPermutation flipPermutation(Qt::Orientations orientations, size_type width, size_type height)
+{
+    const auto columns = int(std::min<size_type>(width, 4));
+    const auto rows = int(std::min<size_type>(height, 4));
+    const auto flipX = orientations.testFlag(Qt::Horizontal);
+    const auto flipY = orientations.testFlag(Qt::Vertical);
+
+    BlockPermutation result;
+    for (int y = 0; y < 4; ++y) {
+        for (int x = 0; x < 4; ++x) {
+            const auto sourceX = flipX && x < columns ? columns - 1 - x : x;
+            const auto sourceY = flipY && y < rows ? rows - 1 - y : y;
+            result[size_t(y * 4 + x)] = sourceY * 4 + sourceX;
+        }
+    }
+    return result;
+}
+
+BlockPermutation transposePermutation()
+{
+    BlockPermutation result;
+    for (int y = 0; y < 4; ++y) {
+        for (int x = 0; x < 4; ++x)
+            result[size_t(y * 4 + x)] = x * 4 + y;
+    }
+    return result;
+}
+
+// Calls func with the element size as a compile-time constant, so copying an element compiles
+// to plain moves
+template<typename Func>
+void withElementSize(size_type size, const Func &func)
+{
+    switch (size) {
+    case 1: func(std::integral_constant<size_t, 1>()); break;
+    case 2: func(std::integral_constant<size_t, 2>()); break;
+    case 3: func(std::integral_constant<size_t, 3>()); break;
+    case 4: func(std::integral_constant<size_t, 4>()); break;
+    case 6: func(std::integral_constant<size_t, 6>()); break;
+    case 8: func(std::integral_constant<size_t, 8>()); break;
+    case 12: func(std::integral_constant<size_t, 12>()); break;
+    case 16: func(std::integral_constant<size_t, 16>()); break;
+    default: Q_UNREACHABLE();
+    }
+}
+
+template<size_t N>
+void reverseElements(uchar *data, size_type count) noexcept
+{
+    uchar temp[N];
+    for (auto lhs = data, rhs = data + N * size_t(count - 1); lhs < rhs; lhs += N, rhs -= N) {
+        std::memcpy(temp, lhs, N);
+        std::memcpy(lhs, rhs, N);
+        std::memcpy(rhs, temp, N);
+    }
+}
+
+// Elements are copied in square tiles, so both the source and the destination lines of a tile
+// stay in the cache
+constexpr size_type transposeTile = 16;
+
+template<size_t N>
+void transposeTiles(
+        ConstTextureSpan source,
+        TextureSpan destination,
+        size_type z,
+        size_type tileRow,
+        size_type columns,
+        size_type rows)
+{
+    const auto y0 = tileRow * transposeTile;
+    const auto y1 = std::min(rows, y0 + transposeTile);
+    for (size_type x0 = 0; x0 < columns; x0 += transposeTile) {
+        const auto x1 = std::min(columns, x0 + transposeTile);
+        for (auto y = y0; y < y1; ++y) {
+            auto dst = destination.line(y, z).data() + N * size_t(x0);
+            for (auto x = x0; x < x1; ++x, dst += N)
+                std::memcpy(dst, source.line(x, z).data() + N * size_t(y), N);
+        }
+    }
+}
+
+size_type elementSize(const ConstTextureSpan &span) noexcept
+{
+    return span.isCompressed() ? span.blockSize() : span.bytesPerTexel();
+}
+
+size_type columnCount(const ConstTextureSpan &span) noexcept
+{
+    return span.lineSize() / elementSize(span);
+}
+
+} // namespace
+
+bool canTransform(TextureFormat format) noexcept
+{
+    const auto &info = TextureFormatInfo::formatInfo(format);
+    if (info.isCompressed())
+        return blockLayout(format).fieldCount != 0;
+    switch (info.bytesPerTexel()) {
+    case 1: case 2: case 3: case 4: case 6: case 8: case 12: case 16:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool canFlip(ConstTextureSpan span, Qt::Orientations orientations) noexcept
+{
+    if (!span.isCompressed())
+        return true;
+    const auto fits = [](size_type size) { return size < 4 || size % 4 == 0; };
+    return (!orientations.testFlag(Qt::Horizontal) || fits(span.width()))
+            && (!orientations.testFlag(Qt::Vertical) || fits(span.height()));
+}
+
+void flip(TextureSpan span, Qt::Orientations orientations)
+{
+    if (span.isNull() || !orientations)
+        return;
+
+    const auto layout = blockLayout(span.format());
+    const auto permutation = flipPermutation(orientations, span.width(), span.height());
+    const auto rows = span.lineCount();
+    const auto columns = columnCount(span);
+    const auto flipX = orientations.testFlag(Qt::Horizontal);
+    const auto flipY = orientations.testFlag(Qt::Vertical);
+
+    // each item is a pair of lines swapped with each other, the middle line is paired with itself
+    const auto pairs = flipY ? (rows + 1) / 2 : rows;
+    withElementSize(elementSize(span), [&](auto size)
+    {
+        constexpr size_t N = decltype(size)::value;
+        const auto process = [&](gsl::span<uchar> line)
+        {
+            if (flipX)
+                reverseElements<N>(line.data(), columns);
+            if (span.isCompressed())
+                permuteBlocks(line, N, layout, permutation);
+        };
+
+        Private::parallelFor(pairs * span.depth(), 2 * span.lineSize(), [&](size_type begin, size_type end)
+        {
+            for (auto item = begin; item < end; ++item) {
+                const auto z = item / pairs;
+                const auto y = item % pairs;
+                auto line = span.line(y, z);
+                if (flipY && y != rows - 1 - y) {
+                    auto other = span.line(rows - 1 - y, z);
+                    std::swap_ranges(line.data(), line.data() + line.size(), other.data());
+                    process(other);
+                }
+                process(line);
+            }
+        });
+    });
+}
+
+void transpose(ConstTextureSpan source, TextureSpan destination)
+{
+    if (source.isNull() || destination.isNull())
+        return;
+
+    Q_ASSERT(source.format() == destination.format());
+    Q_ASSERT(source.width() == destination.height() && source.height() == destination.width());
+
+    const auto layout = blockLayout(source.format());
+    const auto permutation = transposePermutation();
+    const auto rows = destination.lineCount();
+    const auto columns = columnCount(destination);
+    const auto tileRows = (rows + transposeTile - 1) / transposeTile;
+
+    withElementSize(elementSize(source), [&](auto size)
+    {
+        constexpr size_t N = decltype(size)::value;
+        const auto cost = transposeTile * destination.lineSize();
+        Private::parallelFor(tileRows * source.depth(), cost, [&](size_type begin, size_type end)
+        {
+            for (auto item = begin; item < end; ++item) {
+                const auto z = item / tileRows;
+                const auto tileRow = item % tileRows;
+                transposeTiles<N>(source, destination, z, tileRow, columns, rows);
+                if (!destination.isCompressed())
+                    continue;
+                const auto y1 = std::min(rows, (tileRow + 1) * transposeTile);
+                for (auto y = tileRow * transposeTile; y < y1; ++y)
+                    permuteBlocks(destination.line(y, z), N, layout, permutation);
+            }
+        });
+    });
+}
+
+} // namespace Private
@@ -0,0 +1,25 @@
+#ifndef TEXTURETRANSFORM_P_H
+#define TEXTURETRANSFORM_P_H
+
+#include "texturespan.h"
+
+#include <QtCore/qnamespace.h>
+
+namespace Private {
+
+// Returns true if images of the format can be flipped and transposed; block-compressed formats
+// are supported when the layout of their index bits is known
+bool canTransform(TextureFormat format) noexcept;
+
+// Compressed images can be flipped only when the flipped dimension is a multiple of the block
+// size or fits into a single block
+bool canFlip(ConstTextureSpan span, Qt::Orientations orientations) noexcept;
+
+void flip(TextureSpan span, Qt::Orientations orientations);
+
+// The destination should have the width and the height of the source swapped
+void transpose(ConstTextureSpan source, TextureSpan destination);
+
+} // namespace Private
+
+#endif // TEXTURETRANSFORM_P_H
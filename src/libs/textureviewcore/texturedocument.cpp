@@ -5,8 +5,12 @@
 #include <QPixmap>
 
 #include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QPointer>
 #include <QtCore/QSysInfo>
 
+#include <atomic>
+
 namespace TextureViewer {
 
 class TextureDocumentPrivate
@@ -22,6 +26,10 @@ public:
 
     std::unique_ptr<QFutureWatcher<TextureIO::ReadResult>> readWatcher;
     std::unique_ptr<QFutureWatcher<TextureIO::WriteResult>> writeWatcher;
+    // incremented on each open or cancel so previews of a stale read are dropped
+    quint64 openId {0};
+    // stops the reading thread when the open is canceled
+    std::shared_ptr<std::atomic_bool> openCanceled;
 };
 
 /*!
@@ -45,6 +53,7 @@ TextureDocument::TextureDocument(QObject *parent)
         const auto future = d->readWatcher->future();
         if (future.isCanceled())
             return;
+        ++d->openId;
         const auto result = future.result();
         if (result) {
             setTexture(*result);
@@ -75,7 +84,12 @@ TextureDocument::TextureDocument(QObject *parent)
 /*!
   Destroys the TextureDocument object.
 */
-TextureDocument::~TextureDocument() = default;
+TextureDocument::~TextureDocument()
+{
+    Q_D(TextureDocument);
+    if (d->openCanceled)
+        *d->openCanceled = true;
+}
 
 /*!
   \property Texture TextureDocument::texture
@@ -119,21 +133,16 @@ void TextureDocument::setTexture(const Texture &texture)
                 item->level = level;
                 item->layer = layer;
                 item->face = face;
-                auto image = Texture(
-                        d->visibleTexture.format(),
-                        {d->visibleTexture.width(level), d->visibleTexture.height(level)},
-                        {1, 1},
-                        d->visibleTexture.alignment());
-                if (image.isNull()) {
+                const auto span =
+                        d->visibleTexture.constImageSpan({Texture::Side(face), level, layer});
+                if (span.isNull()) {
                     qWarning() << "Can't create slice";
                     d->items.clear();
                     break;
                 }
-                const auto imageData = d->visibleTexture.imageData({Texture::Side(face), level, layer});
-                Q_ASSERT(imageData.size() == image.imageData({}).size());
-                memcpy(image.imageData({}).data(), imageData.data(), imageData.size());
-                item->texture = image;
-                item->thumbnail = image.toImage();
+                item->image = span;
+                // The thumbnail shares the data with the visible texture
+                item->thumbnail = d->visibleTexture.toImage({Texture::Side(face), level, layer});
                 d->items.push_back(std::move(item));
             }
         }
@@ -234,11 +243,32 @@ void TextureDocument::doOpen(const QUrl &url)
         return;
     }
 
-    const auto openFunc = [](QUrl url) -> TextureIO::ReadResult
+    // Levels are read from the smallest one and shown as previews until the whole texture is
+    // read. Previews are delivered to the application object rather than to the document, so
+    // the guard pointer is only dereferenced in the GUI thread.
+    const auto onLevelRead = [document = QPointer<TextureDocument>(this), id = ++d->openId](
+            Texture::size_type level, const Texture &texture)
+    {
+        if (level == 0) // the whole texture is delivered when the read is finished
+            return;
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [document, id, texture]()
+        {
+            if (!document || document->d_func()->openId != id)
+                return;
+            document->setTexture(texture);
+        }, Qt::QueuedConnection);
+    };
+
+    if (d->openCanceled)
+        *d->openCanceled = true; // stop a previous read, if any
+    d->openCanceled = std::make_shared<std::atomic_bool>(false);
+    const auto openFunc = [onLevelRead, canceled = d->openCanceled](
+            QUrl url) -> TextureIO::ReadResult
     {
         const auto path = url.toLocalFile();
         TextureIO io(path);
-        return io.read();
+        io.setCancelToken(canceled);
+        return io.readProgressive(onLevelRead, TextureIO::LevelOrder::SmallestFirst);
     };
 
     d->readWatcher->setFuture(QtConcurrent::run(openFunc, url));
@@ -273,6 +303,9 @@ void TextureDocument::doCancel()
 {
     Q_D(TextureDocument);
     if (state() == State::Opening) {
+        ++d->openId;
+        if (d->openCanceled)
+            *d->openCanceled = true;
         d->readWatcher->future().cancel();
         d->readWatcher->setFuture(QFuture<TextureIO::ReadResult>());
         openFinished(false, tr("Canceled"));
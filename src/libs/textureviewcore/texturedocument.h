@@ -95,7 +95,7 @@ public:
     size_type level {0};
     size_type layer {0};
     size_type face {0};
-    Texture texture;
+    ConstTextureSpan image;
     QImage thumbnail;
 };
 
@@ -45,13 +45,18 @@
 #include "ddsheader.h"
 
 #include <TextureLib/Texture>
+#include <TextureLib/TextureInfo>
 #include <TextureLib/TextureIOHandlerPlugin>
+#include <TextureLib/TextureReadOptions>
 
 #include <QtCore/QDebug>
 #include <QtCore/QtMath>
 
 #include <gsl/span>
 
+#include <algorithm>
+#include <iterator>
+
 namespace {
 
 constexpr auto maxInt = std::numeric_limits<int>::max();
@@ -465,18 +470,13 @@ bool verifyHeaderDX10(const DDSHeaderDX10 &header)
     return true;
 }
 
-} // namespace
-
-bool DDSHandler::read(Texture &texture)
+bool readHeader(DDSHandler::QIODevicePointer device, DDSHeader &header, DDSHeaderDX10 &header10)
 {
-    if (device()->peek(4) != QByteArrayLiteral("DDS "))
+    if (device->peek(4) != QByteArrayLiteral("DDS "))
         return false;
 
-    DDSHeader header;
-    DDSHeaderDX10 header10;
-
     {
-        QDataStream s(device().get());
+        QDataStream s(device.get());
         s.setByteOrder(QDataStream::LittleEndian);
         s >> header;
         if (isDX10(header))
@@ -494,26 +494,65 @@ bool DDSHandler::read(Texture &texture)
     if (isDX10(header) && !verifyHeaderDX10(header10))
         return false;
 
+    return true;
+}
+
+TextureInfo getInfo(const DDSHeader &header, const DDSHeaderDX10 &header10)
+{
+    const auto textureFormat = getFormat(header, header10);
+    if (textureFormat == TextureFormat::Invalid)
+        return {};
+
     const auto udepth = isVolumeMap(header) ? std::max(1u, header.depth) : 1u;
     const auto ulayers = std::max(1u, header10.arraySize);
     const auto ulevels = std::max(1u, header.mipMapCount);
-    const auto cubeMap = isCubeMap(header);
-    const auto faces = cubeMap ? 6 : 1;
 
-    const auto textureFormat = getFormat(header, header10);
-    if (textureFormat == TextureFormat::Invalid)
+    return {textureFormat,
+            {int(header.width), int(header.height), int(udepth)},
+            {Texture::IsCubemap(isCubeMap(header)), int(ulevels), int(ulayers)}};
+}
+
+} // namespace
+
+bool DDSHandler::read(Texture &texture)
+{
+    return readPartial(texture, TextureReadOptions());
+}
+
+bool DDSHandler::readPartial(Texture &texture, const TextureReadOptions &options)
+{
+    DDSHeader header;
+    DDSHeaderDX10 header10;
+    if (!readHeader(device(), header, header10))
         return false;
 
-    auto result = Texture(
-                textureFormat,
-                {int(header.width), int(header.height), int(udepth)},
-                {Texture::IsCubemap(cubeMap), int(ulevels), int(ulayers)});
+    const auto info = getInfo(header, header10);
+    if (info.isNull())
+        return false;
 
-    if (result.isNull()) {
-        qCWarning(ddshandler) << "Can't create texture";
+    const auto resultInfo = options.resultInfo(info);
+    if (resultInfo.isNull())
         return false;
+
+    const auto textureFormat = info.format();
+    const auto cubeMap = info.isCubemap();
+
+    // images are stored layer by layer and face by face, which matches the layout of Texture
+    // when there is a single level or a single image per level
+    const auto hasAllFaces = !cubeMap || std::all_of(
+            std::begin(faceFlags), std::end(faceFlags),
+            [&header](DDSCaps2Flag flag) { return header.caps2.testFlag(flag); });
+    const auto isContiguous = info.levels() == 1 || info.faces() * info.layers() == 1;
+    if (options.readsAll()
+            && hasAllFaces
+            && isContiguous
+            && mapTexture(texture, info, Texture::Alignment::Byte)) {
+        return true;
     }
 
+    if (!prepareTexture(texture, resultInfo, Texture::Alignment::Byte))
+        return false;
+
     const auto pitch = Texture::calculateBytesPerLine(textureFormat, int(header.width));
 
     if (header.pitchOrLinearSize && pitch != header.pitchOrLinearSize) {
@@ -521,28 +560,49 @@ bool DDSHandler::read(Texture &texture)
                             << pitch << "!=" << header.pitchOrLinearSize;
     }
 
-    for (int layer = 0; layer < int(ulayers); ++layer) {
-        for (int face = 0; face < faces; ++face) {
+    // layers are stored one after another, so the rest of the file is not needed
+    const auto layers = options.firstLayer() + resultInfo.layers();
+    for (int layer = 0; layer < layers; ++layer) {
+        for (int face = 0; face < info.faces(); ++face) {
             if (cubeMap && !(header.caps2 & gsl::at(faceFlags, face))) {
                 continue;
             }
 
-            for (int level = 0; level < int(ulevels); ++level) {
-                const auto data = result.imageData({Texture::Side(face), level, layer});
-                const auto read = device()->read(reinterpret_cast<char *>(data.data()), data.size());
-                if (read != data.size()) {
-                    qCWarning(ddshandler) << "Can't read from file:" << device()->errorString();
+            for (int level = 0; level < info.levels(); ++level) {
+                const Texture::ArrayIndex index(Texture::Side(face), level, layer);
+                if (!options.contains(info, index)) {
+                    if (!skip(info.bytesPerImage(level))) {
+                        if (!isCanceled())
+                            qCWarning(ddshandler) << "Can't skip image:" << device()->errorString();
+                        return false;
+                    }
+                    continue;
+                }
+
+                const auto data = texture.imageData(options.mapped(info, index));
+                if (!readData(reinterpret_cast<char *>(data.data()), data.size())) {
+                    if (!isCanceled())
+                        qCWarning(ddshandler) << "Can't read from file:" << device()->errorString();
                     return false;
                 }
             }
         }
     }
 
-    texture = std::move(result);
-
     return true;
 }
 
+bool DDSHandler::readInfo(TextureInfo &info)
+{
+    DDSHeader header;
+    DDSHeaderDX10 header10;
+    if (!readHeader(device(), header, header10))
+        return false;
+
+    info = getInfo(header, header10);
+    return !info.isNull();
+}
+
 bool DDSHandler::write(const Texture &texture)
 {
     if (texture.layers() > 1) {
@@ -560,9 +620,8 @@ bool DDSHandler::write(const Texture &texture)
         return false;
     }
 
-    const auto copy = texture.convert(Texture::Alignment::Byte);
-
-    QDataStream s(device().get());
+    QByteArray headerData;
+    QDataStream s(&headerData, QIODevice::WriteOnly);
     s.setByteOrder(QDataStream::LittleEndian);
 
     DDSHeader dds;
@@ -570,12 +629,12 @@ bool DDSHandler::write(const Texture &texture)
     // Filling header
     dds.flags = DDSFlag::Caps | DDSFlag::Height |
                 DDSFlag::Width | DDSFlag::PixelFormat;
-    dds.height = quint32(copy.height());
-    dds.width = quint32(copy.width());
+    dds.height = quint32(texture.height());
+    dds.width = quint32(texture.width());
     dds.depth = 0;
-    dds.mipMapCount = quint32(copy.levels() > 1 ? copy.levels() : 0);
+    dds.mipMapCount = quint32(texture.levels() > 1 ? texture.levels() : 0);
     dds.caps = DDSCapsFlag::Texture;
-    if (copy.levels() > 1)
+    if (texture.levels() > 1)
         dds.caps |= DDSCapsFlag::Mipmap;
 
     // TODO (abbapoh): Invert priority to almost always write DX10 files
@@ -604,26 +663,34 @@ bool DDSHandler::write(const Texture &texture)
     }
 
     dds.pitchOrLinearSize =
-            quint32(Texture::calculateBytesPerLine(copy.format(), copy.width()));
+            quint32(Texture::calculateBytesPerLine(texture.format(), texture.width()));
 
     s << dds;
 
     if (isDX10(dds))
         s << dds10;
 
-    for (int layer = 0; layer < copy.layers(); ++layer) {
-        for (int face = 0; face < copy.faces(); ++face) {
-            for (int level = 0; level < copy.levels(); ++level) {
-                const auto data = copy.imageData({Texture::Side(face), level, layer});
-                const auto writen = device()->write(reinterpret_cast<const char *>(data.data()), data.size());
-                if (writen != data.size()) {
-                    qCWarning(ddshandler) << "Can't write to device:" << device()->errorString();
-                    return false;
-                }
+    // the header and all images are submitted at once, so small levels don't cost a write each
+    std::vector<Texture::ConstData> chunks;
+    chunks.emplace_back(reinterpret_cast<const uchar *>(headerData.constData()), headerData.size());
+    for (int layer = 0; layer < texture.layers(); ++layer) {
+        for (int face = 0; face < texture.faces(); ++face) {
+            for (int level = 0; level < texture.levels(); ++level) {
+                // DDS lines are not padded, so padded lines are written one by one
+                const auto span = texture.constImageSpan({Texture::Side(face), level, layer});
+                if (span.bytesPerLine() == span.lineSize())
+                    chunks.push_back(span.bytesSpan());
+                else
+                    std::copy(span.begin(), span.end(), std::back_inserter(chunks));
             }
         }
     }
 
+    if (!writeData(chunks)) {
+        qCWarning(ddshandler) << "Can't write to device:" << device()->errorString();
+        return false;
+    }
+
     return true;
 }
 
@@ -63,6 +63,9 @@ public:
 
 public: // ImageIOHandler interface
     bool read(Texture &texture) override;
+    bool readInfo(TextureInfo &info) override;
+    bool readPartial(Texture &texture, const TextureReadOptions &options) override;
+    bool supportsPartialRead() const noexcept override { return true; }
     bool write(const Texture &texture) override;
 
 public:
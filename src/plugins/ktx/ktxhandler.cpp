@@ -3,6 +3,8 @@
 
 #include <TextureLib/Texture>
 #include <TextureLib/TextureFormatInfo>
+#include <TextureLib/TextureInfo>
+#include <TextureLib/TextureReadOptions>
 
 namespace {
 
@@ -91,13 +93,8 @@ bool verifyHeader(const KtxHeader &header)
     return true;
 }
 
-} // namespace
-
-bool KtxHandler::read(Texture& texture)
+bool readHeader(QDataStream &s, KtxHeader &header)
 {
-    KtxHeader header = {};
-
-    QDataStream s(device().get());
     s >> header;
 
     qCDebug(ktxhandler) << "header:" << header;
@@ -107,14 +104,11 @@ bool KtxHandler::read(Texture& texture)
         return false;
     }
 
-    if (!verifyHeader(header))
-        return false;
-
-    if (!readPadding(device(), header.bytesOfKeyValueData))
-        return false;
-
-    readPadding(device(), 3 - ((device()->pos() + 3) % 4));
+    return verifyHeader(header);
+}
 
+TextureInfo getInfo(const KtxHeader &header)
+{
     TextureFormat textureFormat = TextureFormat::Invalid;
     if (header.glFormat == 0 && header.glType == 0) {
         textureFormat = TextureFormatInfo::findOGLFormat(
@@ -133,26 +127,55 @@ bool KtxHandler::read(Texture& texture)
 
     if (textureFormat == TextureFormat::Invalid) {
         qCWarning(ktxhandler) << "Can't find appropriate format";
-        return false;
+        return {};
     }
 
     const auto size = Texture::Size(
                 header.pixelWidth,
                 std::max<int>(1, header.pixelHeight),
                 std::max<int>(1, header.pixelDepth));
-    const auto faces = std::max<int>(1, header.numberOfFaces);
+    const auto isCubemap = header.numberOfFaces == 6;
     const auto levels = std::max<int>(1, header.numberOfMipmapLevels);
     const auto layers = std::max<int>(1, header.numberOfArrayElements);
 
-    auto result = Texture(
-                textureFormat,
-                size,
-                {levels, layers},
-                Texture::Alignment::Word);
-    if (result.isNull()) {
-        qCWarning(ktxhandler) << "Can't create texture";
+    return {textureFormat, size, {Texture::IsCubemap(isCubemap), levels, layers}};
+}
+
+} // namespace
+
+bool KtxHandler::read(Texture& texture)
+{
+    return readPartial(texture, TextureReadOptions());
+}
+
+bool KtxHandler::readPartial(Texture &texture, const TextureReadOptions &options)
+{
+    KtxHeader header = {};
+
+    QDataStream s(device().get());
+    if (!readHeader(s, header))
+        return false;
+
+    const auto info = getInfo(header);
+    if (info.isNull())
+        return false;
+
+    if (!readPadding(device(), header.bytesOfKeyValueData))
+        return false;
+
+    readPadding(device(), 3 - ((device()->pos() + 3) % 4));
+
+    const auto resultInfo = options.resultInfo(info);
+    if (resultInfo.isNull())
+        return false;
+
+    const auto faces = info.faces();
+    const auto layers = info.layers();
+    // levels are stored one after another, so the rest of the file is not needed
+    const auto levels = options.firstLevel() + resultInfo.levels();
+
+    if (!prepareTexture(texture, resultInfo, Texture::Alignment::Word))
         return false;
-    }
 
     for (int level = 0; level < levels; ++level) {
         quint32 imageSize = 0;
@@ -164,11 +187,22 @@ bool KtxHandler::read(Texture& texture)
 
         for (int layer = 0; layer < layers; ++layer) {
             for (int face = 0; face < faces; ++face) {
-                const auto data = result.imageData({Texture::Side(face), level, layer});
-                const auto read = device()->read(reinterpret_cast<char *>(data.data()), data.size());
-                if (read != data.size()) {
-                    qCWarning(ktxhandler) << "Can't read from device:"
-                                          << device()->errorString();
+                const Texture::ArrayIndex index(Texture::Side(face), level, layer);
+                if (!options.contains(info, index)) {
+                    if (!skip(info.bytesPerImage(level, Texture::Alignment::Word))) {
+                        if (!isCanceled())
+                            qCWarning(ktxhandler) << "Can't skip image:" << device()->errorString();
+                        return false;
+                    }
+                    readPadding(device(), 3 - ((device()->pos() + 3) % 4));
+                    continue;
+                }
+
+                const auto data = texture.imageData(options.mapped(info, index));
+                if (!readData(reinterpret_cast<char *>(data.data()), data.size())) {
+                    if (!isCanceled())
+                        qCWarning(ktxhandler) << "Can't read from device:"
+                                              << device()->errorString();
                     return false;
                 }
                 readPadding(device(), 3 - ((device()->pos() + 3) % 4));
@@ -177,9 +211,19 @@ bool KtxHandler::read(Texture& texture)
         readPadding(device(), 3 - ((device()->pos() + 3) % 4));
     }
 
-    texture = std::move(result);
-
     return true;
 }
 
+bool KtxHandler::readInfo(TextureInfo &info)
+{
+    KtxHeader header = {};
+
+    QDataStream s(device().get());
+    if (!readHeader(s, header))
+        return false;
+
+    info = getInfo(header);
+    return !info.isNull();
+}
+
 Q_LOGGING_CATEGORY(ktxhandler, "plugins.textureformats.ktxhandler")
@@ -11,6 +11,10 @@ public:
     KtxHandler() = default;
 
     bool read(Texture &texture) override;
+    bool readInfo(TextureInfo &info) override;
+    bool readPartial(Texture &texture, const TextureReadOptions &options) override;
+    bool supportsPartialRead() const noexcept override { return true; }
+    Texture::Alignment alignment() const noexcept override { return Texture::Alignment::Word; }
 };
 
 Q_DECLARE_LOGGING_CATEGORY(ktxhandler)
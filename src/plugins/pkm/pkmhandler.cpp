@@ -1,6 +1,7 @@
 #include "pkmhandler.h"
 
 #include <TextureLib/Texture>
+#include <TextureLib/TextureInfo>
 
 #include <OptionalType>
 
@@ -175,14 +176,10 @@ bool verifyTexture(const Texture &texture)
     return true;
 }
 
-} // namespace
-
-bool PkmHandler::read(Texture& texture)
+bool readHeader(PkmHandler::QIODevicePointer device, PkmHeader &header)
 {
-    PkmHeader header;
-
     {
-        QDataStream s(device().get());
+        QDataStream s(device.get());
         s.setByteOrder(QDataStream::BigEndian);
         s >> header;
 
@@ -194,34 +191,59 @@ bool PkmHandler::read(Texture& texture)
         }
     }
 
-    if (!verifyHeader(header))
-        return false;
+    return verifyHeader(header);
+}
 
+TextureInfo getInfo(const PkmHeader &header)
+{
     const auto format = getFormat(header);
 
     if (format == TextureFormat::Invalid) {
         qCWarning(pkmhandler) << "Unsupported format" << header.textureType;
-        return false;
+        return {};
     }
 
-    auto result = Texture(format, {header.width, header.height});
-    if (result.isNull()) {
-        qCWarning(pkmhandler) << "Can't create texture";
+    return {format, {header.width, header.height}};
+}
+
+} // namespace
+
+bool PkmHandler::read(Texture& texture)
+{
+    PkmHeader header;
+    if (!readHeader(device(), header))
         return false;
-    }
 
-    const auto data = result.imageData({});
-    const auto read = device()->read(reinterpret_cast<char *>(data.data()), data.size());
-    if (read != data.size()) {
-        qCWarning(pkmhandler) << "Can't read from device:" << device()->errorString();
+    const auto info = getInfo(header);
+    if (info.isNull())
+        return false;
+
+    if (mapTexture(texture, info, Texture::Alignment::Byte))
+        return true;
+
+    if (!prepareTexture(texture, info, Texture::Alignment::Byte))
         return false;
-    }
 
-    texture = std::move(result);
+    const auto data = texture.imageData({});
+    if (!readData(reinterpret_cast<char *>(data.data()), data.size())) {
+        if (!isCanceled())
+            qCWarning(pkmhandler) << "Can't read from device:" << device()->errorString();
+        return false;
+    }
 
     return true;
 }
 
+bool PkmHandler::readInfo(TextureInfo &info)
+{
+    PkmHeader header;
+    if (!readHeader(device(), header))
+        return false;
+
+    info = getInfo(header);
+    return !info.isNull();
+}
+
 bool PkmHandler::write(const Texture& texture)
 {
     if (!verifyTexture(texture))
@@ -240,8 +262,9 @@ bool PkmHandler::write(const Texture& texture)
     header.paddedWidth = header.width;
     header.paddedHeight = header.height;
 
+    QByteArray headerData;
     {
-        QDataStream s(device().get());
+        QDataStream s(&headerData, QIODevice::WriteOnly);
         s.setByteOrder(QDataStream::BigEndian);
         s << header;
 
@@ -251,9 +274,11 @@ bool PkmHandler::write(const Texture& texture)
         }
     }
 
-    const auto data = texture.imageData({});
-    const auto read = device()->write(reinterpret_cast<const char *>(data.data()), data.size());
-    if (read != data.size()) {
+    const Texture::ConstData chunks[] = {
+        {reinterpret_cast<const uchar *>(headerData.constData()), headerData.size()},
+        texture.constImageData({})
+    };
+    if (!writeData(chunks)) {
         qCWarning(pkmhandler) << "Can't write to device:" << device()->errorString();
         return false;
     }
@@ -15,6 +15,7 @@ public:
 
 public: // ImageIOHandler interface
     bool read(Texture &texture) override;
+    bool readInfo(TextureInfo &info) override;
     bool write(const Texture &texture) override;
 };
 
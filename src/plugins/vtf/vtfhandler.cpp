@@ -2,6 +2,8 @@
 #include "vtfenums.h"
 
 #include <TextureLib/Texture>
+#include <TextureLib/TextureInfo>
+#include <TextureLib/TextureReadOptions>
 
 #include <QtCore/QDataStream>
 
@@ -114,62 +116,24 @@ static TextureFormat convertFormat(VTFImageFormat format)
     }
 }
 
-static bool readTexture(
-        VTFHandler::QIODevicePointer device,
-        const VTFHeader &header,
-        Texture &texture)
+static TextureInfo getInfo(const VTFHeader &header)
 {
     const auto highFormat = vtfFormat(header.highResImageFormat);
     const auto format = convertFormat(highFormat);
     if (format == TextureFormat::Invalid) {
         qCWarning(vtfhandler) << "format" << header.highResImageFormat << "is not supported";
-        return false;
+        return {};
     }
 
     const auto isCubemap = bool(header.flags & VTFFlag::EnvironmentMap);
     const auto depth = std::max<quint16>(1, header.depth);
-    auto result = Texture(
-                format,
-                {header.width, header.height, depth},
-                {Texture::IsCubemap(isCubemap), header.mipmapCount, header.frames});
-    if (result.isNull()) {
-        qCWarning(vtfhandler) << "Can't create resulting texture, file is too big or corrupted";
-        return false;
-    }
-
-    const Texture::Side sides[] = {
-        Texture::Side::PositiveZ,
-        Texture::Side::NegativeZ,
-        Texture::Side::PositiveX,
-        Texture::Side::NegativeX,
-        Texture::Side::PositiveY,
-        Texture::Side::NegativeY
-    };
-
-    for (int level = header.mipmapCount - 1; level >= 0; --level) {
-        for (int layer = 0; layer < header.frames; ++layer) {
-            for (int face = 0; face < (isCubemap ? 6 : 1); ++face) {
-                const auto side = isCubemap ? gsl::at(sides, face) : Texture::Side::PositiveX;
-                const auto data = result.imageData({side, level, layer});
-                const auto read = device->read(reinterpret_cast<char *>(data.data()), data.size());
-                if (read != data.size()) {
-                    qCWarning(vtfhandler) << "Can't read from device:"
-                                          << device->errorString();
-                    return false;
-                }
-            }
-        }
-    }
-
-    texture = std::move(result);
-    return true;
+    return {format,
+            {header.width, header.height, depth},
+            {Texture::IsCubemap(isCubemap), header.mipmapCount, header.frames}};
 }
 
-bool VTFHandler::read(Texture &texture)
+static bool readHeader(QDataStream &s, VTFHeader &header)
 {
-    VTFHeader header;
-
-    QDataStream s(device().get());
     s >> header;
 
     qCDebug(vtfhandler) << "header:" << header;
@@ -179,7 +143,20 @@ bool VTFHandler::read(Texture &texture)
         return false;
     }
 
-    if (!validateHeader(header))
+    return validateHeader(header);
+}
+
+bool VTFHandler::read(Texture &texture)
+{
+    return readPartial(texture, TextureReadOptions());
+}
+
+bool VTFHandler::readPartial(Texture &texture, const TextureReadOptions &options)
+{
+    VTFHeader header;
+
+    QDataStream s(device().get());
+    if (!readHeader(s, header))
         return false;
 
     // read padding after header before resources entries
@@ -193,7 +170,7 @@ bool VTFHandler::read(Texture &texture)
             const auto lowSize = header.lowResImageHeight * header.lowResImageHeight / 2;
             if (!readPadding(device(), lowSize))
                 return false;
-            return readTexture(device(), header, texture);
+            return readTexture(header, options, texture);
         }
 
         if (header.version[1] == 3
@@ -219,7 +196,7 @@ bool VTFHandler::read(Texture &texture)
                 if (entry.type == quint32(VTFResourceType::LegacyImage)) {
                     if (!readPadding(device(), entry.data - device()->pos()))
                         return false;
-                    return readTexture(device(), header, texture);
+                    return readTexture(header, options, texture);
                 }
             }
 
@@ -234,4 +211,88 @@ bool VTFHandler::read(Texture &texture)
     return false;
 }
 
+bool VTFHandler::readInfo(TextureInfo &info)
+{
+    VTFHeader header;
+
+    QDataStream s(device().get());
+    if (!readHeader(s, header))
+        return false;
+
+    // versions 7.0 - 7.5 are read by read()
+    if (header.version[0] != 7 || header.version[1] > 5) {
+        qCWarning(vtfhandler) << "Unsupported version"
+                              << QString("%1.%2").arg(header.version[0]).arg(header.version[1]);
+        return false;
+    }
+
+    info = getInfo(header);
+    return !info.isNull();
+}
+
+bool VTFHandler::readTexture(
+        const VTFHeader &header,
+        const TextureReadOptions &options,
+        Texture &texture)
+{
+    const auto info = getInfo(header);
+    if (info.isNull())
+        return false;
+
+    const auto resultInfo = options.resultInfo(info);
+    if (resultInfo.isNull())
+        return false;
+
+    const auto isCubemap = info.isCubemap();
+
+    // faces are stored in a different order and levels from the smallest one, so only
+    // single-level textures without faces have the layout of Texture
+    if (options.readsAll()
+            && info.levels() == 1
+            && !isCubemap
+            && mapTexture(texture, info, Texture::Alignment::Byte)) {
+        return true;
+    }
+
+    if (!prepareTexture(texture, resultInfo, Texture::Alignment::Byte))
+        return false;
+
+    const Texture::Side sides[] = {
+        Texture::Side::PositiveZ,
+        Texture::Side::NegativeZ,
+        Texture::Side::PositiveX,
+        Texture::Side::NegativeX,
+        Texture::Side::PositiveY,
+        Texture::Side::NegativeY
+    };
+
+    // levels are stored from the smallest one, so larger levels than requested are not read
+    for (int level = header.mipmapCount - 1; level >= options.firstLevel(); --level) {
+        for (int layer = 0; layer < header.frames; ++layer) {
+            for (int face = 0; face < (isCubemap ? 6 : 1); ++face) {
+                const auto side = isCubemap ? gsl::at(sides, face) : Texture::Side::PositiveX;
+                const Texture::ArrayIndex index(side, level, layer);
+                if (!options.contains(info, index)) {
+                    if (!skip(info.bytesPerImage(level))) {
+                        if (!isCanceled())
+                            qCWarning(vtfhandler) << "Can't skip image:" << device()->errorString();
+                        return false;
+                    }
+                    continue;
+                }
+
+                const auto data = texture.imageData(options.mapped(info, index));
+                if (!readData(reinterpret_cast<char *>(data.data()), data.size())) {
+                    if (!isCanceled())
+                        qCWarning(vtfhandler) << "Can't read from device:"
+                                              << device()->errorString();
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
 Q_LOGGING_CATEGORY(vtfhandler, "plugins.textureformats.vtfhandler")
@@ -12,6 +12,12 @@ public:
 
 public: // ImageIOHandler interface
     bool read(Texture &texture) override;
+    bool readInfo(TextureInfo &info) override;
+    bool readPartial(Texture &texture, const TextureReadOptions &options) override;
+    bool supportsPartialRead() const noexcept override { return true; }
+
+private:
+    bool readTexture(const VTFHeader &header, const TextureReadOptions &options, Texture &texture);
 };
 
 Q_DECLARE_LOGGING_CATEGORY(vtfhandler)
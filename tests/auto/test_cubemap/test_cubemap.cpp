@@ -0,0 +1,186 @@
+#include <QtTest>
+#include <TextureLib/Cubemap>
+#include <TextureLib/Texture>
+
+class TestCubemap : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void fromEquirectangular();
+    void toEquirectangular();
+    void roundTrip();
+    void prefilterSpecular();
+    void irradiance();
+    void invalid();
+};
+
+static bool fuzzyCompare(const Rgba128Float &lhs, const Rgba128Float &rhs, float epsilon = 1e-3f)
+{
+    return std::abs(lhs.red() - rhs.red()) < epsilon
+            && std::abs(lhs.green() - rhs.green()) < epsilon
+            && std::abs(lhs.blue() - rhs.blue()) < epsilon
+            && std::abs(lhs.alpha() - rhs.alpha()) < epsilon;
+}
+
+static Rgba128Float faceColor(Texture::size_type face)
+{
+    return rgba128Float(float(face), float(face % 2), 1.0f, 1.0f);
+}
+
+// each face has its own color
+static Texture makeCubemap(Texture::size_type size)
+{
+    Texture result(TextureFormat::RGBA32_Float, {size, size}, {Texture::IsCubemap::Yes, 1, 1});
+    for (int face = 0; face < 6; ++face)
+        result.fill({{}, {size, size}}, {Texture::Side(face)}, faceColor(face));
+    return result;
+}
+
+static Rgba128Float texel(const Texture &texture, Texture::Side side, int x, int y, int level = 0)
+{
+    return texture.texelColor({x, y}, {side, level}).convert<Rgba128Float>();
+}
+
+void TestCubemap::fromEquirectangular()
+{
+    // the upper half is red, the lower is blue
+    Texture panorama(TextureFormat::RGBA32_Float, {64, 32});
+    QVERIFY(!panorama.isNull());
+    panorama.fill({{0, 0}, {64, 16}}, {}, rgba128Float(1.0f, 0.0f, 0.0f, 1.0f));
+    panorama.fill({{0, 16}, {64, 16}}, {}, rgba128Float(0.0f, 0.0f, 1.0f, 1.0f));
+
+    const auto cubemap = Cubemap::fromEquirectangular(panorama, 8);
+    QVERIFY(!cubemap.isNull());
+    QCOMPARE(cubemap.format(), TextureFormat::RGBA16_Float);
+    QCOMPARE(cubemap.faces(), 6);
+    QCOMPARE(cubemap.width(), 8);
+
+    const auto red = rgba128Float(1.0f, 0.0f, 0.0f, 1.0f);
+    const auto blue = rgba128Float(0.0f, 0.0f, 1.0f, 1.0f);
+    for (int y = 0; y < 8; ++y) {
+        for (int x = 0; x < 8; ++x) {
+            QVERIFY(fuzzyCompare(texel(cubemap, Texture::Side::PositiveY, x, y), red));
+            QVERIFY(fuzzyCompare(texel(cubemap, Texture::Side::NegativeY, x, y), blue));
+        }
+    }
+    // side faces are split by the horizon
+    QVERIFY(fuzzyCompare(texel(cubemap, Texture::Side::PositiveX, 4, 0), red));
+    QVERIFY(fuzzyCompare(texel(cubemap, Texture::Side::PositiveZ, 4, 7), blue));
+}
+
+void TestCubemap::toEquirectangular()
+{
+    const auto cubemap = makeCubemap(8);
+    const auto panorama = Cubemap::toEquirectangular(cubemap, {64, 32}, TextureFormat::RGBA32_Float);
+    QVERIFY(!panorama.isNull());
+    QCOMPARE(panorama.format(), TextureFormat::RGBA32_Float);
+    QCOMPARE(panorama.faces(), 1);
+
+    const auto color = [&panorama](int x, int y)
+    { return panorama.texelColor({x, y}, {}).convert<Rgba128Float>(); };
+
+    // the center looks at -Z, a quarter to the right is +X
+    QVERIFY(fuzzyCompare(color(32, 16), faceColor(5)));
+    QVERIFY(fuzzyCompare(color(48, 16), faceColor(0)));
+    QVERIFY(fuzzyCompare(color(16, 16), faceColor(1)));
+    QVERIFY(fuzzyCompare(color(0, 16), faceColor(4)));
+    QVERIFY(fuzzyCompare(color(10, 0), faceColor(2)));
+    QVERIFY(fuzzyCompare(color(10, 31), faceColor(3)));
+}
+
+void TestCubemap::roundTrip()
+{
+    Texture panorama(TextureFormat::RGBA32_Float, {128, 64});
+    QVERIFY(!panorama.isNull());
+    for (int y = 0; y < 64; ++y) {
+        for (int x = 0; x < 128; ++x)
+            panorama.setTexelColor({x, y}, rgba128Float(y / 64.0f, 0.5f, 0.25f, 1.0f));
+    }
+
+    const auto cubemap = Cubemap::fromEquirectangular(panorama, 32, TextureFormat::RGBA32_Float);
+    const auto result = Cubemap::toEquirectangular(cubemap, {128, 64}, TextureFormat::RGBA32_Float);
+    QVERIFY(!result.isNull());
+    for (int y = 8; y < 56; y += 8) {
+        for (int x = 0; x < 128; x += 16) {
+            const auto expected = panorama.texelColor({x, y}, {}).convert<Rgba128Float>();
+            const auto actual = result.texelColor({x, y}, {}).convert<Rgba128Float>();
+            QVERIFY(fuzzyCompare(actual, expected, 0.03f));
+        }
+    }
+}
+
+void TestCubemap::prefilterSpecular()
+{
+    Texture constant(TextureFormat::RGBA32_Float, {16, 16}, {Texture::IsCubemap::Yes, 1, 1});
+    QVERIFY(!constant.isNull());
+    constant.fill(rgba128Float(0.5f, 1.0f, 2.0f, 1.0f));
+
+    const auto result = Cubemap::prefilterSpecular(constant, 32);
+    QVERIFY(!result.isNull());
+    QCOMPARE(result.format(), TextureFormat::RGBA16_Float);
+    QCOMPARE(result.faces(), 6);
+    QCOMPARE(result.levels(), 5);
+    for (int level = 0; level < result.levels(); ++level) {
+        QVERIFY(fuzzyCompare(
+                texel(result, Texture::Side::NegativeZ, 0, 0, level),
+                rgba128Float(0.5f, 1.0f, 2.0f, 1.0f), 3e-3f));
+    }
+
+    // the first level is the mirror reflection, the last one blends neighbour faces
+    const auto cubemap = makeCubemap(16);
+    const auto filtered = Cubemap::prefilterSpecular(cubemap, 64, TextureFormat::RGBA32_Float);
+    QVERIFY(fuzzyCompare(texel(filtered, Texture::Side::NegativeX, 8, 8), faceColor(1)));
+    const auto rough = texel(filtered, Texture::Side::NegativeX, 0, 0, 4);
+    QVERIFY(rough.red() > 1.2f);
+    QVERIFY(rough.red() < 4.0f);
+}
+
+void TestCubemap::irradiance()
+{
+    Texture sky(TextureFormat::RGBA32_Float, {16, 16}, {Texture::IsCubemap::Yes, 1, 1});
+    QVERIFY(!sky.isNull());
+    sky.fill(rgba128Float(0.0f, 0.0f, 0.0f, 1.0f));
+    sky.fill({{}, {16, 16}}, {Texture::Side::PositiveY}, rgba128Float(1.0f, 1.0f, 1.0f, 1.0f));
+
+    const auto result = Cubemap::irradiance(sky, 4, 256, TextureFormat::RGBA32_Float);
+    QVERIFY(!result.isNull());
+    QCOMPARE(result.width(), 4);
+    QCOMPARE(result.levels(), 1);
+
+    const auto up = texel(result, Texture::Side::PositiveY, 2, 2).red();
+    const auto side = texel(result, Texture::Side::PositiveX, 2, 2).red();
+    const auto down = texel(result, Texture::Side::NegativeY, 2, 2).red();
+    QVERIFY(up > side);
+    QVERIFY(side > down);
+    QVERIFY(down < 0.01f);
+    // the +Y face covers about 0.5 of the cosine-weighted hemisphere above
+    QVERIFY(qAbs(up - 0.5f) < 0.1f);
+}
+
+void TestCubemap::invalid()
+{
+    Texture flat(TextureFormat::RGBA8_Unorm, {4, 4});
+    QVERIFY(!flat.isNull());
+
+    QTest::ignoreMessage(QtWarningMsg, "prefilterSpecular() requires a cubemap texture");
+    QVERIFY(Cubemap::prefilterSpecular(flat).isNull());
+    QTest::ignoreMessage(QtWarningMsg, "irradiance() requires a cubemap texture");
+    QVERIFY(Cubemap::irradiance(flat).isNull());
+    QTest::ignoreMessage(QtWarningMsg, "toEquirectangular() requires a cubemap texture");
+    QVERIFY(Cubemap::toEquirectangular(flat, {8, 4}).isNull());
+
+    QTest::ignoreMessage(QtWarningMsg, "fromEquirectangular() was called with invalid parameters");
+    QVERIFY(Cubemap::fromEquirectangular(flat, 0).isNull());
+
+    QTest::ignoreMessage(
+            QtWarningMsg,
+            QRegularExpression("fromEquirectangular\\(\\) is not supported for format .*"));
+    QVERIFY(Cubemap::fromEquirectangular(flat, 4, TextureFormat::Bc1Rgb_Unorm).isNull());
+
+    QVERIFY(Cubemap::irradiance(Texture()).isNull());
+}
+
+QTEST_APPLESS_MAIN(TestCubemap)
+
+#include "test_cubemap.moc"
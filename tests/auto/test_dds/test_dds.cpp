@@ -59,6 +59,27 @@ static bool verifyTexture(const Texture &texture, const QImage &second)
     return memcmp(texture.data().data(), image.bits(), image.sizeInBytes()) == 0;
 }
 
+// counts calls that reach the device
+class CountingBuffer: public QBuffer
+{
+public:
+    int writes {0};
+
+protected:
+    qint64 writeData(const char *data, qint64 size) override
+    {
+        ++writes;
+        return QBuffer::writeData(data, size);
+    }
+};
+
+// a buffer that can't seek, like a pipe or a socket
+class SequentialBuffer: public QBuffer
+{
+public:
+    bool isSequential() const override { return true; }
+};
+
 class TestDds: public QObject
 {
     Q_OBJECT
@@ -67,6 +88,20 @@ private slots:
     void initTestCase();
     void testRead_data();
     void testRead();
+    void readInfo_data();
+    void readInfo();
+    void readPartial_data();
+    void readPartial();
+    void cancel();
+    void progress();
+    void readMany();
+    void readManySequential();
+    void detectFormat();
+    void readInto();
+    void readData();
+    void readUnalignedData();
+    void write();
+    void writePadded();
     void benchRead_data();
     void benchRead();
 };
@@ -104,6 +139,317 @@ void TestDds::testRead()
     QVERIFY(verifyTexture(*result, QImage(sourcePath)));
 }
 
+void TestDds::readInfo_data()
+{
+    benchRead_data();
+}
+
+void TestDds::readInfo()
+{
+    QFETCH(QString, fileName);
+
+    TextureIO reader(fileName, QStringLiteral("image/x-dds"));
+    const auto info = reader.readInfo();
+    QVERIFY2(info, qPrintable(toUserString(info.error())));
+    QVERIFY(!info->isNull());
+
+    // readInfo() doesn't move the device, so the texture can be read by the same reader
+    const auto result = reader.read();
+    QVERIFY2(result, qPrintable(toUserString(result.error())));
+    QVERIFY(*info == TextureInfo(*result));
+}
+
+void TestDds::readPartial_data()
+{
+    benchRead_data();
+}
+
+void TestDds::readPartial()
+{
+    QFETCH(QString, fileName);
+
+    const auto expected = TextureIO(fileName, QStringLiteral("image/x-dds")).read();
+    QVERIFY2(expected, qPrintable(toUserString(expected.error())));
+
+    // only the smallest level of the last layer is read
+    const auto level = expected->levels() - 1;
+    const auto layer = expected->layers() - 1;
+    TextureReadOptions options;
+    options.setLevels(level, 1);
+    options.setLayers(layer);
+
+    const auto result = TextureIO(fileName, QStringLiteral("image/x-dds")).read(options);
+    QVERIFY2(result, qPrintable(toUserString(result.error())));
+    QCOMPARE(result->format(), expected->format());
+    QCOMPARE(result->width(), expected->width(level));
+    QCOMPARE(result->height(), expected->height(level));
+    QCOMPARE(result->levels(), 1);
+    QCOMPARE(result->layers(), 1);
+    QCOMPARE(result->faces(), expected->faces());
+    for (int face = 0; face < result->faces(); ++face) {
+        const auto side = Texture::Side(face);
+        const auto data = result->imageData({side, 0, 0});
+        const auto expectedData = expected->imageData({side, level, layer});
+        QCOMPARE(data.size(), expectedData.size());
+        QVERIFY(std::equal(data.begin(), data.end(), expectedData.begin()));
+    }
+}
+
+void TestDds::cancel()
+{
+    const auto canceled = std::make_shared<std::atomic_bool>(true);
+    TextureIO reader(QStringLiteral(":/dds/RGBA8_Unorm.dds"), QStringLiteral("image/x-dds"));
+    reader.setCancelToken(canceled);
+    const auto result = reader.read();
+    QVERIFY(!result);
+    QCOMPARE(result.error(), TextureIOError::Canceled);
+
+    *canceled = false;
+    QVERIFY(reader.read());
+}
+
+void TestDds::progress()
+{
+    qint64 bytesRead = 0;
+    qint64 bytesTotal = 0;
+    int calls = 0;
+    const auto callback = [&](qint64 read, qint64 total)
+    {
+        QVERIFY(read > bytesRead);
+        bytesRead = read;
+        bytesTotal = total;
+        ++calls;
+    };
+
+    TextureIO reader(QStringLiteral(":/dds/RGBA8_Unorm.dds"), QStringLiteral("image/x-dds"));
+    reader.setProgressCallback(callback);
+    const auto result = reader.read();
+    QVERIFY2(result, qPrintable(toUserString(result.error())));
+    QVERIFY(calls > 0);
+    QVERIFY(bytesTotal > 0);
+    QCOMPARE(bytesRead, bytesTotal);
+}
+
+void TestDds::readMany()
+{
+    const QStringList fileNames = {
+        QStringLiteral(":/dds/RGBA8_Unorm.dds"),
+        QStringLiteral(":/dds/L8_Unorm.dds"),
+        QStringLiteral(":/dds/missing.dds"),
+        QStringLiteral(":/dds/Bc1Rgb_Unorm.dds"),
+        QStringLiteral(":/dds/Bc3_Unorm.dds"),
+    };
+
+    TextureIO::ReadManyOptions options;
+    options.cpuThreads = 2;
+    options.ioThreads = 2;
+    const auto results = TextureIO::readMany(fileNames, options);
+    QCOMPARE(int(results.size()), fileNames.size());
+    for (int i = 0; i < fileNames.size(); ++i) {
+        const auto expected = TextureIO(fileNames.at(i)).read();
+        QCOMPARE(bool(results[size_t(i)]), bool(expected));
+        if (expected)
+            QCOMPARE(*results[size_t(i)], *expected);
+        else
+            QCOMPARE(results[size_t(i)].error(), expected.error());
+    }
+
+    // a budget smaller than any texture reads files one by one
+    options.memoryBudget = 1;
+    std::vector<int> delivered(size_t(fileNames.size()));
+    TextureIO::readMany(fileNames, [&delivered](qsizetype index, TextureIO::ReadResult result)
+    {
+        Q_UNUSED(result);
+        ++delivered[size_t(index)];
+    }, options);
+    QCOMPARE(delivered, std::vector<int>(size_t(fileNames.size()), 1));
+}
+
+void TestDds::readManySequential()
+{
+    const QStringList fileNames = {
+        QStringLiteral(":/dds/RGBA8_Unorm.dds"),
+        QStringLiteral(":/dds/Bc1Rgb_Unorm.dds"),
+    };
+
+    QBuffer buffer;
+    SequentialBuffer sequentialBuffer;
+    for (const auto device: std::initializer_list<QBuffer *>{&buffer, &sequentialBuffer}) {
+        QFile file(fileNames.at(device == &buffer ? 0 : 1));
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        device->setData(file.readAll());
+    }
+
+    // the sequential device is read without probing its header first
+    const std::vector<TextureIO::QIODevicePointer> devices = {
+        TextureIO::QIODevicePointer(&buffer),
+        TextureIO::QIODevicePointer(&sequentialBuffer),
+    };
+    TextureIO::ReadManyOptions options;
+    options.memoryBudget = 1;
+    const auto results = TextureIO::readMany(devices, options);
+    QCOMPARE(int(results.size()), fileNames.size());
+    for (int i = 0; i < fileNames.size(); ++i) {
+        const auto expected = TextureIO(fileNames.at(i)).read();
+        QVERIFY(expected);
+        QVERIFY2(results[size_t(i)], qPrintable(toUserString(results[size_t(i)].error())));
+        QCOMPARE(*results[size_t(i)], *expected);
+    }
+}
+
+void TestDds::detectFormat()
+{
+    QFile file(QStringLiteral(":/dds/RGBA8_Unorm.dds"));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QBuffer buffer;
+    buffer.setData(file.readAll());
+
+    // the format is detected by the signature, the mime type is not set
+    TextureIO reader{TextureIO::QIODevicePointer(&buffer)};
+    const auto result = reader.read();
+    QVERIFY2(result, qPrintable(toUserString(result.error())));
+    QCOMPARE(*result, *TextureIO(file.fileName()).read());
+}
+
+void TestDds::readInto()
+{
+    const auto fileName = QStringLiteral(":/dds/RGBA8_Unorm.dds");
+    const auto expected = TextureIO(fileName).read();
+    QVERIFY(expected);
+
+    auto texture = TextureIO(fileName).read();
+    QVERIFY(texture);
+    const auto bytes = texture->imageData({});
+    std::fill(bytes.begin(), bytes.end(), uchar(0));
+    const auto data = texture->constImageData({}).data();
+
+    // the storage is reused when the layout matches
+    auto result = TextureIO(fileName).readInto(*texture);
+    QVERIFY2(result, qPrintable(toUserString(result.error())));
+    QCOMPARE(texture->constImageData({}).data(), data);
+    QCOMPARE(*texture, *expected);
+
+    Texture other(texture->format(), {texture->width() / 2, texture->height() / 2});
+    result = TextureIO(fileName).readInto(other);
+    QVERIFY(!result);
+    QCOMPARE(result.error(), TextureIOError::TextureMismatch);
+
+    Texture wordAligned(
+            texture->format(), texture->size(), {1, 1}, Texture::Alignment::Word);
+    result = TextureIO(fileName).readInto(wordAligned);
+    QVERIFY(!result);
+    QCOMPARE(result.error(), TextureIOError::TextureMismatch);
+
+    // a null texture is allocated
+    Texture empty;
+    result = TextureIO(fileName).readInto(empty);
+    QVERIFY2(result, qPrintable(toUserString(result.error())));
+    QCOMPARE(empty, *expected);
+}
+
+void TestDds::readData()
+{
+    QFile file(QStringLiteral(":/dds/RGBA8_Unorm.dds"));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const auto bytes = file.readAll();
+    const auto expected = TextureIO(file.fileName()).read();
+    QVERIFY(expected);
+
+    Texture texture;
+    {
+        TextureIO io;
+        io.setData(bytes);
+        auto result = io.read();
+        QVERIFY2(result, qPrintable(toUserString(result.error())));
+        texture = std::move(*result);
+    }
+    QCOMPARE(texture, *expected);
+
+    // the texture references the memory and outlives the TextureIO
+    const auto data = reinterpret_cast<const char *>(texture.constData().data());
+    QVERIFY(data > bytes.constData() && data < bytes.constData() + bytes.size());
+
+    // the memory is copied on write
+    auto copy = texture;
+    const auto copyData = copy.imageData({});
+    std::fill(copyData.begin(), copyData.end(), uchar(0));
+    QCOMPARE(reinterpret_cast<const char *>(texture.constData().data()), data);
+    QCOMPARE(texture, *expected);
+}
+
+void TestDds::readUnalignedData()
+{
+    QFile file(QStringLiteral(":/dds/RGBA8_Unorm.dds"));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const auto bytes = file.readAll();
+    const auto expected = TextureIO(file.fileName()).read();
+    QVERIFY(expected);
+
+    // shift the file so texels are not aligned to 4 bytes
+    auto storage = std::make_shared<QByteArray>(bytes.size() + 2, '\0');
+    const auto offset = quintptr(storage->constData()) % 4 == 3 ? 2 : 1;
+    std::copy(bytes.begin(), bytes.end(), storage->begin() + offset);
+    const auto memory = Texture::ConstData(
+            reinterpret_cast<const uchar *>(storage->constData()) + offset, bytes.size());
+
+    TextureIO io;
+    io.setData(memory, storage);
+    const auto result = io.read();
+    QVERIFY2(result, qPrintable(toUserString(result.error())));
+    QCOMPARE(*result, *expected);
+
+    // the data is copied instead of being referenced
+    const auto data = result->constData().data();
+    QVERIFY(data < memory.data() || data >= memory.data() + memory.size());
+}
+
+void TestDds::write()
+{
+    const auto texture = TextureIO(QStringLiteral(":/dds/RGBA8_Unorm.dds")).read();
+    QVERIFY(texture);
+    QVERIFY(texture->levels() > 1);
+
+    CountingBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::ReadWrite));
+    const auto result = TextureIO(
+            TextureIO::QIODevicePointer(&buffer), QStringLiteral("image/x-dds")).write(*texture);
+    QVERIFY2(result, qPrintable(toUserString(result.error())));
+
+    // the header and all levels are gathered into a single write
+    QCOMPARE(buffer.writes, 1);
+
+    QVERIFY(buffer.seek(0));
+    const auto written = TextureIO(
+            TextureIO::QIODevicePointer(&buffer), QStringLiteral("image/x-dds")).read();
+    QVERIFY2(written, qPrintable(toUserString(written.error())));
+    QCOMPARE(*written, *texture);
+}
+
+void TestDds::writePadded()
+{
+    // lines of 5 BGR texels are padded to 16 bytes with the Word alignment
+    Texture texture(TextureFormat::BGR8_Unorm, {5, 3}, {1, 1}, Texture::Alignment::Word);
+    QVERIFY(!texture.isNull());
+    uchar value = 0;
+    for (const auto line: texture.imageSpan({})) {
+        for (auto &byte: line)
+            byte = value++;
+    }
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::ReadWrite));
+    const auto result = TextureIO(
+            TextureIO::QIODevicePointer(&buffer), QStringLiteral("image/x-dds")).write(texture);
+    QVERIFY2(result, qPrintable(toUserString(result.error())));
+    QCOMPARE(buffer.size(), qint64(128 + 5 * 3 * 3));
+
+    QVERIFY(buffer.seek(0));
+    const auto written = TextureIO(
+            TextureIO::QIODevicePointer(&buffer), QStringLiteral("image/x-dds")).read();
+    QVERIFY2(written, qPrintable(toUserString(written.error())));
+    QCOMPARE(*written, texture.convert(Texture::Alignment::Byte));
+}
+
 void TestDds::benchRead_data()
 {
     QTest::addColumn<QString>("fileName");
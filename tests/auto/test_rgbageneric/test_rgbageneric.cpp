@@ -53,11 +53,13 @@ void TestRgbaGeneric::testNormalize()
     QCOMPARE((Private::convertChannel<HalfFloat, float>(0.0f)), HalfFloat(0));
     QCOMPARE((Private::convertChannel<HalfFloat, float>(0.5f)), HalfFloat(0.5f));
     QCOMPARE((Private::convertChannel<HalfFloat, float>(1.0f)), HalfFloat(1.0f));
+    QCOMPARE((Private::convertChannel<HalfFloat, float>(16.0f)), HalfFloat(16.0f));
 
     // HalfFloat -> float
     QCOMPARE((Private::convertChannel<float, HalfFloat>(HalfFloat(0.0f))), 0.0f);
     QCOMPARE((Private::convertChannel<float, HalfFloat>(HalfFloat(0.5f))), 0.5f);
     QCOMPARE((Private::convertChannel<float, HalfFloat>(HalfFloat(1.0f))), 1.0f);
+    QCOMPARE((Private::convertChannel<float, HalfFloat>(HalfFloat(-4.0f))), -4.0f);
 
     // quint8 -> quint16
     QCOMPARE((Private::convertChannel<quint16, quint8>(0)), 0);
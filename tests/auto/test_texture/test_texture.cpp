@@ -1,5 +1,8 @@
 #include <QtTest>
 #include <TextureLib/Texture>
+#include <TextureLib/TextureComparison>
+
+#include <functional>
 
 class TestTexture : public QObject
 {
@@ -12,10 +15,50 @@ private slots:
     void construct();
     void constructWithData();
     void constructWithInvalidData();
+    void fromRawData();
     void bytesPerLine_data();
     void bytesPerLine();
     void bytesPerSlice_data();
     void bytesPerSlice();
+    void lineData();
+    void contentHash_data();
+    void contentHash();
+    void copyRegion();
+    void copyRegionConvert();
+    void copyRegionOverlap();
+    void fill();
+    void readWriteRow_data();
+    void readWriteRow();
+    void readWriteRegion();
+    void toImage();
+    void toImageSubresource();
+    void toImageShared();
+    void fromImage_data();
+    void fromImage();
+    void fromImageConverted();
+    void resized_data();
+    void resized();
+    void resizedBox();
+    void resizedLargeScale();
+    void resizedInvalid();
+    void generateMipmaps();
+    void generateMipmapsWrap();
+    void generateMipmapsSrgb();
+    void generateMipmapsAlphaCoverage();
+    void flipped_data();
+    void flipped();
+    void transposed_data();
+    void transposed();
+    void rotated();
+    void flippedCompressed_data();
+    void flippedCompressed();
+    void transformInvalid();
+    void swizzled_data();
+    void swizzled();
+    void premultiplied_data();
+    void premultiplied();
+    void colorOperationsInvalid();
+    void clear();
     void invalid();
 };
 
@@ -223,6 +266,33 @@ void TestTexture::constructWithInvalidData()
     QVERIFY(data);
 }
 
+void TestTexture::fromRawData()
+{
+    int width = 16;
+    int height = 16;
+    qsizetype size = width * height * 4;
+    std::unique_ptr<uchar[]> data(new uchar[size]);
+    std::fill_n(data.get(), size, uchar(0xff));
+    const uchar *constData = data.get();
+
+    bool deleted = false;
+    {
+        const auto deleter = [&deleted](uchar []) { deleted = true; };
+        auto texture = Texture::fromRawData(
+                {constData, size}, deleter, TextureFormat::RGBA8_Unorm, {width, height});
+        QVERIFY(!texture.isNull());
+        QCOMPARE(texture.constData().data(), constData);
+
+        // writing detaches from the read-only data
+        const auto imageData = texture.imageData({});
+        std::fill(imageData.begin(), imageData.end(), uchar(0));
+        QVERIFY(texture.constData().data() != constData);
+        QCOMPARE(data[0], uchar(0xff));
+    }
+
+    QVERIFY(deleted);
+}
+
 void TestTexture::bytesPerLine_data()
 {
     QTest::addColumn<TextureFormat>("format");
@@ -319,6 +389,926 @@ void TestTexture::bytesPerSlice()
     QCOMPARE(result4, bpl4);
 }
 
+void TestTexture::lineData()
+{
+    Texture texture(TextureFormat::RGB8_Unorm, {5, 3, 2}, {1, 1}, Texture::Alignment::Word);
+    QVERIFY(!texture.isNull());
+    QCOMPARE(texture.bytesPerLine(), qsizetype(16));
+
+    const auto line = texture.constLineData({0, 2, 1}, {});
+    QCOMPARE(line.size(), qsizetype(15));
+    QCOMPARE(line.data(), texture.constImageData({}).data() + texture.bytesPerSlice() + 2 * 16);
+
+    QTest::ignoreMessage(QtWarningMsg, "x should be 0");
+    QVERIFY(texture.constLineData({1, 0, 0}, {}).empty());
+
+    QTest::ignoreMessage(QtWarningMsg, "point ( 0 3 0 ) is out of bounds");
+    QVERIFY(texture.constLineData({0, 3, 0}, {}).empty());
+
+    Texture compressed(TextureFormat::Bc1Rgb_Unorm, {16, 16});
+    QVERIFY(!compressed.isNull());
+    const auto blocks = compressed.constLineData({0, 5, 0}, {});
+    QCOMPARE(blocks.size(), qsizetype(32));
+    QCOMPARE(blocks.data(), compressed.constImageData({}).data() + 32);
+}
+
+void TestTexture::contentHash_data()
+{
+    QTest::addColumn<int>("width");
+    QTest::addColumn<int>("height");
+
+    QTest::newRow("small") << 16 << 16;
+    QTest::newRow("multiple chunks") << 1024 << 1000;
+}
+
+void TestTexture::contentHash()
+{
+    QFETCH(int, width);
+    QFETCH(int, height);
+
+    QCOMPARE(Texture().contentHash(), quint64(0));
+
+    Texture texture(TextureFormat::RGBA8_Unorm, {width, height});
+    QVERIFY(!texture.isNull());
+    const auto data = texture.data();
+    std::fill(data.begin(), data.end(), uchar(0x7f));
+
+    const auto hash = texture.contentHash();
+    QVERIFY(hash != 0);
+    QCOMPARE(texture.contentHash(), hash);
+
+    const auto copy = texture.copy();
+    QCOMPARE(copy.contentHash(), hash);
+    QVERIFY(copy == texture);
+
+    auto other = texture.copy();
+    other.setTexelColor({width - 1, height - 1}, qRgba(0, 0, 0, 0));
+    QVERIFY(other.contentHash() != hash);
+    QVERIFY(other != texture);
+
+    other.setTexelColor({width - 1, height - 1}, qRgba(0x7f, 0x7f, 0x7f, 0x7f));
+    QCOMPARE(other.contentHash(), hash);
+    QVERIFY(other == texture);
+
+    Texture otherFormat(TextureFormat::BGRA8_Unorm, {width, height});
+    QVERIFY(!otherFormat.isNull());
+    const auto otherData = otherFormat.data();
+    std::fill(otherData.begin(), otherData.end(), uchar(0x7f));
+    QVERIFY(otherFormat.contentHash() != hash);
+}
+
+void TestTexture::copyRegion()
+{
+    Texture source(TextureFormat::RGBA8_Unorm, {8, 8});
+    QVERIFY(!source.isNull());
+    for (int y = 0; y < 8; ++y) {
+        for (int x = 0; x < 8; ++x)
+            source.setTexelColor({x, y}, qRgba(x, y, 0, 255));
+    }
+
+    Texture texture(TextureFormat::RGBA8_Unorm, {4, 4});
+    QVERIFY(!texture.isNull());
+    texture.clear();
+    QVERIFY(texture.copyRegion(source, {}, {{2, 3}, {3, 2}}, {}, {1, 1}));
+
+    for (int y = 0; y < 4; ++y) {
+        for (int x = 0; x < 4; ++x) {
+            const auto inside = x >= 1 && y >= 1 && y < 3;
+            const auto expected = inside ? qRgba(x + 1, y + 2, 0, 255) : qRgba(0, 0, 0, 0);
+            QCOMPARE(texture.texelColor({x, y}, {}).convert<QRgb>(), expected);
+        }
+    }
+
+    QTest::ignoreMessage(QtWarningMsg, "Destination region is out of bounds");
+    QVERIFY(!texture.copyRegion(source, {}, {{0, 0}, {4, 4}}, {}, {1, 1}));
+    QTest::ignoreMessage(QtWarningMsg, "Source region is out of bounds");
+    QVERIFY(!texture.copyRegion(source, {}, {{6, 6}, {4, 4}}, {}, {}));
+}
+
+void TestTexture::copyRegionConvert()
+{
+    Texture source(TextureFormat::RGBA8_Unorm, {4, 4});
+    QVERIFY(!source.isNull());
+    source.fill(qRgba(10, 20, 30, 40));
+
+    Texture texture(TextureFormat::BGRA8_Unorm, {4, 4});
+    QVERIFY(!texture.isNull());
+    QVERIFY(texture.copyRegion(source, {}, {{}, {4, 4}}, {}, {}));
+    QCOMPARE(texture.texelColor({3, 3}, {}).convert<QRgb>(), qRgba(10, 20, 30, 40));
+    QCOMPARE(texture.constData()[0], uchar(30));
+}
+
+void TestTexture::copyRegionOverlap()
+{
+    Texture texture(TextureFormat::RGBA8_Unorm, {8, 1});
+    QVERIFY(!texture.isNull());
+    for (int x = 0; x < 8; ++x)
+        texture.setTexelColor({x, 0}, qRgba(x, 0, 0, 255));
+
+    QVERIFY(texture.copyRegion(texture, {}, {{0, 0}, {6, 1}}, {}, {2, 0}));
+    for (int x = 0; x < 8; ++x)
+        QCOMPARE(texture.texelColor({x, 0}, {}).convert<QRgb>(), qRgba(x < 2 ? x : x - 2, 0, 0, 255));
+}
+
+void TestTexture::fill()
+{
+    Texture texture(TextureFormat::RGB8_Unorm, {5, 3, 2}, {1, 1}, Texture::Alignment::Word);
+    QVERIFY(!texture.isNull());
+    texture.clear();
+
+    texture.fill({{1, 1, 1}, {3, 2, 1}}, {}, qRgb(1, 2, 3));
+    for (int z = 0; z < 2; ++z) {
+        for (int y = 0; y < 3; ++y) {
+            for (int x = 0; x < 5; ++x) {
+                const auto inside = z == 1 && y >= 1 && x >= 1 && x < 4;
+                const auto expected = inside ? qRgb(1, 2, 3) : qRgb(0, 0, 0);
+                QCOMPARE(texture.texelColor({x, y, z}, {}).convert<QRgb>(), expected);
+            }
+        }
+    }
+    // padding bytes are not touched
+    QCOMPARE(texture.constData()[texture.bytesPerSlice() + 16 + 15], uchar(0));
+
+    texture.fill(qRgb(7, 7, 7));
+    const auto data = texture.constData();
+    QCOMPARE(std::count(data.begin(), data.end(), uchar(7)), qsizetype(5 * 3 * 2 * 3));
+}
+
+void TestTexture::readWriteRow_data()
+{
+    QTest::addColumn<TextureFormat>("format");
+
+    QTest::newRow("R8_Unorm") << TextureFormat::R8_Unorm;
+    QTest::newRow("RGB8_Unorm") << TextureFormat::RGB8_Unorm;
+    QTest::newRow("RGBA8_Unorm") << TextureFormat::RGBA8_Unorm;
+    QTest::newRow("BGRA8_Unorm") << TextureFormat::BGRA8_Unorm;
+    QTest::newRow("RGBA16_Unorm") << TextureFormat::RGBA16_Unorm;
+    QTest::newRow("RGBA16_Float") << TextureFormat::RGBA16_Float;
+    QTest::newRow("RGBA32_Float") << TextureFormat::RGBA32_Float;
+}
+
+void TestTexture::readWriteRow()
+{
+    QFETCH(TextureFormat, format);
+
+    Texture texture(format, {8, 2});
+    QVERIFY(!texture.isNull());
+    for (int x = 0; x < 8; ++x)
+        texture.setTexelColor({x, 1}, qRgba(x * 30, 255 - x * 30, x * 10, 255));
+
+    std::vector<Rgba128Float> colors(6);
+    QVERIFY(texture.readRow({2, 1}, {}, colors));
+    for (int i = 0; i < 6; ++i) {
+        const auto expected = texture.texelColor({i + 2, 1}, {}).convert<Rgba128Float>();
+        QCOMPARE(colors[size_t(i)], expected);
+    }
+
+    Texture copy(format, {8, 2});
+    QVERIFY(!copy.isNull());
+    copy.clear();
+    QVERIFY(copy.writeRow({2, 1}, {}, colors));
+    for (int x = 2; x < 8; ++x)
+        QCOMPARE(copy.texelColor({x, 1}, {}), texture.texelColor({x, 1}, {}));
+    const auto untouched = copy.constLineData({0, 1, 0}, {}).first(2 * copy.bytesPerTexel());
+    QVERIFY(std::all_of(untouched.begin(), untouched.end(), [](uchar value) { return value == 0; }));
+}
+
+void TestTexture::readWriteRegion()
+{
+    Texture texture(TextureFormat::RGBA8_Unorm, {4, 4, 2}, {1, 1}, Texture::Alignment::Word);
+    QVERIFY(!texture.isNull());
+    texture.clear();
+
+    const Texture::Region region({1, 1, 0}, {2, 3, 2});
+    std::vector<Rgba128Float> colors(2 * 3 * 2);
+    for (size_t i = 0; i < colors.size(); ++i)
+        colors[i] = rgba128Float(i / 255.0f, 0.0f, 0.0f, 1.0f);
+    QVERIFY(texture.writeRegion(region, {}, colors));
+
+    // colors are stored slice by slice, line by line
+    QCOMPARE(texture.texelColor({1, 1, 0}, {}).convert<QRgb>(), qRgba(0, 0, 0, 255));
+    QCOMPARE(texture.texelColor({2, 1, 0}, {}).convert<QRgb>(), qRgba(1, 0, 0, 255));
+    QCOMPARE(texture.texelColor({1, 2, 0}, {}).convert<QRgb>(), qRgba(2, 0, 0, 255));
+    QCOMPARE(texture.texelColor({2, 3, 1}, {}).convert<QRgb>(), qRgba(11, 0, 0, 255));
+    QCOMPARE(texture.texelColor({0, 1, 0}, {}).convert<QRgb>(), qRgba(0, 0, 0, 0));
+
+    std::vector<Rgba128Float> result(colors.size());
+    QVERIFY(texture.readRegion(region, {}, result));
+    for (size_t i = 0; i < colors.size(); ++i)
+        QCOMPARE(qRound(result[i].red() * 255), int(i));
+
+    QTest::ignoreMessage(QtWarningMsg, "buffer is too small: 11");
+    QVERIFY(!texture.readRegion(region, {}, gsl::make_span(result).first(11)));
+    QTest::ignoreMessage(QtWarningMsg, "Region is out of bounds");
+    QVERIFY(!texture.readRegion({{3, 3, 0}, {2, 1, 1}}, {}, result));
+
+    Texture compressed(TextureFormat::Bc1Rgb_Unorm, {4, 4});
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("readRegion\\(\\) is not supported for format .*"));
+    QVERIFY(!compressed.readRegion({{}, {4, 4}}, {}, result));
+}
+
+void TestTexture::toImage()
+{
+    Texture texture(TextureFormat::BGRA8_Unorm, {3, 2});
+    QVERIFY(!texture.isNull());
+    texture.fill(qRgba(10, 20, 30, 40));
+    texture.setTexelColor({2, 1}, qRgba(50, 60, 70, 80));
+
+    const auto image = texture.toImage();
+    QCOMPARE(image.format(), QImage::Format_RGBA8888);
+    QCOMPARE(image.size(), QSize(3, 2));
+    QCOMPARE(image.pixel(0, 0), qRgba(10, 20, 30, 40));
+    QCOMPARE(image.pixel(2, 1), qRgba(50, 60, 70, 80));
+
+    Texture cubemap(TextureFormat::RGBA8_Unorm, {2, 2}, {Texture::IsCubemap::Yes});
+    QTest::ignoreMessage(
+            QtWarningMsg, "Can't convert to QImage: cubemaps and volumemaps are not supported");
+    QVERIFY(cubemap.toImage().isNull());
+}
+
+void TestTexture::toImageSubresource()
+{
+    Texture cubemap(TextureFormat::RGB8_Unorm, {4, 4}, {Texture::IsCubemap::Yes, 3});
+    QVERIFY(!cubemap.isNull());
+    cubemap.fill({{}, {2, 2}}, {Texture::Side::NegativeY, 1}, qRgb(1, 2, 3));
+
+    const auto face = cubemap.toImage({Texture::Side::NegativeY, 1});
+    QCOMPARE(face.format(), QImage::Format_RGB888);
+    QCOMPARE(face.size(), QSize(2, 2));
+    QCOMPARE(face.pixel(1, 1), qRgb(1, 2, 3));
+
+    Texture volume(TextureFormat::RGBA8_Unorm, {4, 2, 3});
+    QVERIFY(!volume.isNull());
+    volume.fill({{0, 0, 2}, {4, 2, 1}}, {}, qRgba(4, 5, 6, 7));
+
+    const auto slice = volume.toImage({}, 2);
+    QCOMPARE(slice.size(), QSize(4, 2));
+    QCOMPARE(slice.pixel(3, 1), qRgba(4, 5, 6, 7));
+
+    QTest::ignoreMessage(QtWarningMsg, "Can't convert to QImage: slice 3 is out of bounds");
+    QVERIFY(volume.toImage({}, 3).isNull());
+}
+
+void TestTexture::toImageShared()
+{
+    Texture texture(TextureFormat::RGBA8_Unorm, {3, 2}, {1, 1}, Texture::Alignment::Word);
+    QVERIFY(!texture.isNull());
+    texture.fill(qRgba(1, 2, 3, 4));
+
+    auto image = texture.toImage();
+    QCOMPARE(image.format(), QImage::Format_RGBA8888);
+    QCOMPARE(image.constBits(), texture.constData().data());
+
+    // the image keeps the data alive
+    texture = Texture();
+    QCOMPARE(image.pixel(2, 1), qRgba(1, 2, 3, 4));
+
+    // unaligned lines can't be wrapped
+    Texture unaligned(TextureFormat::RGB8_Unorm, {3, 2});
+    QVERIFY(!unaligned.isNull());
+    const auto copy = unaligned.toImage();
+    QCOMPARE(copy.format(), QImage::Format_RGB888);
+    QVERIFY(copy.constBits() != unaligned.constData().data());
+}
+
+void TestTexture::fromImage_data()
+{
+    QTest::addColumn<int>("imageFormat");
+    QTest::addColumn<TextureFormat>("format");
+
+    QTest::newRow("Alpha8") << int(QImage::Format_Alpha8) << TextureFormat::A8_Unorm;
+    QTest::newRow("Grayscale8") << int(QImage::Format_Grayscale8) << TextureFormat::L8_Unorm;
+    QTest::newRow("RGB888") << int(QImage::Format_RGB888) << TextureFormat::RGB8_Unorm;
+    QTest::newRow("RGBA8888") << int(QImage::Format_RGBA8888) << TextureFormat::RGBA8_Unorm;
+    QTest::newRow("RGBX8888") << int(QImage::Format_RGBX8888) << TextureFormat::RGBX8_Unorm;
+    QTest::newRow("RGBA64") << int(QImage::Format_RGBA64) << TextureFormat::RGBA16_Unorm;
+}
+
+void TestTexture::fromImage()
+{
+    QFETCH(int, imageFormat);
+    QFETCH(TextureFormat, format);
+
+    QImage image(5, 3, QImage::Format(imageFormat));
+    QVERIFY(!image.isNull());
+    memset(image.bits(), 0x40, size_t(image.sizeInBytes()));
+
+    Texture texture(image);
+    QVERIFY(!texture.isNull());
+    QCOMPARE(texture.format(), format);
+    QCOMPARE(texture.width(), 5);
+    QCOMPARE(texture.height(), 3);
+    QCOMPARE(texture.bytesPerLine(), qsizetype(image.bytesPerLine()));
+    QCOMPARE(texture.constData().data(), image.constBits());
+
+    // writing to the texture doesn't modify the image
+    texture.data()[0] = 0x80;
+    QVERIFY(texture.constData().data() != image.constBits());
+    QCOMPARE(image.constBits()[0], uchar(0x40));
+    QCOMPARE(texture.constData()[1], uchar(0x40));
+}
+
+void TestTexture::fromImageConverted()
+{
+    QImage image(2, 2, QImage::Format_ARGB32);
+    QVERIFY(!image.isNull());
+    image.setPixel(1, 1, qRgba(10, 20, 30, 40));
+
+    Texture texture(image);
+    QVERIFY(!texture.isNull());
+    QCOMPARE(texture.format(), TextureFormat::RGBA8_Unorm);
+    QCOMPARE(texture.texelColor({1, 1}, {}).convert<QRgb>(), qRgba(10, 20, 30, 40));
+
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("unsupported image format .*"));
+    QVERIFY(Texture(QImage()).isNull());
+}
+
+void TestTexture::resized_data()
+{
+    readWriteRow_data();
+}
+
+void TestTexture::resized()
+{
+    QFETCH(TextureFormat, format);
+
+    Texture texture(format, {6, 4}, {Texture::IsCubemap::No, 3, 2});
+    QVERIFY(!texture.isNull());
+    texture.fill(qRgba(64, 128, 192, 255));
+    const auto expected = texture.texelColor({}, {}).convert<QRgb>();
+
+    for (const auto filter: {Texture::Filter::Box, Texture::Filter::Kaiser, Texture::Filter::Lanczos}) {
+        for (const auto size: {Texture::Size(3, 2), Texture::Size(13, 7)}) {
+            const auto result = texture.resized(size, filter);
+            QVERIFY(!result.isNull());
+            QCOMPARE(result.format(), format);
+            QCOMPARE(result.width(), size.width);
+            QCOMPARE(result.height(), size.height);
+            QCOMPARE(result.levels(), 1);
+            QCOMPARE(result.layers(), 2);
+            // float formats may differ in the last bits
+            QCOMPARE(result.texelColor({size.width - 1, size.height - 1}, {0, 1}).convert<QRgb>(),
+                     expected);
+        }
+    }
+}
+
+void TestTexture::resizedBox()
+{
+    Texture texture(TextureFormat::RGBA32_Float, {4, 2});
+    QVERIFY(!texture.isNull());
+    std::vector<Rgba128Float> colors(8);
+    for (size_t i = 0; i < colors.size(); ++i)
+        colors[i] = rgba128Float(float(i), 0.0f, 0.0f, 1.0f);
+    QVERIFY(texture.writeRegion({{}, {4, 2}}, {}, colors));
+
+    const auto red = [](const Texture &texture, Texture::Position p)
+    {
+        return texture.texelColor(p, {}).convert<Rgba128Float>().red();
+    };
+
+    const auto downscaled = texture.resized({2, 1});
+    QCOMPARE(red(downscaled, {0, 0}), 2.5f);
+    QCOMPARE(red(downscaled, {1, 0}), 4.5f);
+
+    const auto upscaled = texture.resized({8, 2});
+    for (int x = 0; x < 8; ++x)
+        QCOMPARE(red(upscaled, {x, 1}), float(4 + x / 2));
+}
+
+void TestTexture::resizedLargeScale()
+{
+    // 1-texel checkerboard averages to gray at any scale
+    Texture texture(TextureFormat::RGBA32_Float, {256, 128});
+    QVERIFY(!texture.isNull());
+    for (int y = 0; y < texture.height(); ++y) {
+        for (int x = 0; x < texture.width(); ++x) {
+            const auto value = float((x + y) % 2);
+            texture.setTexelColor({x, y}, rgba128Float(value, value, value, 1.0f));
+        }
+    }
+
+    for (const auto filter: {Texture::Filter::Box, Texture::Filter::Kaiser, Texture::Filter::Lanczos}) {
+        const auto result = texture.resized({5, 3}, filter);
+        QVERIFY(!result.isNull());
+        for (int y = 0; y < 3; ++y) {
+            for (int x = 0; x < 5; ++x) {
+                const auto color = result.texelColor({x, y}, {}).convert<Rgba128Float>();
+                QVERIFY(qAbs(color.red() - 0.5f) < 0.02f);
+                QVERIFY(qAbs(color.alpha() - 1.0f) < 1e-5f);
+            }
+        }
+    }
+}
+
+void TestTexture::resizedInvalid()
+{
+    QVERIFY(Texture().resized({2, 2}).isNull());
+
+    Texture texture(TextureFormat::RGBA8_Unorm, {4, 4});
+    QTest::ignoreMessage(QtWarningMsg, "resized() was called with an invalid size");
+    QVERIFY(texture.resized({0, 2}).isNull());
+
+    Texture compressed(TextureFormat::Bc1Rgb_Unorm, {4, 4});
+    QTest::ignoreMessage(
+            QtWarningMsg,
+            QRegularExpression("resized\\(\\) is not supported for compressed format .*"));
+    QVERIFY(compressed.resized({2, 2}).isNull());
+}
+
+void TestTexture::generateMipmaps()
+{
+    Texture texture(TextureFormat::RGBA32_Float, {4, 2});
+    QVERIFY(!texture.isNull());
+    std::vector<Rgba128Float> colors(8);
+    for (size_t i = 0; i < colors.size(); ++i)
+        colors[i] = rgba128Float(float(i), 0.0f, 0.0f, 1.0f);
+    QVERIFY(texture.writeRegion({{}, {4, 2}}, {}, colors));
+
+    const auto result = texture.generateMipmaps(Texture::Filter::Box);
+    QVERIFY(!result.isNull());
+    QCOMPARE(result.format(), texture.format());
+    QCOMPARE(result.levels(), 3);
+    QCOMPARE(result.width(1), 2);
+    QCOMPARE(result.height(1), 1);
+    QCOMPARE(result.width(2), 1);
+
+    for (int x = 0; x < 4; ++x)
+        QCOMPARE(result.texelColor({x, 1}, {}), texture.texelColor({x, 1}, {}));
+    QCOMPARE(result.texelColor({0, 0}, {1}).convert<Rgba128Float>().red(), 2.5f);
+    QCOMPARE(result.texelColor({1, 0}, {1}).convert<Rgba128Float>().red(), 4.5f);
+    QCOMPARE(result.texelColor({0, 0}, {2}).convert<Rgba128Float>().red(), 3.5f);
+
+    // weights are normalized, so a constant image stays constant
+    texture.fill(rgba128Float(0.25f, 0.5f, 0.75f, 1.0f));
+    for (const auto filter: {Texture::Filter::Kaiser, Texture::Filter::Lanczos}) {
+        const auto color = texture.generateMipmaps(filter).texelColor({1, 0}, {1})
+                .convert<Rgba128Float>();
+        QVERIFY(qAbs(color.red() - 0.25f) < 1e-5f);
+        QVERIFY(qAbs(color.blue() - 0.75f) < 1e-5f);
+    }
+
+    Texture compressed(TextureFormat::Bc1Rgb_Unorm, {4, 4});
+    QTest::ignoreMessage(
+            QtWarningMsg,
+            QRegularExpression("generateMipmaps\\(\\) is not supported for compressed format .*"));
+    QVERIFY(compressed.generateMipmaps().isNull());
+    QVERIFY(Texture().generateMipmaps().isNull());
+}
+
+void TestTexture::generateMipmapsWrap()
+{
+    Texture texture(TextureFormat::RGBA32_Float, {8, 1});
+    QVERIFY(!texture.isNull());
+    texture.fill(rgba128Float(0.0f, 0.0f, 0.0f, 1.0f));
+    texture.setTexelColor({0, 0}, rgba128Float(1.0f, 0.0f, 0.0f, 1.0f));
+
+    const auto red = [](const Texture &texture, Texture::Position p, Texture::ArrayIndex index)
+    {
+        return texture.texelColor(p, index).convert<Rgba128Float>().red();
+    };
+
+    // box filter does not cross the edges when halving the size
+    QCOMPARE(red(texture.generateMipmaps(Texture::Filter::Box, Texture::MipmapOption::WrapEdges),
+                 {3, 0}, {1}),
+             red(texture.generateMipmaps(Texture::Filter::Box), {3, 0}, {1}));
+
+    const auto clamped = texture.generateMipmaps(Texture::Filter::Lanczos);
+    const auto wrapped = texture.generateMipmaps(
+            Texture::Filter::Lanczos, Texture::MipmapOption::WrapEdges);
+    QCOMPARE(clamped.levels(), 4);
+    QCOMPARE(wrapped.levels(), 4);
+    // the last texel "sees" the first one only when wrapping
+    QVERIFY(qAbs(red(clamped, {3, 0}, {1}) - red(wrapped, {3, 0}, {1})) > 1e-3f);
+}
+
+void TestTexture::generateMipmapsSrgb()
+{
+    Texture texture(TextureFormat::RGBA8_Unorm, {2, 1});
+    QVERIFY(!texture.isNull());
+    texture.setTexelColor({0, 0}, qRgba(0, 0, 0, 255));
+    texture.setTexelColor({1, 0}, qRgba(255, 255, 255, 255));
+
+    const auto linear = texture.generateMipmaps().texelColor({0, 0}, {1}).convert<QRgb>();
+    QVERIFY(qAbs(qRed(linear) - 128) <= 1);
+
+    // the average of the black and white in the linear space is 0.5, which is ~188 in sRGB
+    const auto gamma = texture.generateMipmaps(
+            Texture::Filter::Box, Texture::MipmapOption::SrgbGamma);
+    const auto color = gamma.texelColor({0, 0}, {1}).convert<QRgb>();
+    QVERIFY(qAbs(qRed(color) - 188) <= 1);
+    QCOMPARE(qAlpha(color), 255);
+
+    // sRGB formats always use gamma-correct filtering
+    Texture srgb(TextureFormat::RGBA8_Srgb, {2, 1});
+    QVERIFY(!srgb.isNull());
+    const auto data = texture.constData();
+    std::copy(data.begin(), data.end(), srgb.data().begin());
+    const auto result = srgb.generateMipmaps();
+    QVERIFY(!result.isNull());
+    QCOMPARE(result.format(), TextureFormat::RGBA8_Srgb);
+    QCOMPARE(result.constLineData({}, {1})[0], gamma.constLineData({}, {1})[0]);
+}
+
+void TestTexture::generateMipmapsAlphaCoverage()
+{
+    // 2x2 blocks have 4, 3, 2 and 1 opaque texels, so 10 of 16 texels pass the alpha test
+    Texture texture(TextureFormat::RGBA32_Float, {4, 4});
+    QVERIFY(!texture.isNull());
+    texture.fill(rgba128Float(1.0f, 1.0f, 1.0f, 0.0f));
+    const int opaque[4][2] = {{0, 0}, {1, 0}, {0, 1}, {1, 1}};
+    const int blocks[4][3] = {{0, 0, 4}, {2, 0, 3}, {0, 2, 2}, {2, 2, 1}};
+    for (const auto &block: blocks) {
+        for (int i = 0; i < block[2]; ++i) {
+            texture.setTexelColor(
+                    {block[0] + opaque[i][0], block[1] + opaque[i][1]},
+                    rgba128Float(1.0f, 1.0f, 1.0f, 1.0f));
+        }
+    }
+
+    const auto coverage = [](const Texture &texture)
+    {
+        int result = 0;
+        for (int y = 0; y < texture.height(1); ++y) {
+            for (int x = 0; x < texture.width(1); ++x) {
+                if (texture.texelColor({x, y}, {1}).convert<Rgba128Float>().alpha() > 0.5f)
+                    ++result;
+            }
+        }
+        return result;
+    };
+
+    QCOMPARE(coverage(texture.generateMipmaps()), 2);
+    const auto preserved = texture.generateMipmaps(
+            Texture::Filter::Box, Texture::MipmapOption::PreserveAlphaCoverage);
+    QCOMPARE(coverage(preserved), 3);
+    QCOMPARE(preserved.texelColor({0, 0}, {1}).convert<Rgba128Float>().alpha(), 1.0f);
+}
+
+namespace {
+
+QRgb transformColor(int x, int y)
+{
+    return qRgba(x * 30 + y * 10, y * 30, (x * y * 7) % 256, 255 - x);
+}
+
+// Fills the texel indices of BC1 blocks (or BC4 blocks for 3-bit indices) with the given pattern,
+// endpoints are chosen so that the index 0 decodes to 1 and the index 1 decodes to 0
+void writeBlocks(Texture &texture, Texture::ArrayIndex index, const std::function<int(int, int)> &pattern)
+{
+    const auto bc4 = texture.format() == TextureFormat::Bc4_Unorm;
+    const auto bits = bc4 ? 3 : 2;
+    const auto span = texture.imageSpan(index);
+    for (int by = 0; by < span.lineCount(); ++by) {
+        const auto line = span.line(by);
+        for (int bx = 0; bx * 8 < line.size(); ++bx) {
+            quint64 indices = 0;
+            for (int y = 0; y < 4; ++y) {
+                for (int x = 0; x < 4; ++x)
+                    indices |= quint64(pattern(bx * 4 + x, by * 4 + y)) << (bits * (y * 4 + x));
+            }
+            auto block = line.data() + 8 * bx;
+            if (bc4) {
+                block[0] = 255;
+                block[1] = 0;
+                for (int i = 0; i < 6; ++i)
+                    block[2 + i] = uchar(indices >> (8 * i));
+            } else {
+                block[0] = block[1] = 0xff;
+                block[2] = block[3] = 0x00;
+                for (int i = 0; i < 4; ++i)
+                    block[4 + i] = uchar(indices >> (8 * i));
+            }
+        }
+    }
+}
+
+// The expected decoded color of the index, see writeBlocks()
+QRgb blockColor(TextureFormat format, int index)
+{
+    if (format == TextureFormat::Bc4_Unorm)
+        return qRgba(index == 0 ? 255 : 0, 0, 0, 255);
+    const int values[] = {255, 0, 170, 85};
+    const auto value = values[index];
+    return qRgba(value, value, value, 255);
+}
+
+} // namespace
+
+void TestTexture::flipped_data()
+{
+    readWriteRow_data();
+}
+
+void TestTexture::flipped()
+{
+    QFETCH(TextureFormat, format);
+
+    Texture texture(format, {5, 3, 2});
+    QVERIFY(!texture.isNull());
+    for (int z = 0; z < 2; ++z) {
+        for (int y = 0; y < 3; ++y) {
+            for (int x = 0; x < 5; ++x)
+                texture.setTexelColor({x, y, z}, transformColor(x + z, y));
+        }
+    }
+    const auto hash = texture.contentHash();
+
+    const auto vertical = texture.flipped(Qt::Vertical);
+    const auto horizontal = texture.flipped(Qt::Horizontal);
+    const auto both = texture.flipped(Qt::Horizontal | Qt::Vertical);
+    QVERIFY(!vertical.isNull());
+    QVERIFY(!horizontal.isNull());
+    QVERIFY(!both.isNull());
+    QCOMPARE(vertical.width(), 5);
+    QCOMPARE(vertical.height(), 3);
+    QCOMPARE(vertical.depth(), 2);
+
+    for (int z = 0; z < 2; ++z) {
+        for (int y = 0; y < 3; ++y) {
+            for (int x = 0; x < 5; ++x) {
+                const auto expected = texture.texelColor({x, y, z}, {}).convert<QRgb>();
+                QCOMPARE(vertical.texelColor({x, 2 - y, z}, {}).convert<QRgb>(), expected);
+                QCOMPARE(horizontal.texelColor({4 - x, y, z}, {}).convert<QRgb>(), expected);
+                QCOMPARE(both.texelColor({4 - x, 2 - y, z}, {}).convert<QRgb>(), expected);
+            }
+        }
+    }
+
+    // the source is not modified
+    QCOMPARE(texture.contentHash(), hash);
+    QVERIFY(vertical.contentHash() != hash);
+    QCOMPARE(vertical.flipped(Qt::Vertical), texture);
+}
+
+void TestTexture::transposed_data()
+{
+    QTest::addColumn<TextureFormat>("format");
+    QTest::addColumn<int>("width");
+    QTest::addColumn<int>("height");
+
+    QTest::newRow("R8_Unorm") << TextureFormat::R8_Unorm << 5 << 3;
+    QTest::newRow("RGB8_Unorm") << TextureFormat::RGB8_Unorm << 5 << 3;
+    QTest::newRow("RGBA16_Float") << TextureFormat::RGBA16_Float << 5 << 3;
+    QTest::newRow("RGBA32_Float") << TextureFormat::RGBA32_Float << 5 << 3;
+    // several tiles and bands
+    QTest::newRow("RGBA8_Unorm large") << TextureFormat::RGBA8_Unorm << 300 << 170;
+}
+
+void TestTexture::transposed()
+{
+    QFETCH(TextureFormat, format);
+    QFETCH(int, width);
+    QFETCH(int, height);
+
+    Texture texture(format, {width, height}, {2, 1});
+    QVERIFY(!texture.isNull());
+    for (int level = 0; level < 2; ++level) {
+        for (int y = 0; y < texture.height(level); ++y) {
+            for (int x = 0; x < texture.width(level); ++x)
+                texture.setTexelColor({x, y}, {Texture::Side(0), level, 0}, transformColor(x, y));
+        }
+    }
+
+    const auto result = texture.transposed();
+    QVERIFY(!result.isNull());
+    QCOMPARE(result.width(), height);
+    QCOMPARE(result.height(), width);
+    QCOMPARE(result.levels(), 2);
+    QCOMPARE(result.width(1), texture.height(1));
+    QCOMPARE(result.height(1), texture.width(1));
+
+    for (int level = 0; level < 2; ++level) {
+        const Texture::ArrayIndex index(Texture::Side(0), level, 0);
+        for (int y = 0; y < texture.height(level); ++y) {
+            for (int x = 0; x < texture.width(level); ++x) {
+                QCOMPARE(result.texelColor({y, x}, index).convert<QRgb>(),
+                         texture.texelColor({x, y}, index).convert<QRgb>());
+            }
+        }
+    }
+
+    QCOMPARE(result.transposed(), texture);
+}
+
+void TestTexture::rotated()
+{
+    Texture texture(TextureFormat::RGBA8_Unorm, {3, 2});
+    QVERIFY(!texture.isNull());
+    for (int y = 0; y < 2; ++y) {
+        for (int x = 0; x < 3; ++x)
+            texture.setTexelColor({x, y}, transformColor(x, y));
+    }
+
+    const auto rotate90 = texture.rotated(Texture::Rotation::Rotate90);
+    const auto rotate180 = texture.rotated(Texture::Rotation::Rotate180);
+    const auto rotate270 = texture.rotated(Texture::Rotation::Rotate270);
+    QCOMPARE(rotate90.width(), 2);
+    QCOMPARE(rotate90.height(), 3);
+    QCOMPARE(rotate180.width(), 3);
+    QCOMPARE(rotate180.height(), 2);
+    QCOMPARE(rotate270.width(), 2);
+    QCOMPARE(rotate270.height(), 3);
+
+    for (int y = 0; y < 2; ++y) {
+        for (int x = 0; x < 3; ++x) {
+            // clockwise, so the top left corner moves to the top right corner
+            QCOMPARE(rotate90.texelColor({1 - y, x}, {}).convert<QRgb>(), transformColor(x, y));
+            QCOMPARE(rotate180.texelColor({2 - x, 1 - y}, {}).convert<QRgb>(), transformColor(x, y));
+            QCOMPARE(rotate270.texelColor({y, 2 - x}, {}).convert<QRgb>(), transformColor(x, y));
+        }
+    }
+
+    QCOMPARE(rotate90.rotated(Texture::Rotation::Rotate270), texture);
+}
+
+void TestTexture::flippedCompressed_data()
+{
+    QTest::addColumn<TextureFormat>("format");
+    QTest::addColumn<int>("size");
+
+    QTest::newRow("Bc1Rgb_Unorm") << TextureFormat::Bc1Rgb_Unorm << 8;
+    QTest::newRow("Bc1Rgb_Unorm small") << TextureFormat::Bc1Rgb_Unorm << 2;
+    QTest::newRow("Bc4_Unorm") << TextureFormat::Bc4_Unorm << 8;
+    QTest::newRow("Bc4_Unorm small") << TextureFormat::Bc4_Unorm << 3;
+}
+
+void TestTexture::flippedCompressed()
+{
+    QFETCH(TextureFormat, format);
+    QFETCH(int, size);
+
+    const auto indexCount = format == TextureFormat::Bc4_Unorm ? 2 : 4;
+    const auto pattern = [indexCount](int x, int y) { return (x * 3 + y * 5 + x * y) % indexCount; };
+
+    Texture texture(format, {size, size});
+    QVERIFY(!texture.isNull());
+    writeBlocks(texture, {}, pattern);
+
+    const auto check = [&](const Texture &result, const std::function<QRgb(int, int)> &expectedColor)
+    {
+        QVERIFY(!result.isNull());
+        QCOMPARE(result.format(), format);
+        Texture expected(TextureFormat::RGBA8_Unorm, {size, size});
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x)
+                expected.setTexelColor({x, y}, expectedColor(x, y));
+        }
+        const TextureComparison comparison(result, expected);
+        QVERIFY(!comparison.isNull());
+        QVERIFY(comparison.total().maxError < 1e-3f);
+    };
+
+    const auto last = size - 1;
+    check(texture, [&](int x, int y) { return blockColor(format, pattern(x, y)); });
+    check(texture.flipped(Qt::Vertical),
+          [&](int x, int y) { return blockColor(format, pattern(x, last - y)); });
+    check(texture.flipped(Qt::Horizontal),
+          [&](int x, int y) { return blockColor(format, pattern(last - x, y)); });
+    check(texture.transposed(),
+          [&](int x, int y) { return blockColor(format, pattern(y, x)); });
+    check(texture.rotated(Texture::Rotation::Rotate90),
+          [&](int x, int y) { return blockColor(format, pattern(y, last - x)); });
+}
+
+void TestTexture::transformInvalid()
+{
+    QVERIFY(Texture().flipped().isNull());
+    QVERIFY(Texture().transposed().isNull());
+    QVERIFY(Texture().rotated(Texture::Rotation::Rotate90).isNull());
+
+    Texture bc7(TextureFormat::Bc7_Unorm, {4, 4});
+    QVERIFY(!bc7.isNull());
+    QTest::ignoreMessage(
+            QtWarningMsg,
+            QRegularExpression("flipped\\(\\) is not supported for format .*"));
+    QVERIFY(bc7.flipped().isNull());
+    QTest::ignoreMessage(
+            QtWarningMsg,
+            QRegularExpression("transposed\\(\\) is not supported for format .*"));
+    QVERIFY(bc7.transposed().isNull());
+
+    // the last block row is partially filled, so the rows can't be flipped in blocks
+    Texture bc1(TextureFormat::Bc1Rgb_Unorm, {8, 6});
+    QVERIFY(!bc1.isNull());
+    QVERIFY(!bc1.flipped(Qt::Horizontal).isNull());
+    QTest::ignoreMessage(
+            QtWarningMsg,
+            QRegularExpression("flipped\\(\\) requires block-aligned dimensions .*"));
+    QVERIFY(bc1.flipped(Qt::Vertical).isNull());
+}
+
+void TestTexture::swizzled_data()
+{
+    QTest::addColumn<TextureFormat>("format");
+
+    // 8-bit formats are processed natively, others are decoded
+    QTest::newRow("RGBA8_Unorm") << TextureFormat::RGBA8_Unorm;
+    QTest::newRow("BGRA8_Unorm") << TextureFormat::BGRA8_Unorm;
+    QTest::newRow("RGBA16_Unorm") << TextureFormat::RGBA16_Unorm;
+    QTest::newRow("RGBA32_Float") << TextureFormat::RGBA32_Float;
+}
+
+void TestTexture::swizzled()
+{
+    QFETCH(TextureFormat, format);
+
+    using Value = Texture::SwizzleValue;
+
+    Texture texture(format, {3, 2}, {2, 1});
+    QVERIFY(!texture.isNull());
+    texture.fill(qRgba(10, 20, 30, 40));
+    texture.setTexelColor({2, 1}, qRgba(50, 60, 70, 80));
+
+    const auto identity = texture.swizzled({Value::Red, Value::Green, Value::Blue, Value::Alpha});
+    QCOMPARE(identity, texture);
+
+    // RG to BA
+    const auto moved = texture.swizzled({Value::Zero, Value::Zero, Value::Red, Value::Green});
+    QVERIFY(!moved.isNull());
+    QCOMPARE(moved.format(), format);
+    QCOMPARE(moved.texelColor({0, 0}, {}).convert<QRgb>(), qRgba(0, 0, 10, 20));
+    QCOMPARE(moved.texelColor({2, 1}, {}).convert<QRgb>(), qRgba(0, 0, 50, 60));
+    // all levels are processed
+    const Texture::ArrayIndex level1(Texture::Side(0), 1, 0);
+    QCOMPARE(moved.texelColor({0, 0}, level1).convert<QRgb>(), qRgba(0, 0, 10, 20));
+
+    const auto reversed = texture.swizzled({Value::Alpha, Value::Blue, Value::Green, Value::One});
+    QCOMPARE(reversed.texelColor({2, 1}, {}).convert<QRgb>(), qRgba(80, 70, 60, 255));
+}
+
+void TestTexture::premultiplied_data()
+{
+    swizzled_data();
+}
+
+void TestTexture::premultiplied()
+{
+    QFETCH(TextureFormat, format);
+
+    Texture texture(format, {4, 1});
+    QVERIFY(!texture.isNull());
+    texture.setTexelColor({0, 0}, qRgba(200, 100, 50, 255));
+    texture.setTexelColor({1, 0}, qRgba(200, 100, 50, 128));
+    texture.setTexelColor({2, 0}, qRgba(200, 100, 50, 0));
+    texture.setTexelColor({3, 0}, qRgba(255, 255, 255, 51));
+
+    const auto result = texture.premultiplied();
+    QVERIFY(!result.isNull());
+    QCOMPARE(result.texelColor({0, 0}, {}).convert<QRgb>(), qRgba(200, 100, 50, 255));
+    QCOMPARE(result.texelColor({1, 0}, {}).convert<QRgb>(), qRgba(100, 50, 25, 128));
+    QCOMPARE(result.texelColor({2, 0}, {}).convert<QRgb>(), qRgba(0, 0, 0, 0));
+    QCOMPARE(result.texelColor({3, 0}, {}).convert<QRgb>(), qRgba(51, 51, 51, 51));
+
+    const auto restored = result.unpremultiplied();
+    QVERIFY(!restored.isNull());
+    QCOMPARE(restored.texelColor({0, 0}, {}).convert<QRgb>(), qRgba(200, 100, 50, 255));
+    const auto color = restored.texelColor({1, 0}, {}).convert<QRgb>();
+    QVERIFY(qAbs(qRed(color) - 200) <= 1);
+    QVERIFY(qAbs(qGreen(color) - 100) <= 1);
+    QVERIFY(qAbs(qBlue(color) - 50) <= 1);
+    QCOMPARE(qAlpha(color), 128);
+    // colors of transparent texels are lost
+    QCOMPARE(restored.texelColor({2, 0}, {}).convert<QRgb>(), qRgba(0, 0, 0, 0));
+    QCOMPARE(restored.texelColor({3, 0}, {}).convert<QRgb>(), qRgba(255, 255, 255, 51));
+}
+
+void TestTexture::colorOperationsInvalid()
+{
+    QVERIFY(Texture().premultiplied().isNull());
+
+    Texture compressed(TextureFormat::Bc1Rgb_Unorm, {4, 4});
+    QVERIFY(!compressed.isNull());
+    QTest::ignoreMessage(
+            QtWarningMsg,
+            QRegularExpression("premultiplied\\(\\) is not supported for compressed format .*"));
+    QVERIFY(compressed.premultiplied().isNull());
+}
+
+void TestTexture::clear()
+{
+    Texture texture(TextureFormat::RGBA8_Unorm, {4, 4});
+    QVERIFY(!texture.isNull());
+    texture.fill(qRgba(1, 2, 3, 4));
+    const auto hash = texture.contentHash();
+
+    texture.clear();
+    const auto data = texture.constData();
+    QVERIFY(std::all_of(data.begin(), data.end(), [](uchar value) { return value == 0; }));
+    QVERIFY(texture.contentHash() != hash);
+
+    // shared data is left intact
+    texture.fill(qRgba(1, 2, 3, 4));
+    const auto shared = texture;
+    texture.clear();
+    const auto cleared = texture.constData();
+    QVERIFY(std::all_of(cleared.begin(), cleared.end(), [](uchar value) { return value == 0; }));
+    QCOMPARE(shared.contentHash(), hash);
+    QCOMPARE(texture.format(), shared.format());
+    QCOMPARE(texture.width(), shared.width());
+    QCOMPARE(texture.height(), shared.height());
+}
+
 void TestTexture::invalid()
 {
     constexpr auto message = "Invalid parameter(s) passed to Texture::create";
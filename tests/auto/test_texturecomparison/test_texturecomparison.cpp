@@ -0,0 +1,217 @@
+#include <QtTest>
+#include <TextureLib/Texture>
+#include <TextureLib/TextureComparison>
+
+#include <cmath>
+
+class TestTextureComparison : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void defaultConstructed();
+    void equal_data();
+    void equal();
+    void metrics();
+    void singleChannel();
+    void ssim();
+    void differentFormats();
+    void compressed();
+    void diffImage();
+    void differentSizes();
+};
+
+void TestTextureComparison::defaultConstructed()
+{
+    TextureComparison comparison;
+    QVERIFY(comparison.isNull());
+    QCOMPARE(comparison.texelCount(), 0);
+    QVERIFY(comparison.diffImage().isNull());
+    QVERIFY(TextureComparison(Texture(), Texture()).isNull());
+}
+
+void TestTextureComparison::equal_data()
+{
+    QTest::addColumn<TextureFormat>("format");
+
+    QTest::newRow("RGBA8_Unorm") << TextureFormat::RGBA8_Unorm;
+    QTest::newRow("RGBA16_Float") << TextureFormat::RGBA16_Float;
+    QTest::newRow("RGBA32_Float") << TextureFormat::RGBA32_Float;
+}
+
+void TestTextureComparison::equal()
+{
+    QFETCH(TextureFormat, format);
+
+    Texture texture(format, {16, 16});
+    QVERIFY(!texture.isNull());
+    for (int y = 0; y < 16; ++y) {
+        for (int x = 0; x < 16; ++x)
+            texture.setTexelColor({x, y}, qRgba(x * 16, y * 16, 128, 255));
+    }
+
+    const TextureComparison comparison(texture, texture);
+    QVERIFY(!comparison.isNull());
+    QCOMPARE(comparison.texelCount(), 256);
+    QCOMPARE(comparison.total().mse, 0.0);
+    QVERIFY(std::isinf(comparison.total().psnr));
+    QVERIFY(qAbs(comparison.total().ssim - 1.0) < 1e-9);
+    QCOMPARE(comparison.total().maxError, 0.0f);
+}
+
+void TestTextureComparison::metrics()
+{
+    Texture lhs(TextureFormat::RGBA32_Float, {4, 4});
+    QVERIFY(!lhs.isNull());
+    lhs.fill(rgba128Float(0.5f, 0.5f, 0.5f, 1.0f));
+
+    auto rhs = lhs.copy();
+    rhs.setTexelColor({1, 2}, rgba128Float(0.5f, 0.0f, 0.5f, 1.0f));
+
+    const TextureComparison comparison(lhs, rhs);
+    QVERIFY(!comparison.isNull());
+    QCOMPARE(comparison.channel(TextureComparison::Red).mse, 0.0);
+    // one texel out of 16 differs by 0.5
+    QVERIFY(qAbs(comparison.channel(TextureComparison::Green).mse - 0.25 / 16) < 1e-9);
+    QVERIFY(qAbs(comparison.channel(TextureComparison::Green).psnr
+                 - 10.0 * std::log10(64.0)) < 1e-9);
+    QCOMPARE(comparison.channel(TextureComparison::Green).maxError, 0.5f);
+    QVERIFY(comparison.channel(TextureComparison::Green).ssim < 1.0);
+
+    QVERIFY(qAbs(comparison.total().mse - 0.25 / 64) < 1e-9);
+    QCOMPARE(comparison.total().maxError, 0.5f);
+    QVERIFY(qAbs(comparison.total().ssim
+                 - (3.0 + comparison.channel(TextureComparison::Green).ssim) / 4) < 1e-9);
+}
+
+void TestTextureComparison::singleChannel()
+{
+    Texture lhs(TextureFormat::R8_Unorm, {4, 4});
+    QVERIFY(!lhs.isNull());
+    lhs.fill(qRgba(255, 0, 0, 255));
+
+    auto rhs = lhs.copy();
+    rhs.setTexelColor({1, 2}, qRgba(0, 0, 0, 255));
+
+    // green, blue and alpha are not stored, so they don't dilute the error of red
+    const TextureComparison comparison(lhs, rhs);
+    QVERIFY(!comparison.isNull());
+    QVERIFY(qAbs(comparison.channel(TextureComparison::Red).mse - 1.0 / 16) < 1e-9);
+    QCOMPARE(comparison.channel(TextureComparison::Alpha).mse, 0.0);
+    QVERIFY(qAbs(comparison.total().mse - 1.0 / 16) < 1e-9);
+    QVERIFY(qAbs(comparison.total().psnr - comparison.channel(TextureComparison::Red).psnr) < 1e-9);
+    QVERIFY(qAbs(comparison.total().ssim - comparison.channel(TextureComparison::Red).ssim) < 1e-9);
+}
+
+void TestTextureComparison::ssim()
+{
+    // big enough to be split into several bands of windows
+    Texture lhs(TextureFormat::RGBA8_Unorm, {256, 256});
+    QVERIFY(!lhs.isNull());
+    for (int y = 0; y < 256; ++y) {
+        for (int x = 0; x < 256; ++x)
+            lhs.setTexelColor({x, y}, qRgba(x, y, (x ^ y) & 0xff, 255));
+    }
+
+    // a small uniform offset keeps the structure, noise destroys it
+    Texture shifted(TextureFormat::RGBA8_Unorm, {256, 256});
+    Texture noisy(TextureFormat::RGBA8_Unorm, {256, 256});
+    for (int y = 0; y < 256; ++y) {
+        for (int x = 0; x < 256; ++x) {
+            const auto color = lhs.texelColor({x, y}, {}).convert<QRgb>();
+            shifted.setTexelColor({x, y}, qRgba(qMin(qRed(color) + 4, 255),
+                                                qMin(qGreen(color) + 4, 255),
+                                                qMin(qBlue(color) + 4, 255), 255));
+            const auto noise = (x * 7 + y * 13) % 2 ? 64 : -64;
+            noisy.setTexelColor({x, y}, qRgba(qBound(0, qRed(color) + noise, 255),
+                                              qBound(0, qGreen(color) + noise, 255),
+                                              qBound(0, qBlue(color) + noise, 255), 255));
+        }
+    }
+
+    const TextureComparison shiftedComparison(lhs, shifted);
+    const TextureComparison noisyComparison(lhs, noisy);
+    QCOMPARE(shiftedComparison.texelCount(), 256 * 256);
+    QVERIFY(shiftedComparison.total().ssim > 0.95);
+    QVERIFY(noisyComparison.total().ssim < shiftedComparison.total().ssim);
+    QVERIFY(noisyComparison.total().psnr < shiftedComparison.total().psnr);
+}
+
+void TestTextureComparison::differentFormats()
+{
+    Texture lhs(TextureFormat::RGBA8_Unorm, {8, 8});
+    QVERIFY(!lhs.isNull());
+    lhs.fill(qRgba(255, 0, 51, 255));
+    const auto rhs = lhs.convert(TextureFormat::RGBA32_Float);
+
+    const TextureComparison comparison(lhs, rhs);
+    QVERIFY(!comparison.isNull());
+    QVERIFY(comparison.total().mse < 1e-12);
+}
+
+void TestTextureComparison::compressed()
+{
+    // a single BC1 block with red as the first color and all indices pointing to it
+    Texture compressed(TextureFormat::Bc1Rgb_Unorm, {4, 4});
+    QVERIFY(!compressed.isNull());
+    const uchar block[8] = {0x00, 0xf8, 0x1f, 0x00, 0x00, 0x00, 0x00, 0x00};
+    std::copy(std::begin(block), std::end(block), compressed.imageData({}).data());
+
+    Texture expected(TextureFormat::RGBA8_Unorm, {4, 4});
+    QVERIFY(!expected.isNull());
+    expected.fill(qRgba(255, 0, 0, 255));
+
+    const TextureComparison comparison(compressed, expected);
+    QVERIFY(!comparison.isNull());
+    QCOMPARE(comparison.texelCount(), 16);
+    QCOMPARE(comparison.total().maxError, 0.0f);
+
+    // indices 1 select blue
+    const uchar blueBlock[8] = {0x00, 0xf8, 0x1f, 0x00, 0x55, 0x55, 0x55, 0x55};
+    std::copy(std::begin(blueBlock), std::end(blueBlock), compressed.imageData({}).data());
+    const TextureComparison blue(compressed, expected);
+    QCOMPARE(blue.channel(TextureComparison::Red).maxError, 1.0f);
+    QCOMPARE(blue.channel(TextureComparison::Blue).maxError, 1.0f);
+    QCOMPARE(blue.channel(TextureComparison::Green).maxError, 0.0f);
+
+    Texture unsupported(TextureFormat::Bc7_Unorm, {4, 4});
+    QVERIFY(!unsupported.isNull());
+    QTest::ignoreMessage(
+            QtWarningMsg,
+            QRegularExpression("Comparison is not supported for format .*"));
+    QVERIFY(TextureComparison(unsupported, expected).isNull());
+}
+
+void TestTextureComparison::diffImage()
+{
+    Texture lhs(TextureFormat::RGBA8_Unorm, {4, 4});
+    QVERIFY(!lhs.isNull());
+    lhs.fill(qRgba(100, 100, 100, 255));
+    auto rhs = lhs.copy();
+    rhs.setTexelColor({3, 1}, qRgba(150, 90, 100, 0));
+
+    QVERIFY(TextureComparison(lhs, rhs).diffImage().isNull());
+
+    const TextureComparison comparison(lhs, rhs, {}, TextureComparison::Option::DiffImage);
+    const auto &diff = comparison.diffImage();
+    QVERIFY(!diff.isNull());
+    QCOMPARE(diff.format(), TextureFormat::RGBA8_Unorm);
+    QCOMPARE(diff.width(), 4);
+    QCOMPARE(diff.height(), 4);
+    QCOMPARE(diff.texelColor({0, 0}, {}).convert<QRgb>(), qRgba(0, 0, 0, 255));
+    QCOMPARE(diff.texelColor({3, 1}, {}).convert<QRgb>(), qRgba(50, 10, 0, 255));
+}
+
+void TestTextureComparison::differentSizes()
+{
+    Texture lhs(TextureFormat::RGBA8_Unorm, {4, 4});
+    Texture rhs(TextureFormat::RGBA8_Unorm, {4, 8});
+    QVERIFY(!lhs.isNull());
+    QVERIFY(!rhs.isNull());
+    QTest::ignoreMessage(QtWarningMsg, "Can't compare textures of different sizes");
+    QVERIFY(TextureComparison(lhs, rhs).isNull());
+}
+
+QTEST_APPLESS_MAIN(TestTextureComparison)
+
+#include "test_texturecomparison.moc"
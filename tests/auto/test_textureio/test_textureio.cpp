@@ -5,6 +5,10 @@
 #include <TextureLib/private/TextureIOHandlerDatabase>
 
 #include <QtCore/QMimeType>
+#include <QtCore/QTemporaryDir>
+
+#include <limits>
+#include <numeric>
 
 class TestTextureIO : public QObject
 {
@@ -15,9 +19,19 @@ private slots:
     void setters();
     void read_data();
     void read();
+    void readInfo();
+    void readOptions();
+    void readPartial();
+    void readProgressive();
+    void readProgressiveSingleLevel();
+    void readProgressiveSequential();
+    void setDataTooBig();
     void write_data();
     void write();
     void availableMimeTypes();
+    void pluginIndexCache();
+    void mimeTypeForHeader_data();
+    void mimeTypeForHeader();
 };
 
 void TestTextureIO::initTestCase()
@@ -94,6 +108,283 @@ void TestTextureIO::read()
     QCOMPARE(*result, expectedTexture);
 }
 
+void TestTextureIO::readInfo()
+{
+    const auto expectedTexture = Texture(
+            TextureFormat::RGBA8_Unorm, {16, 8}, {Texture::IsCubemap::Yes, 3, 2});
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QDataStream stream(&buffer);
+    stream << expectedTexture;
+    buffer.close();
+
+    TextureIO io;
+    io.setDevice(TextureIO::QIODevicePointer(&buffer));
+    io.setMimeType(u"application/octet-stream");
+
+    // the test handler does not reimplement readInfo(), so the default implementation is used
+    const auto info = io.readInfo();
+    QVERIFY2(info, qPrintable(toUserString(info.error())));
+    QVERIFY(*info == TextureInfo(expectedTexture));
+    QCOMPARE(info->format(), TextureFormat::RGBA8_Unorm);
+    QCOMPARE(info->width(), 16);
+    QCOMPARE(info->height(), 8);
+    QCOMPARE(info->depth(), 1);
+    QCOMPARE(info->faces(), 6);
+    QCOMPARE(info->levels(), 3);
+    QCOMPARE(info->layers(), 2);
+
+    // the device position is restored, so the texture can be read afterwards
+    const auto result = io.read();
+    QVERIFY2(result, qPrintable(toUserString(result.error())));
+    QCOMPARE(*result, expectedTexture);
+
+    QVERIFY(TextureInfo().isNull());
+    QVERIFY(TextureInfo(Texture()).isNull());
+}
+
+void TestTextureIO::readOptions()
+{
+    const auto source = TextureInfo(
+            TextureFormat::RGBA8_Unorm, {16, 8}, {Texture::IsCubemap::Yes, 4, 3});
+
+    TextureReadOptions options;
+    QVERIFY(options.readsAll());
+    QVERIFY(options.resultInfo(source) == source);
+
+    options.setLevels(1, 2);
+    options.setLayers(2);
+    QVERIFY(!options.readsAll());
+    auto info = options.resultInfo(source);
+    QCOMPARE(info.width(), 8);
+    QCOMPARE(info.height(), 4);
+    QCOMPARE(info.levels(), 2);
+    QCOMPARE(info.layers(), 1);
+    QVERIFY(info.isCubemap());
+    QVERIFY(options.contains(source, {Texture::Side::NegativeY, 2, 2}));
+    QVERIFY(!options.contains(source, {Texture::Side::NegativeY, 3, 2}));
+    QVERIFY(!options.contains(source, {Texture::Side::NegativeY, 1, 1}));
+    const auto index = options.mapped(source, {Texture::Side::NegativeY, 2, 2});
+    QCOMPARE(index.side(), Texture::Side::NegativeY);
+    QCOMPARE(index.level(), 1);
+    QCOMPARE(index.layer(), 0);
+
+    // a single face of a cubemap is read as a 2D texture
+    options.setFaces(TextureReadOptions::face(Texture::Side::PositiveZ));
+    info = options.resultInfo(source);
+    QVERIFY(!info.isCubemap());
+    QCOMPARE(info.faces(), 1);
+    QVERIFY(options.contains(source, {Texture::Side::PositiveZ, 1, 2}));
+    QVERIFY(!options.contains(source, {Texture::Side::PositiveX, 1, 2}));
+    QCOMPARE(options.mapped(source, {Texture::Side::PositiveZ, 1, 2}).side(),
+             Texture::Side::PositiveX);
+
+    // out of range requests
+    options.setLevels(4);
+    QVERIFY(options.resultInfo(source).isNull());
+    options.setLevels(0);
+    options.setFaces(TextureReadOptions::Face::NoFaces);
+    QVERIFY(options.resultInfo(source).isNull());
+}
+
+void TestTextureIO::readPartial()
+{
+    auto expectedTexture = Texture(
+            TextureFormat::RGBA8_Unorm, {16, 16}, {Texture::IsCubemap::Yes, 3, 2});
+    QVERIFY(!expectedTexture.isNull());
+    for (int layer = 0; layer < expectedTexture.layers(); ++layer) {
+        for (int level = 0; level < expectedTexture.levels(); ++level) {
+            for (int face = 0; face < expectedTexture.faces(); ++face) {
+                const auto data = expectedTexture.imageData({Texture::Side(face), level, layer});
+                std::fill(data.begin(), data.end(), uchar(layer * 64 + level * 8 + face));
+            }
+        }
+    }
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QDataStream stream(&buffer);
+    stream << expectedTexture;
+    buffer.close();
+
+    TextureIO io;
+    io.setDevice(TextureIO::QIODevicePointer(&buffer));
+    io.setMimeType(u"application/octet-stream");
+
+    // the test handler does not reimplement readPartial(), so the default implementation is used
+    TextureReadOptions options;
+    options.setLevels(1);
+    options.setLayers(1, 1);
+    options.setFaces(TextureReadOptions::face(Texture::Side::NegativeY));
+    const auto result = io.read(options);
+    QVERIFY2(result, qPrintable(toUserString(result.error())));
+    QCOMPARE(result->width(), 8);
+    QCOMPARE(result->height(), 8);
+    QCOMPARE(result->faces(), 1);
+    QCOMPARE(result->levels(), 2);
+    QCOMPARE(result->layers(), 1);
+    for (int level = 0; level < result->levels(); ++level) {
+        const auto data = result->imageData({Texture::Side::PositiveX, level, 0});
+        const auto expectedData = expectedTexture.imageData({Texture::Side::NegativeY, level + 1, 1});
+        QVERIFY(std::equal(data.begin(), data.end(), expectedData.begin(), expectedData.end()));
+    }
+
+    // several faces are read as a cubemap, unrequested faces are zeroed
+    QVERIFY(buffer.seek(0));
+    options = TextureReadOptions();
+    options.setFaces(TextureReadOptions::face(Texture::Side::PositiveX)
+                     | TextureReadOptions::face(Texture::Side::NegativeY));
+    const auto faces = io.read(options);
+    QVERIFY2(faces, qPrintable(toUserString(faces.error())));
+    QCOMPARE(faces->faces(), 6);
+    for (int face = 0; face < faces->faces(); ++face) {
+        const auto side = Texture::Side(face);
+        const auto data = faces->constImageData({side, 2, 1});
+        if (options.faces().testFlag(TextureReadOptions::face(side))) {
+            const auto expectedData = expectedTexture.constImageData({side, 2, 1});
+            QVERIFY(std::equal(data.begin(), data.end(), expectedData.begin(), expectedData.end()));
+        } else {
+            QVERIFY(std::all_of(data.begin(), data.end(), [](uchar value) { return value == 0; }));
+        }
+    }
+}
+
+void TestTextureIO::readProgressive()
+{
+    auto expectedTexture = Texture(
+            TextureFormat::RGBA8_Unorm, {16, 16}, {Texture::IsCubemap::Yes, 3, 2});
+    QVERIFY(!expectedTexture.isNull());
+    for (int layer = 0; layer < expectedTexture.layers(); ++layer) {
+        for (int level = 0; level < expectedTexture.levels(); ++level) {
+            for (int face = 0; face < expectedTexture.faces(); ++face) {
+                const auto data = expectedTexture.imageData({Texture::Side(face), level, layer});
+                std::fill(data.begin(), data.end(), uchar(layer * 64 + level * 8 + face));
+            }
+        }
+    }
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QDataStream stream(&buffer);
+    stream << expectedTexture;
+    buffer.close();
+
+    TextureIO io;
+    io.setDevice(TextureIO::QIODevicePointer(&buffer));
+    io.setMimeType(u"application/octet-stream");
+
+    std::vector<int> levels;
+    const auto callback = [&levels, &expectedTexture](int level, const Texture &texture)
+    {
+        levels.push_back(level);
+        QCOMPARE(texture.width(), expectedTexture.width(level));
+        QCOMPARE(texture.height(), expectedTexture.height(level));
+        QCOMPARE(texture.levels(), 1);
+        QCOMPARE(texture.layers(), expectedTexture.layers());
+        QCOMPARE(texture.faces(), expectedTexture.faces());
+        const auto data = texture.imageData({Texture::Side::NegativeZ, 0, 1});
+        const auto expectedData = expectedTexture.imageData({Texture::Side::NegativeZ, level, 1});
+        QVERIFY(std::equal(data.begin(), data.end(), expectedData.begin(), expectedData.end()));
+    };
+
+    const auto result = io.readProgressive(callback, TextureIO::LevelOrder::SmallestFirst);
+    QVERIFY2(result, qPrintable(toUserString(result.error())));
+    QCOMPARE(*result, expectedTexture);
+    QCOMPARE(levels, std::vector<int>({2, 1, 0}));
+}
+
+void TestTextureIO::readProgressiveSingleLevel()
+{
+    auto expectedTexture = Texture(TextureFormat::RGBA8_Unorm, {16, 8});
+    QVERIFY(!expectedTexture.isNull());
+    const auto data = expectedTexture.imageData({});
+    std::iota(data.begin(), data.end(), uchar(0));
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QDataStream stream(&buffer);
+    stream << expectedTexture;
+    buffer.close();
+
+    TextureIO io;
+    io.setDevice(TextureIO::QIODevicePointer(&buffer));
+    io.setMimeType(u"application/octet-stream");
+
+    std::vector<int> levels;
+    const auto callback = [&levels](int level, const Texture &texture)
+    {
+        Q_UNUSED(texture);
+        levels.push_back(level);
+    };
+
+    // the header is read first, the texture must be read from the start again
+    const auto result = io.readProgressive(callback, TextureIO::LevelOrder::SmallestFirst);
+    QVERIFY2(result, qPrintable(toUserString(result.error())));
+    QCOMPARE(*result, expectedTexture);
+    QCOMPARE(levels, std::vector<int>({0}));
+}
+
+void TestTextureIO::readProgressiveSequential()
+{
+    class SequentialBuffer : public QBuffer
+    {
+    public:
+        bool isSequential() const override { return true; }
+    };
+
+    auto expectedTexture = Texture(TextureFormat::RGBA8_Unorm, {16, 8}, {Texture::IsCubemap::No, 3, 2});
+    QVERIFY(!expectedTexture.isNull());
+    for (int layer = 0; layer < expectedTexture.layers(); ++layer) {
+        for (int level = 0; level < expectedTexture.levels(); ++level) {
+            const auto data = expectedTexture.imageData({level, layer});
+            std::fill(data.begin(), data.end(), uchar(layer * 64 + level * 8));
+        }
+    }
+
+    SequentialBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QDataStream stream(&buffer);
+    stream << expectedTexture;
+    buffer.close();
+
+    TextureIO io;
+    io.setDevice(TextureIO::QIODevicePointer(&buffer));
+    io.setMimeType(u"application/octet-stream");
+
+    std::vector<int> levels;
+    const auto callback = [&levels, &expectedTexture](int level, const Texture &texture)
+    {
+        levels.push_back(level);
+        QCOMPARE(texture.levels(), 1);
+        const auto data = texture.imageData({0, 1});
+        const auto expectedData = expectedTexture.imageData({level, 1});
+        QVERIFY(std::equal(data.begin(), data.end(), expectedData.begin(), expectedData.end()));
+    };
+
+    // the device can't be rewound, so the texture is read only once
+    const auto result = io.readProgressive(callback, TextureIO::LevelOrder::LargestFirst);
+    QVERIFY2(result, qPrintable(toUserString(result.error())));
+    QCOMPARE(*result, expectedTexture);
+    QCOMPARE(levels, std::vector<int>({0, 1, 2}));
+}
+
+void TestTextureIO::setDataTooBig()
+{
+    // the memory is never accessed, the size is rejected before
+    const uchar byte = 0;
+    const auto data = Texture::ConstData(&byte, qsizetype(std::numeric_limits<int>::max()) + 1);
+
+    TextureIO io;
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Data is too big"));
+    io.setData(data, nullptr);
+    QVERIFY(io.device() == nullptr);
+
+    const auto result = io.read();
+    QVERIFY(!result);
+    QCOMPARE(result.error(), TextureIOError::DeviceError);
+}
+
 void TestTextureIO::write_data()
 {
     QTest::addColumn<int>("width");
@@ -150,6 +441,59 @@ void TestTextureIO::availableMimeTypes()
 
 }
 
+void TestTextureIO::pluginIndexCache()
+{
+    const auto mimeTypes = [](const TextureIOHandlerDatabase &database)
+    {
+        QStringList result;
+        for (const auto mimeType: database.availableMimeTypes(TextureIO::Capability::ReadWrite))
+            result.append(mimeType.toString());
+        return result;
+    };
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const auto cachePath = dir.filePath(QStringLiteral("textureformats.json"));
+    TextureIOHandlerDatabase::setIndexCachePath(cachePath);
+
+    TextureIOHandlerDatabase database;
+    const auto expected = mimeTypes(database);
+    QVERIFY(QFile::exists(cachePath));
+
+    // the second database reads metadata from the cache
+    TextureIOHandlerDatabase cachedDatabase;
+    QCOMPARE(mimeTypes(cachedDatabase), expected);
+    QVERIFY(cachedDatabase.plugin(QStringLiteral("image/x-dds")) != nullptr);
+    QVERIFY(!cachedDatabase.readableFormats().empty());
+
+    TextureIOHandlerDatabase::setIndexCachePath(QString());
+}
+
+void TestTextureIO::mimeTypeForHeader_data()
+{
+    QTest::addColumn<QByteArray>("header");
+    QTest::addColumn<QString>("mimeType");
+
+    QTest::newRow("dds") << QByteArray("DDS \x7c\0\0\0", 8) << QStringLiteral("image/x-dds");
+    QTest::newRow("ktx") << QByteArray::fromHex("AB4B5458203131BB0D0A1A0A01020304")
+                         << QStringLiteral("image/x-ktx");
+    QTest::newRow("pkm") << QByteArray("PKM 20") << QStringLiteral("image/x-pkm");
+    QTest::newRow("vtf") << QByteArray("VTF\0\x07\0\0\0", 8) << QStringLiteral("image/x-vtf");
+    QTest::newRow("short") << QByteArray("DD") << QString();
+    QTest::newRow("unknown") << QByteArray("\x89PNG\r\n\x1a\n") << QString();
+    QTest::newRow("empty") << QByteArray() << QString();
+}
+
+void TestTextureIO::mimeTypeForHeader()
+{
+    QFETCH(QByteArray, header);
+    QFETCH(QString, mimeType);
+
+    const auto database = TextureIOHandlerDatabase::instance();
+    QVERIFY(database->maxMagicSize() >= 12);
+    QCOMPARE(database->mimeTypeForHeader(header), mimeType);
+}
+
 QTEST_APPLESS_MAIN(TestTextureIO)
 
 #include "test_textureio.moc"
@@ -7,6 +7,7 @@ class TestHandler : public TextureIOHandler
 {
 public:
     bool read(Texture &texture) override;
+    bool supportsPartialRead() const noexcept override { return true; }
     bool write(const Texture &contents) override;
 };
 
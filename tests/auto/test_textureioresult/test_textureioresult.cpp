@@ -32,6 +32,8 @@ void TestTextureIOResult::construction_data()
     QTest::newRow("DeviceError") << TextureIOError::DeviceError << false;
     QTest::newRow("UnsupportedMimeType") << TextureIOError::UnsupportedMimeType << false;
     QTest::newRow("IOError") << TextureIOError::HandlerError << false;
+    QTest::newRow("Canceled") << TextureIOError::Canceled << false;
+    QTest::newRow("TextureMismatch") << TextureIOError::TextureMismatch << false;
 }
 
 void TestTextureIOResult::construction()
@@ -0,0 +1,301 @@
+#include <QtTest>
+#include <TextureLib/Texture>
+#include <TextureLib/TextureComparison>
+#include <TextureLib/TexturePipeline>
+
+class TestTexturePipeline : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void defaultConstructed();
+    void convert_data();
+    void convert();
+    void resize_data();
+    void resize();
+    void resizeSrgb();
+    void generateMipmaps_data();
+    void generateMipmaps();
+    void alphaCoverage();
+    void fused();
+    void operationOrder();
+    void subresources();
+    void invalid();
+};
+
+namespace {
+
+Texture makeTexture(TextureFormat format, Texture::Size size, Texture::ArraySize dimensions = {1, 1})
+{
+    Texture result(format, size, dimensions);
+    for (int layer = 0; layer < result.layers(); ++layer) {
+        for (int level = 0; level < result.levels(); ++level) {
+            for (int face = 0; face < result.faces(); ++face) {
+                const Texture::ArrayIndex index(Texture::Side(face), level, layer);
+                for (int y = 0; y < result.height(level); ++y) {
+                    for (int x = 0; x < result.width(level); ++x) {
+                        const auto color = qRgba((x * 37 + face * 20) % 256,
+                                                 (y * 23 + layer * 50) % 256,
+                                                 (x * y * 7 + level * 30) % 256,
+                                                 255 - (x * 11) % 256);
+                        result.setTexelColor({x, y}, index, color);
+                    }
+                }
+            }
+        }
+    }
+    return result;
+}
+
+// Returns the maximum absolute error over all subresources
+float maxError(const Texture &lhs, const Texture &rhs)
+{
+    float result = 0.0f;
+    for (int layer = 0; layer < lhs.layers(); ++layer) {
+        for (int level = 0; level < lhs.levels(); ++level) {
+            for (int face = 0; face < lhs.faces(); ++face) {
+                const TextureComparison comparison(lhs, rhs, {Texture::Side(face), level, layer});
+                if (comparison.isNull())
+                    return 1.0f;
+                result = std::max(result, comparison.total().maxError);
+            }
+        }
+    }
+    return result;
+}
+
+bool sameLayout(const Texture &lhs, const Texture &rhs)
+{
+    return lhs.format() == rhs.format()
+            && lhs.width() == rhs.width()
+            && lhs.height() == rhs.height()
+            && lhs.levels() == rhs.levels()
+            && lhs.faces() == rhs.faces()
+            && lhs.layers() == rhs.layers();
+}
+
+} // namespace
+
+void TestTexturePipeline::defaultConstructed()
+{
+    TexturePipeline pipeline;
+    QVERIFY(pipeline.source().isNull());
+    QCOMPARE(pipeline.scratchBytes(), TexturePipeline::DefaultScratchBytes);
+    QVERIFY(pipeline.execute().isNull());
+    QVERIFY(TexturePipeline(Texture()).convert(TextureFormat::RGBA8_Unorm).execute().isNull());
+}
+
+void TestTexturePipeline::convert_data()
+{
+    QTest::addColumn<TextureFormat>("format");
+
+    QTest::newRow("BGRA8_Unorm") << TextureFormat::BGRA8_Unorm;
+    QTest::newRow("RGBA16_Unorm") << TextureFormat::RGBA16_Unorm;
+    QTest::newRow("RGBA32_Float") << TextureFormat::RGBA32_Float;
+}
+
+void TestTexturePipeline::convert()
+{
+    QFETCH(TextureFormat, format);
+
+    const auto texture = makeTexture(TextureFormat::RGBA8_Unorm, {17, 9}, {Texture::IsCubemap::No, 3});
+    const auto expected = texture.convert(format);
+    const auto result = TexturePipeline(texture).convert(format).execute();
+
+    QVERIFY(sameLayout(result, expected));
+    QVERIFY(maxError(result, expected) <= 0.5f / 255);
+}
+
+void TestTexturePipeline::resize_data()
+{
+    QTest::addColumn<Texture::Filter>("filter");
+    QTest::addColumn<qsizetype>("scratchBytes");
+
+    QTest::newRow("Box") << Texture::Filter::Box << TexturePipeline::DefaultScratchBytes;
+    QTest::newRow("Lanczos") << Texture::Filter::Lanczos << TexturePipeline::DefaultScratchBytes;
+    QTest::newRow("Kaiser") << Texture::Filter::Kaiser << TexturePipeline::DefaultScratchBytes;
+    // a single line of scratch, each destination line is a band
+    QTest::newRow("Lanczos, bands") << Texture::Filter::Lanczos << qsizetype(64);
+    QTest::newRow("Kaiser, bands") << Texture::Filter::Kaiser << qsizetype(2048);
+}
+
+void TestTexturePipeline::resize()
+{
+    QFETCH(Texture::Filter, filter);
+    QFETCH(qsizetype, scratchBytes);
+
+    const auto texture = makeTexture(TextureFormat::RGBA8_Unorm, {32, 24});
+    for (const auto size: {Texture::Size(20, 14), Texture::Size(45, 31), Texture::Size(32, 10)}) {
+        const auto expected = texture.resized(size, filter);
+        TexturePipeline pipeline(texture);
+        pipeline.setScratchBytes(scratchBytes);
+        const auto result = pipeline.resize(size, filter).execute();
+
+        QVERIFY(sameLayout(result, expected));
+        QVERIFY(maxError(result, expected) <= 1.0f / 255);
+    }
+}
+
+void TestTexturePipeline::resizeSrgb()
+{
+    const auto texture = makeTexture(TextureFormat::RGBA8_Srgb, {16, 16});
+    const auto expected = texture.resized({10, 6}, Texture::Filter::Lanczos);
+    const auto result = TexturePipeline(texture)
+            .resize({10, 6}, Texture::Filter::Lanczos)
+            .execute();
+
+    QVERIFY(sameLayout(result, expected));
+    QVERIFY(maxError(result, expected) <= 1.0f / 255);
+}
+
+void TestTexturePipeline::generateMipmaps_data()
+{
+    QTest::addColumn<TextureFormat>("format");
+    QTest::addColumn<Texture::Filter>("filter");
+    QTest::addColumn<Texture::MipmapOptions>("options");
+
+    QTest::newRow("RGBA8_Unorm, Box")
+            << TextureFormat::RGBA8_Unorm << Texture::Filter::Box
+            << Texture::MipmapOptions();
+    QTest::newRow("RGBA8_Unorm, Box, wrap")
+            << TextureFormat::RGBA8_Unorm << Texture::Filter::Box
+            << Texture::MipmapOptions(Texture::MipmapOption::WrapEdges);
+    QTest::newRow("RGBA8_Srgb, Box")
+            << TextureFormat::RGBA8_Srgb << Texture::Filter::Box
+            << Texture::MipmapOptions();
+    QTest::newRow("RGBA32_Float, Lanczos")
+            << TextureFormat::RGBA32_Float << Texture::Filter::Lanczos
+            << Texture::MipmapOptions();
+}
+
+void TestTexturePipeline::generateMipmaps()
+{
+    QFETCH(TextureFormat, format);
+    QFETCH(Texture::Filter, filter);
+    QFETCH(Texture::MipmapOptions, options);
+
+    const auto texture = makeTexture(format, {32, 16}, {Texture::IsCubemap::No, 1, 2});
+    const auto expected = texture.generateMipmaps(filter, options);
+    const auto result = TexturePipeline(texture).generateMipmaps(filter, options).execute();
+
+    QVERIFY(sameLayout(result, expected));
+    QCOMPARE(result.levels(), 6);
+    // levels are filtered from the previous quantized level, so rounding errors may accumulate
+    const auto tolerance = format == TextureFormat::RGBA32_Float ? 1e-5f : 3.0f / 255;
+    QVERIFY(maxError(result, expected) <= tolerance);
+}
+
+void TestTexturePipeline::alphaCoverage()
+{
+    Texture texture(TextureFormat::RGBA8_Unorm, {32, 32});
+    for (int y = 0; y < 32; ++y) {
+        for (int x = 0; x < 32; ++x)
+            texture.setTexelColor({x, y}, qRgba(255, 255, 255, (x + y) % 3 == 0 ? 255 : 100));
+    }
+
+    const auto options = Texture::MipmapOptions(Texture::MipmapOption::PreserveAlphaCoverage);
+    const auto expected = texture.generateMipmaps(Texture::Filter::Box, options);
+    const auto result = TexturePipeline(texture)
+            .generateMipmaps(Texture::Filter::Box, options)
+            .execute();
+
+    QVERIFY(sameLayout(result, expected));
+    QVERIFY(maxError(result, expected) <= 3.0f / 255);
+}
+
+void TestTexturePipeline::fused()
+{
+    const auto texture = makeTexture(TextureFormat::RGBA8_Unorm, {48, 40});
+
+    const auto expected = texture.premultiplied()
+            .resized({24, 16}, Texture::Filter::Kaiser)
+            .generateMipmaps(Texture::Filter::Box)
+            .convert(TextureFormat::RGBA16_Unorm);
+    TexturePipeline pipeline(texture);
+    pipeline.setScratchBytes(4096);
+    const auto result = pipeline
+            .premultiply()
+            .resize({24, 16}, Texture::Filter::Kaiser)
+            .generateMipmaps(Texture::Filter::Box)
+            .convert(TextureFormat::RGBA16_Unorm)
+            .execute();
+
+    QVERIFY(sameLayout(result, expected));
+    // the pipeline does not quantize the premultiplied and resized images to 8 bits
+    QVERIFY(maxError(result, expected) <= 2.0f / 255);
+}
+
+void TestTexturePipeline::operationOrder()
+{
+    const auto texture = makeTexture(TextureFormat::RGBA8_Unorm, {16, 16});
+    const Texture::Swizzle swizzle = {Texture::SwizzleValue::Alpha, Texture::SwizzleValue::Blue,
+                                      Texture::SwizzleValue::Green, Texture::SwizzleValue::One};
+
+    // operations recorded after generateMipmaps() are applied to every level
+    const auto expected = texture.generateMipmaps().swizzled(swizzle).premultiplied();
+    const auto result = TexturePipeline(texture)
+            .generateMipmaps()
+            .swizzle(swizzle)
+            .premultiply()
+            .execute();
+    QVERIFY(sameLayout(result, expected));
+    QVERIFY(maxError(result, expected) <= 3.0f / 255);
+
+    // operations recorded before resize() are applied to the source
+    const auto expectedResized = texture.swizzled(swizzle).resized({8, 8});
+    const auto resized = TexturePipeline(texture).swizzle(swizzle).resize({8, 8}).execute();
+    QVERIFY(sameLayout(resized, expectedResized));
+    QVERIFY(maxError(resized, expectedResized) <= 1.0f / 255);
+}
+
+void TestTexturePipeline::subresources()
+{
+    // without resizing, every level, face and layer is processed
+    const auto texture = makeTexture(
+            TextureFormat::RGBA16_Unorm, {8, 8}, {Texture::IsCubemap::Yes, 3, 2});
+    const auto expected = texture.swizzled({Texture::SwizzleValue::Blue,
+                                            Texture::SwizzleValue::Green,
+                                            Texture::SwizzleValue::Red,
+                                            Texture::SwizzleValue::Alpha})
+            .convert(TextureFormat::RGBA8_Unorm);
+    const auto result = TexturePipeline(texture)
+            .swizzle({Texture::SwizzleValue::Blue,
+                      Texture::SwizzleValue::Green,
+                      Texture::SwizzleValue::Red,
+                      Texture::SwizzleValue::Alpha})
+            .convert(TextureFormat::RGBA8_Unorm)
+            .execute();
+
+    QVERIFY(sameLayout(result, expected));
+    QVERIFY(maxError(result, expected) <= 0.5f / 255);
+}
+
+void TestTexturePipeline::invalid()
+{
+    const auto texture = makeTexture(TextureFormat::RGBA8_Unorm, {8, 8});
+
+    // compressed source
+    Texture compressed(TextureFormat::Bc1Rgb_Unorm, {8, 8});
+    QVERIFY(!compressed.isNull());
+    QVERIFY(TexturePipeline(compressed).convert(TextureFormat::RGBA8_Unorm).execute().isNull());
+
+    // volume texture
+    Texture volume(TextureFormat::RGBA8_Unorm, {4, 4, 4});
+    QVERIFY(!volume.isNull());
+    QVERIFY(TexturePipeline(volume).execute().isNull());
+
+    // compressed output
+    QVERIFY(TexturePipeline(texture).convert(TextureFormat::Bc1Rgb_Unorm).execute().isNull());
+
+    // resize after generating mipmaps
+    QVERIFY(TexturePipeline(texture).generateMipmaps().resize({4, 4}).execute().isNull());
+    QVERIFY(TexturePipeline(texture).resize({4, 4}).resize({2, 2}).execute().isNull());
+    QVERIFY(TexturePipeline(texture).generateMipmaps().generateMipmaps().execute().isNull());
+
+    // invalid size
+    QVERIFY(TexturePipeline(texture).resize({0, 4}).execute().isNull());
+}
+
+QTEST_APPLESS_MAIN(TestTexturePipeline)
+
+#include "test_texturepipeline.moc"
@@ -0,0 +1,179 @@
+#include <QtTest>
+#include <TextureLib/Texture>
+#include <TextureLib/TextureSampler>
+
+class TestTextureSampler : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void defaultConstructed();
+    void unsupportedFormat();
+    void point();
+    void bilinear();
+    void addressMode();
+    void trilinear();
+    void genericReader();
+    void batch();
+    void cube();
+    void cubeSeamless();
+};
+
+static bool fuzzyCompare(const Rgba128Float &lhs, const Rgba128Float &rhs)
+{
+    constexpr auto epsilon = 1e-5f;
+    return std::abs(lhs.red() - rhs.red()) < epsilon
+            && std::abs(lhs.green() - rhs.green()) < epsilon
+            && std::abs(lhs.blue() - rhs.blue()) < epsilon
+            && std::abs(lhs.alpha() - rhs.alpha()) < epsilon;
+}
+
+static Texture makeGradient(Texture::size_type width, Texture::size_type height)
+{
+    Texture result(TextureFormat::RGBA32_Float, {width, height});
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x)
+            result.setTexelColor({x, y}, rgba128Float(float(x), float(y), 0.0f, 1.0f));
+    }
+    return result;
+}
+
+void TestTextureSampler::defaultConstructed()
+{
+    TextureSampler sampler;
+    QVERIFY(sampler.isNull());
+    QVERIFY(sampler.texture().isNull());
+    QCOMPARE(sampler.filter(), TextureSampler::Filter::Bilinear);
+    QCOMPARE(sampler.addressMode(), TextureSampler::AddressMode::Wrap);
+    QVERIFY(fuzzyCompare(sampler.sample(0.5f, 0.5f), Rgba128Float()));
+}
+
+void TestTextureSampler::unsupportedFormat()
+{
+    Texture texture(TextureFormat::Bc1Rgb_Unorm, {16, 16});
+    QVERIFY(!texture.isNull());
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Sampling is not supported for format .*"));
+    QVERIFY(TextureSampler(texture).isNull());
+
+    Texture rgba(TextureFormat::RGBA8_Unorm, {4, 4});
+    QTest::ignoreMessage(QtWarningMsg, "layer 1 is out of bounds");
+    QVERIFY(TextureSampler(rgba, TextureSampler::Filter::Point, TextureSampler::AddressMode::Wrap, 1).isNull());
+}
+
+void TestTextureSampler::point()
+{
+    const auto texture = makeGradient(4, 4);
+    TextureSampler sampler(texture, TextureSampler::Filter::Point);
+    QVERIFY(!sampler.isNull());
+
+    QVERIFY(fuzzyCompare(sampler.sample(0.0f, 0.0f), rgba128Float(0, 0, 0)));
+    QVERIFY(fuzzyCompare(sampler.sample(0.3f, 0.6f), rgba128Float(1, 2, 0)));
+    QVERIFY(fuzzyCompare(sampler.sample(0.99f, 0.99f), rgba128Float(3, 3, 0)));
+}
+
+void TestTextureSampler::bilinear()
+{
+    const auto texture = makeGradient(4, 4);
+    TextureSampler sampler(texture, TextureSampler::Filter::Bilinear, TextureSampler::AddressMode::Clamp);
+
+    // texel centers
+    QVERIFY(fuzzyCompare(sampler.sample(0.125f, 0.125f), rgba128Float(0, 0, 0)));
+    QVERIFY(fuzzyCompare(sampler.sample(0.375f, 0.625f), rgba128Float(1, 2, 0)));
+    // between texel centers
+    QVERIFY(fuzzyCompare(sampler.sample(0.25f, 0.5f), rgba128Float(0.5f, 1.5f, 0)));
+    QVERIFY(fuzzyCompare(sampler.sample(0.3125f, 0.125f), rgba128Float(0.75f, 0, 0)));
+}
+
+void TestTextureSampler::addressMode()
+{
+    const auto texture = makeGradient(4, 4);
+    TextureSampler sampler(texture, TextureSampler::Filter::Bilinear, TextureSampler::AddressMode::Clamp);
+    QVERIFY(fuzzyCompare(sampler.sample(0.0f, 0.125f), rgba128Float(0, 0, 0)));
+    QVERIFY(fuzzyCompare(sampler.sample(1.5f, 0.125f), rgba128Float(3, 0, 0)));
+
+    sampler.setAddressMode(TextureSampler::AddressMode::Wrap);
+    // halfway between the last and the first texels
+    QVERIFY(fuzzyCompare(sampler.sample(0.0f, 0.125f), rgba128Float(1.5f, 0, 0)));
+    QVERIFY(fuzzyCompare(sampler.sample(1.375f, -0.875f), rgba128Float(1, 0, 0)));
+}
+
+void TestTextureSampler::trilinear()
+{
+    Texture texture(TextureFormat::RGBA8_Unorm, {4, 4}, {3});
+    QVERIFY(!texture.isNull());
+    texture.fill({{}, {4, 4}}, {0}, qRgba(0, 0, 0, 255));
+    texture.fill({{}, {2, 2}}, {1}, qRgba(255, 0, 0, 255));
+    texture.fill({{}, {1, 1}}, {2}, qRgba(255, 255, 0, 255));
+
+    TextureSampler sampler(texture, TextureSampler::Filter::Trilinear);
+    QVERIFY(fuzzyCompare(sampler.sample(0.5f, 0.5f, 0.0f), rgba128Float(0, 0, 0)));
+    QVERIFY(fuzzyCompare(sampler.sample(0.5f, 0.5f, 0.5f), rgba128Float(0.5f, 0, 0)));
+    QVERIFY(fuzzyCompare(sampler.sample(0.5f, 0.5f, 1.25f), rgba128Float(1, 0.25f, 0)));
+    QVERIFY(fuzzyCompare(sampler.sample(0.5f, 0.5f, 10.0f), rgba128Float(1, 1, 0)));
+
+    sampler.setFilter(TextureSampler::Filter::Point);
+    QVERIFY(fuzzyCompare(sampler.sample(0.5f, 0.5f, 0.4f), rgba128Float(0, 0, 0)));
+    QVERIFY(fuzzyCompare(sampler.sample(0.5f, 0.5f, 0.6f), rgba128Float(1, 0, 0)));
+}
+
+void TestTextureSampler::genericReader()
+{
+    Texture texture(TextureFormat::RGBA16_Unorm, {2, 1});
+    QVERIFY(!texture.isNull());
+    texture.setTexelColor({0, 0}, qRgba64(0, 0, 0, 65535));
+    texture.setTexelColor({1, 0}, qRgba64(65535, 0, 65535, 65535));
+
+    TextureSampler sampler(texture, TextureSampler::Filter::Bilinear, TextureSampler::AddressMode::Clamp);
+    QVERIFY(fuzzyCompare(sampler.sample(0.5f, 0.5f), rgba128Float(0.5f, 0, 0.5f)));
+}
+
+void TestTextureSampler::batch()
+{
+    const auto texture = makeGradient(4, 4);
+    TextureSampler sampler(texture);
+
+    const std::vector<TextureSampler::TexCoord> coords = {
+        {0.125f, 0.125f}, {0.375f, 0.625f}, {0.875f, 0.375f}
+    };
+    const auto result = sampler.sample(coords);
+    QCOMPARE(result.size(), coords.size());
+    for (size_t i = 0; i < coords.size(); ++i)
+        QVERIFY(fuzzyCompare(result[i], sampler.sample(coords[i])));
+}
+
+void TestTextureSampler::cube()
+{
+    Texture texture(TextureFormat::RGBA8_Unorm, {4, 4}, {Texture::IsCubemap::Yes});
+    QVERIFY(!texture.isNull());
+    for (int face = 0; face < 6; ++face)
+        texture.fill({{}, {4, 4}}, {Texture::Side(face)}, qRgba(face * 10, 0, 0, 255));
+
+    TextureSampler sampler(texture, TextureSampler::Filter::Point);
+    QVERIFY(fuzzyCompare(sampler.sampleCube(1, 0.1f, 0.2f), rgba128Float(0.0f, 0, 0)));
+    QVERIFY(fuzzyCompare(sampler.sampleCube(-1, 0.1f, 0.2f), rgba128Float(10 / 255.0f, 0, 0)));
+    QVERIFY(fuzzyCompare(sampler.sampleCube(0.1f, 1, 0.2f), rgba128Float(20 / 255.0f, 0, 0)));
+    QVERIFY(fuzzyCompare(sampler.sampleCube(0.1f, -1, 0.2f), rgba128Float(30 / 255.0f, 0, 0)));
+    QVERIFY(fuzzyCompare(sampler.sampleCube(0.1f, 0.2f, 1), rgba128Float(40 / 255.0f, 0, 0)));
+    QVERIFY(fuzzyCompare(sampler.sampleCube(0.1f, 0.2f, -1), rgba128Float(50 / 255.0f, 0, 0)));
+
+    QTest::ignoreMessage(QtWarningMsg, "sampleCube() requires a cubemap texture");
+    TextureSampler flat(makeGradient(4, 4));
+    QVERIFY(fuzzyCompare(flat.sampleCube(1, 0, 0), Rgba128Float()));
+}
+
+void TestTextureSampler::cubeSeamless()
+{
+    Texture texture(TextureFormat::RGBA8_Unorm, {4, 4}, {Texture::IsCubemap::Yes});
+    QVERIFY(!texture.isNull());
+    texture.fill({{}, {4, 4}}, {Texture::Side::PositiveX}, qRgba(255, 0, 0, 255));
+    texture.fill({{}, {4, 4}}, {Texture::Side::PositiveZ}, qRgba(0, 0, 255, 255));
+
+    TextureSampler sampler(texture, TextureSampler::Filter::Bilinear);
+    // direction exactly at the edge between +X and +Z faces is blended from both faces
+    const auto color = sampler.sampleCube(1, 0, 1);
+    QVERIFY(fuzzyCompare(color, rgba128Float(0.5f, 0, 0.5f)));
+}
+
+QTEST_APPLESS_MAIN(TestTextureSampler)
+
+#include "test_texturesampler.moc"
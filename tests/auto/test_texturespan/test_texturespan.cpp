@@ -0,0 +1,164 @@
+#include <QtTest>
+#include <TextureLib/Texture>
+#include <TextureLib/TextureSpan>
+
+class TestTextureSpan : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void defaultConstructed();
+    void imageSpan_data();
+    void imageSpan();
+    void lines();
+    void subSpan();
+    void subSpanCompressed();
+    void constConversion();
+};
+
+void TestTextureSpan::defaultConstructed()
+{
+    TextureSpan span;
+    QVERIFY(span.isNull());
+    QCOMPARE(span.data(), nullptr);
+    QCOMPARE(span.format(), TextureFormat::Invalid);
+    QCOMPARE(span.width(), 0);
+    QCOMPARE(span.height(), 0);
+    QCOMPARE(span.depth(), 0);
+    QCOMPARE(span.bytes(), 0);
+    QVERIFY(span.begin() == span.end());
+    QVERIFY(span.line(0).empty());
+}
+
+void TestTextureSpan::imageSpan_data()
+{
+    QTest::addColumn<TextureFormat>("format");
+    QTest::addColumn<int>("width");
+    QTest::addColumn<int>("height");
+    QTest::addColumn<int>("depth");
+    QTest::addColumn<int>("align");
+    QTest::addColumn<qsizetype>("lineSize");
+    QTest::addColumn<qsizetype>("lineCount");
+
+    QTest::newRow("RGBA_8888, 5x3x1, byte")
+            << TextureFormat::RGBA8_Unorm << 5 << 3 << 1 << int(Texture::Alignment::Byte)
+            << qsizetype(20) << qsizetype(3);
+    QTest::newRow("RGB_888, 5x3x1, word")
+            << TextureFormat::RGB8_Unorm << 5 << 3 << 1 << int(Texture::Alignment::Word)
+            << qsizetype(15) << qsizetype(3);
+    QTest::newRow("L8, 5x3x2, word")
+            << TextureFormat::L8_Unorm << 5 << 3 << 2 << int(Texture::Alignment::Word)
+            << qsizetype(5) << qsizetype(3);
+    QTest::newRow("DXT1, 5x5x1, byte")
+            << TextureFormat::Bc1Rgb_Unorm << 5 << 5 << 1 << int(Texture::Alignment::Byte)
+            << qsizetype(16) << qsizetype(2);
+}
+
+void TestTextureSpan::imageSpan()
+{
+    QFETCH(TextureFormat, format);
+    QFETCH(int, width);
+    QFETCH(int, height);
+    QFETCH(int, depth);
+    QFETCH(int, align);
+    QFETCH(qsizetype, lineSize);
+    QFETCH(qsizetype, lineCount);
+
+    Texture texture(format, {width, height, depth}, {1, 1}, Texture::Alignment(align));
+    QVERIFY(!texture.isNull());
+
+    const auto span = texture.constImageSpan({});
+    QVERIFY(!span.isNull());
+    QCOMPARE(span.data(), texture.constImageData({}).data());
+    QCOMPARE(span.format(), format);
+    QCOMPARE(span.width(), width);
+    QCOMPARE(span.height(), height);
+    QCOMPARE(span.depth(), depth);
+    QCOMPARE(span.bytesPerLine(), texture.bytesPerLine());
+    QCOMPARE(span.bytesPerSlice(), texture.bytesPerSlice());
+    QCOMPARE(span.lineSize(), lineSize);
+    QCOMPARE(span.lineCount(), lineCount);
+    QVERIFY(span.bytes() <= texture.bytesPerImage());
+}
+
+void TestTextureSpan::lines()
+{
+    Texture texture(TextureFormat::RGB8_Unorm, {5, 3, 2}, {1, 1}, Texture::Alignment::Word);
+    QVERIFY(!texture.isNull());
+
+    const auto span = texture.imageSpan({});
+    qsizetype count = 0;
+    for (auto it = span.begin(); it != span.end(); ++it, ++count) {
+        const auto line = *it;
+        QCOMPARE(line.size(), qsizetype(15));
+        QCOMPARE(line.data(),
+                 span.data() + span.bytesPerSlice() * it.z() + span.bytesPerLine() * it.y());
+        std::fill(line.begin(), line.end(), uchar(count));
+    }
+    QCOMPARE(count, qsizetype(6));
+
+    QCOMPARE(qRed(texture.texelColor({4, 2, 1}, {}).convert<QRgb>()), 5);
+    QCOMPARE(qRed(texture.texelColor({0, 1, 0}, {}).convert<QRgb>()), 1);
+}
+
+void TestTextureSpan::subSpan()
+{
+    Texture texture(TextureFormat::RGBA8_Unorm, {8, 8});
+    QVERIFY(!texture.isNull());
+
+    const auto span = texture.imageSpan({});
+    const auto region = span.subSpan(2, 3, 0, 4, 2);
+    QVERIFY(!region.isNull());
+    QCOMPARE(region.width(), 4);
+    QCOMPARE(region.height(), 2);
+    QCOMPARE(region.depth(), 1);
+    QCOMPARE(region.bytesPerLine(), span.bytesPerLine());
+    QCOMPARE(region.lineSize(), qsizetype(16));
+    QCOMPARE(region.data(), span.data() + 3 * 32 + 2 * 4);
+    QCOMPARE(region.texel(0, 0).data(), span.texel(2, 3).data());
+    QCOMPARE(region.texel(3, 1).data(), span.texel(5, 4).data());
+    QVERIFY(region.texel(4, 0).empty());
+
+    QVERIFY(span.subSpan(6, 0, 0, 4, 1).isNull());
+    QVERIFY(span.subSpan(-1, 0, 0, 1, 1).isNull());
+    QVERIFY(span.subSpan(0, 0, 1, 1, 1).isNull());
+    QVERIFY(span.subSpan(0, 0, 0, 0, 1).isNull());
+}
+
+void TestTextureSpan::subSpanCompressed()
+{
+    Texture texture(TextureFormat::Bc1Rgb_Unorm, {16, 16});
+    QVERIFY(!texture.isNull());
+
+    const auto span = texture.imageSpan({});
+    QCOMPARE(span.lineCount(), qsizetype(4));
+    QVERIFY(span.texel(0, 0).empty());
+
+    const auto region = span.subSpan(4, 8, 0, 8, 8);
+    QVERIFY(!region.isNull());
+    QCOMPARE(region.lineCount(), qsizetype(2));
+    QCOMPARE(region.lineSize(), qsizetype(16));
+    QCOMPARE(region.data(), span.data() + 2 * span.bytesPerLine() + 8);
+
+    QVERIFY(span.subSpan(2, 0, 0, 4, 4).isNull());
+    QVERIFY(span.subSpan(0, 0, 0, 3, 4).isNull());
+    QVERIFY(!span.subSpan(12, 12, 0, 4, 4).isNull());
+}
+
+void TestTextureSpan::constConversion()
+{
+    Texture texture(TextureFormat::RGBA8_Unorm, {4, 4});
+    QVERIFY(!texture.isNull());
+
+    const TextureSpan span = texture.imageSpan({});
+    const ConstTextureSpan constSpan = span;
+    QCOMPARE(constSpan.data(), span.data());
+    QCOMPARE(constSpan.width(), span.width());
+    QCOMPARE(constSpan.height(), span.height());
+    QCOMPARE(constSpan.bytesPerLine(), span.bytesPerLine());
+    QCOMPARE(constSpan.bytes(), span.bytes());
+}
+
+QTEST_MAIN(TestTextureSpan)
+
+#include "test_texturespan.moc"
@@ -0,0 +1,197 @@
+#include <QtTest>
+#include <TextureLib/Texture>
+#include <TextureLib/TextureStatistics>
+
+#include <limits>
+#include <numeric>
+
+class TestTextureStatistics : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void defaultConstructed();
+    void channels_data();
+    void channels();
+    void histogram();
+    void alphaUsage_data();
+    void alphaUsage();
+    void nonFinite();
+    void subresource();
+    void parallel();
+    void unsupported();
+};
+
+void TestTextureStatistics::defaultConstructed()
+{
+    TextureStatistics statistics;
+    QVERIFY(statistics.isNull());
+    QCOMPARE(statistics.texelCount(), 0);
+    QVERIFY(TextureStatistics(Texture()).isNull());
+}
+
+void TestTextureStatistics::channels_data()
+{
+    QTest::addColumn<TextureFormat>("format");
+
+    // 8-bit formats use the native path, others are decoded
+    QTest::newRow("RGBA8_Unorm") << TextureFormat::RGBA8_Unorm;
+    QTest::newRow("BGRA8_Unorm") << TextureFormat::BGRA8_Unorm;
+    QTest::newRow("RGBA16_Unorm") << TextureFormat::RGBA16_Unorm;
+    QTest::newRow("RGBA32_Float") << TextureFormat::RGBA32_Float;
+}
+
+void TestTextureStatistics::channels()
+{
+    QFETCH(TextureFormat, format);
+
+    Texture texture(format, {2, 2});
+    QVERIFY(!texture.isNull());
+    texture.setTexelColor({0, 0}, qRgba(0, 255, 51, 255));
+    texture.setTexelColor({1, 0}, qRgba(255, 255, 51, 255));
+    texture.setTexelColor({0, 1}, qRgba(0, 255, 51, 255));
+    texture.setTexelColor({1, 1}, qRgba(255, 255, 51, 255));
+
+    const TextureStatistics statistics(texture);
+    QVERIFY(!statistics.isNull());
+    QCOMPARE(statistics.texelCount(), 4);
+    QCOMPARE(statistics.nanCount(), 0);
+    QCOMPARE(statistics.infCount(), 0);
+
+    QCOMPARE(statistics.red().min, 0.0f);
+    QCOMPARE(statistics.red().max, 1.0f);
+    QVERIFY(qAbs(statistics.red().mean - 0.5) < 1e-6);
+    QVERIFY(qAbs(statistics.red().stdDev - 0.5) < 1e-6);
+
+    QCOMPARE(statistics.green().min, 1.0f);
+    QVERIFY(qAbs(statistics.green().stdDev) < 1e-6);
+    QVERIFY(qAbs(statistics.blue().mean - 0.2) < 1e-6);
+    QCOMPARE(statistics.alphaUsage(), TextureStatistics::AlphaUsage::Opaque);
+}
+
+void TestTextureStatistics::histogram()
+{
+    Texture texture(TextureFormat::RGB8_Unorm, {4, 1});
+    QVERIFY(!texture.isNull());
+    texture.setTexelColor({0, 0}, qRgb(0, 0, 0));
+    texture.setTexelColor({1, 0}, qRgb(10, 0, 0));
+    texture.setTexelColor({2, 0}, qRgb(10, 0, 0));
+    texture.setTexelColor({3, 0}, qRgb(255, 0, 0));
+
+    const TextureStatistics statistics(texture);
+    const auto &red = statistics.red().histogram;
+    QCOMPARE(red[0], quint64(1));
+    QCOMPARE(red[10], quint64(2));
+    QCOMPARE(red[255], quint64(1));
+    QCOMPARE(std::accumulate(red.begin(), red.end(), quint64(0)), quint64(4));
+
+    // the format has no alpha, so it reads as opaque
+    QCOMPARE(statistics.alpha().histogram[255], quint64(4));
+    QCOMPARE(statistics.alphaUsage(), TextureStatistics::AlphaUsage::Opaque);
+
+    // the same values decoded by the generic path fall to the same bins
+    const TextureStatistics converted(texture.convert(TextureFormat::RGBA16_Unorm));
+    QVERIFY(converted.red().histogram == red);
+}
+
+void TestTextureStatistics::alphaUsage_data()
+{
+    QTest::addColumn<TextureFormat>("format");
+    QTest::addColumn<int>("alpha");
+    QTest::addColumn<TextureStatistics::AlphaUsage>("usage");
+
+    for (const auto format: {TextureFormat::RGBA8_Unorm, TextureFormat::RGBA16_Float}) {
+        const auto name = toQString(format).toLatin1();
+        QTest::newRow((name + " opaque").data())
+                << format << 255 << TextureStatistics::AlphaUsage::Opaque;
+        QTest::newRow((name + " binary").data())
+                << format << 0 << TextureStatistics::AlphaUsage::Binary;
+        QTest::newRow((name + " full").data())
+                << format << 128 << TextureStatistics::AlphaUsage::Full;
+    }
+}
+
+void TestTextureStatistics::alphaUsage()
+{
+    QFETCH(TextureFormat, format);
+    QFETCH(int, alpha);
+    QFETCH(TextureStatistics::AlphaUsage, usage);
+
+    Texture texture(format, {4, 4});
+    QVERIFY(!texture.isNull());
+    texture.fill(qRgba(10, 20, 30, 255));
+    texture.setTexelColor({1, 2}, qRgba(10, 20, 30, alpha));
+
+    QCOMPARE(TextureStatistics(texture).alphaUsage(), usage);
+}
+
+void TestTextureStatistics::nonFinite()
+{
+    Texture texture(TextureFormat::RGBA32_Float, {3, 1});
+    QVERIFY(!texture.isNull());
+    const auto nan = std::numeric_limits<float>::quiet_NaN();
+    const auto inf = std::numeric_limits<float>::infinity();
+    texture.setTexelColor({0, 0}, rgba128Float(nan, 0.0f, 0.0f, 1.0f));
+    texture.setTexelColor({1, 0}, rgba128Float(inf, -inf, 0.0f, 1.0f));
+    texture.setTexelColor({2, 0}, rgba128Float(4.0f, 2.0f, 0.0f, 1.0f));
+
+    const TextureStatistics statistics(texture);
+    QCOMPARE(statistics.nanCount(), 1);
+    QCOMPARE(statistics.infCount(), 2);
+    // non-finite values are excluded
+    QCOMPARE(statistics.red().min, 4.0f);
+    QCOMPARE(statistics.red().max, 4.0f);
+    QCOMPARE(statistics.green().min, 0.0f);
+    QCOMPARE(statistics.green().max, 2.0f);
+    // values above 1 are counted in the last bin
+    QCOMPARE(statistics.red().histogram[255], quint64(1));
+}
+
+void TestTextureStatistics::subresource()
+{
+    Texture texture(TextureFormat::R8_Unorm, {4, 4}, {Texture::IsCubemap::Yes, 2, 1});
+    QVERIFY(!texture.isNull());
+    texture.clear();
+    texture.fill({{}, {2, 2}}, {Texture::Side::NegativeZ, 1}, qRgba(255, 0, 0, 255));
+
+    const TextureStatistics statistics(texture, {Texture::Side::NegativeZ, 1});
+    QCOMPARE(statistics.texelCount(), 4);
+    QCOMPARE(statistics.red().min, 1.0f);
+    QCOMPARE(TextureStatistics(texture, {Texture::Side::PositiveZ, 1}).red().max, 0.0f);
+}
+
+void TestTextureStatistics::parallel()
+{
+    // big enough to be split into several bands
+    Texture texture(TextureFormat::RGBA8_Unorm, {512, 512}, {1, 1}, Texture::Alignment::Word);
+    QVERIFY(!texture.isNull());
+    for (int y = 0; y < 512; ++y) {
+        const auto value = y % 2 ? 255 : 0;
+        texture.fill({{0, y}, {512, 1}}, {}, qRgba(value, 0, 0, value));
+    }
+
+    const TextureStatistics statistics(texture);
+    QCOMPARE(statistics.texelCount(), 512 * 512);
+    QCOMPARE(statistics.red().histogram[0], quint64(256 * 512));
+    QCOMPARE(statistics.red().histogram[255], quint64(256 * 512));
+    QVERIFY(qAbs(statistics.red().mean - 0.5) < 1e-9);
+    QCOMPARE(statistics.alphaUsage(), TextureStatistics::AlphaUsage::Binary);
+
+    const TextureStatistics decoded(texture.convert(TextureFormat::RGBA32_Float));
+    QVERIFY(qAbs(decoded.red().mean - statistics.red().mean) < 1e-9);
+    QVERIFY(qAbs(decoded.red().stdDev - statistics.red().stdDev) < 1e-9);
+}
+
+void TestTextureStatistics::unsupported()
+{
+    Texture compressed(TextureFormat::Bc1Rgb_Unorm, {4, 4});
+    QVERIFY(!compressed.isNull());
+    QTest::ignoreMessage(
+            QtWarningMsg,
+            QRegularExpression("Statistics are not supported for compressed format .*"));
+    QVERIFY(TextureStatistics(compressed).isNull());
+}
+
+QTEST_APPLESS_MAIN(TestTextureStatistics)
+
+#include "test_texturestatistics.moc"
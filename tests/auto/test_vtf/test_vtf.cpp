@@ -11,6 +11,10 @@ class TestVTF: public QObject
 
 private slots:
     void initTestCase();
+    void readInfo_data();
+    void readInfo();
+    void readPartial_data();
+    void readPartial();
     void benchRead_data();
     void benchRead();
 };
@@ -23,6 +27,62 @@ void TestVTF::initTestCase()
     QLoggingCategory::setFilterRules(QStringLiteral("plugins.textureformats.vtfhandler.debug=false"));
 }
 
+void TestVTF::readInfo_data()
+{
+    benchRead_data();
+}
+
+void TestVTF::readInfo()
+{
+    QFETCH(QString, fileName);
+
+    TextureIO reader(fileName, QStringLiteral("image/x-vtf"));
+    const auto info = reader.readInfo();
+    QVERIFY2(info, qPrintable(toUserString(info.error())));
+    QVERIFY(!info->isNull());
+
+    // readInfo() doesn't move the device, so the texture can be read by the same reader
+    const auto result = reader.read();
+    QVERIFY2(result, qPrintable(toUserString(result.error())));
+    QVERIFY(*info == TextureInfo(*result));
+}
+
+void TestVTF::readPartial_data()
+{
+    benchRead_data();
+}
+
+void TestVTF::readPartial()
+{
+    QFETCH(QString, fileName);
+
+    const auto expected = TextureIO(fileName, QStringLiteral("image/x-vtf")).read();
+    QVERIFY2(expected, qPrintable(toUserString(expected.error())));
+
+    // only the smallest level of the last layer is read
+    const auto level = expected->levels() - 1;
+    const auto layer = expected->layers() - 1;
+    TextureReadOptions options;
+    options.setLevels(level, 1);
+    options.setLayers(layer);
+
+    const auto result = TextureIO(fileName, QStringLiteral("image/x-vtf")).read(options);
+    QVERIFY2(result, qPrintable(toUserString(result.error())));
+    QCOMPARE(result->format(), expected->format());
+    QCOMPARE(result->width(), expected->width(level));
+    QCOMPARE(result->height(), expected->height(level));
+    QCOMPARE(result->levels(), 1);
+    QCOMPARE(result->layers(), 1);
+    QCOMPARE(result->faces(), expected->faces());
+    for (int face = 0; face < result->faces(); ++face) {
+        const auto side = Texture::Side(face);
+        const auto data = result->imageData({side, 0, 0});
+        const auto expectedData = expected->imageData({side, level, layer});
+        QCOMPARE(data.size(), expectedData.size());
+        QVERIFY(std::equal(data.begin(), data.end(), expectedData.begin()));
+    }
+}
+
 void TestVTF::benchRead_data()
 {
     QTest::addColumn<QString>("fileName");